@@ -3,9 +3,12 @@
 #include <chrono>
 #include <utility>
 #include <algorithm>
+#include <array>
 #include <iterator>
 #include <limits>
 #include <filesystem>
+#include <sstream>
+#include <thread>
 
 #include "bag.h"
 #include "package.h"
@@ -15,9 +18,22 @@
 #include "solution_repair.h"
 #include "vnd.h"
 #include "vns.h"
+#include "vns_helper.h"
 #include "grasp.h"
 #include "grasp_vns.h"
 #include "file_processor.h"
+#include "logger.h"
+#include "progress_channel.h"
+#include "stepper.h"
+#include "checkpoint.h"
+#include "instance_delta.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include "tuning.h"
+
+// Local search limits of the focused VND after an instance edit (its candidate set is small).
+static constexpr int REOPTIMIZE_LS_ITERATIONS_WITHOUT_IMPROVEMENT = 2;
+static constexpr int REOPTIMIZE_LS_ITERATIONS = 500;
 
 namespace ALGORITHM {
 
@@ -35,6 +51,7 @@ std::string toString(ALGORITHM_TYPE algorithm)
         case ALGORITHM_TYPE::RANDOM_GREEDY_PACKAGE_BENEFIT: return "RANDOM_GREEDY_PACKAGE-BENEFIT";
         case ALGORITHM_TYPE::RANDOM_GREEDY_PACKAGE_BENEFIT_RATIO: return "RANDOM_GREEDY_PACKAGE-BENEFIT_RATIO";
         case ALGORITHM_TYPE::RANDOM_GREEDY_PACKAGE_SIZE: return "RANDOM_GREEDY_PACKAGE-SIZE";
+        case ALGORITHM_TYPE::GREEDY_PACKAGE_MARGINAL_RATIO: return "GREEDY_PACKAGE-MARGINAL_RATIO";
         case ALGORITHM_TYPE::VND: return "VND";
         case ALGORITHM_TYPE::VNS: return "VNS";
         case ALGORITHM_TYPE::GRASP: return "GRASP";
@@ -65,6 +82,76 @@ Algorithm::Algorithm(double maxTime, unsigned int seed)
 {
 }
 
+Algorithm::~Algorithm() = default;
+
+void Algorithm::setAutoCalibration(bool enabled)
+{
+    m_autoCalibrate = enabled;
+}
+
+const CALIBRATION::CalibrationResult& Algorithm::getCalibration() const
+{
+    return m_calibration;
+}
+
+void Algorithm::setThreadBudget(unsigned int maxThreads)
+{
+    m_threadBudget = maxThreads;
+}
+
+void Algorithm::setCheckpoint(const std::string& filename, bool resume)
+{
+    m_checkpointFile = filename;
+    m_resume = resume;
+}
+
+void Algorithm::setWarmStart(const std::string& path, const std::string& instanceFileName)
+{
+    m_warmStartPath = path;
+    m_warmStartInstance = instanceFileName;
+}
+
+void Algorithm::setTunedParameters(const std::string& filename)
+{
+    m_tunedParametersFile = filename;
+}
+
+void Algorithm::setHardwareCounters(bool enabled)
+{
+    m_hardwareCounters = enabled;
+}
+
+std::shared_ptr<const PERF_COUNTERS::Profile> Algorithm::getHardwareCounters() const
+{
+    return m_hardwareCountersProfile;
+}
+
+void Algorithm::setThreadPinning(bool enabled)
+{
+    m_threadPinning = enabled;
+}
+
+void Algorithm::setParallelVND(bool enabled)
+{
+    m_parallelVND = enabled;
+}
+
+void Algorithm::setPortfolio(bool enabled)
+{
+    m_portfolio = enabled;
+}
+
+void Algorithm::setResultCallback(RESULT_STREAM::Callback callback, bool incumbents)
+{
+    m_resultCallback = std::move(callback);
+    m_streamIncumbents = incumbents;
+}
+
+void Algorithm::setCancelToken(const std::atomic<bool>* cancelToken)
+{
+    m_cancelToken = cancelToken;
+}
+
 // =============================================================
 // == Main Control: Executes all strategies (construct + improve)
 // =============================================================
@@ -73,40 +160,149 @@ std::vector<std::unique_ptr<Bag>> Algorithm::run(const ProblemInstance& problemI
     m_timestamp = timestamp;
 
     precomputeDependencyGraph(problemInstance.packages, problemInstance.dependencies);
-    ConstructiveSolutions constructiveSolutions(m_maxTime, m_generator, m_dependencyGraph, m_timestamp);
+    const std::unique_ptr<Bag> warmStartBag = loadWarmStartBag(problemInstance);
+
+    m_hardwareCountersProfile.reset();
+    if (m_hardwareCounters && PERF_COUNTERS::isAvailable())
+        m_hardwareCountersProfile = std::make_shared<PERF_COUNTERS::Profile>();
+    PERF_COUNTERS::ScopedContext perfContext(m_hardwareCountersProfile.get(), ALGORITHM::ALGORITHM_TYPE::NONE);
+    TRACE::setThreadName("Algorithm::run");
 
     std::vector<std::unique_ptr<Bag>> resultBag;
-    resultBag.reserve(19);
+    resultBag.reserve(RESULT_BAG_COUNT);
 
     std::shared_ptr<Bag> bestInitialBag;
     int bestBenefit = std::numeric_limits<int>::min();
 
+    // Finished bags go to the result callback while later stages run.
+    std::unique_ptr<RESULT_STREAM::Dispatcher> results;
+    if (m_resultCallback) results = std::make_unique<RESULT_STREAM::Dispatcher>(m_resultCallback);
+
+    // Calibrated limits are not implied by the seed; reports record them.
+    std::string calibratedBudget;
+
     auto updateBestBag = [&](const std::unique_ptr<Bag>& bag) {
         if (!bag) return;
-        if (bag->getBenefit() > bestBenefit) {
+        if (!calibratedBudget.empty())
+            bag->setMetaheuristicParameters(bag->getMetaheuristicParameters() + " | Calibrated " + calibratedBudget);
+        PROGRESS::report(PROGRESS::EventKind::FINISHED, bag->getBagAlgorithm(), bag->getMovementType(),
+                         bag->getBenefit(), bag->getSize());
+        const bool incumbent = bag->getBenefit() > bestBenefit;
+        if (results) {
+            bag->setSeed(m_seed);
+            auto copy = std::make_shared<const Bag>(*bag);
+            results->publish({RESULT_STREAM::ResultKind::FINISHED, copy});
+            if (incumbent && m_streamIncumbents) results->publish({RESULT_STREAM::ResultKind::INCUMBENT, copy});
+        }
+        if (incumbent) {
             bestBenefit = bag->getBenefit();
             bestInitialBag = std::make_shared<Bag>(*bag);
         }
     };
 
-    // === Constructive Phase ===
-    resultBag.push_back(constructiveSolutions.randomBag(problemInstance.maxCapacity, problemInstance.packages));
+    // === Resume Phase ===
+    CHECKPOINT::RunProgress progress;
+    progress.seed = m_seed;
+    progress.portfolio = m_portfolio;
+    if (!m_checkpointFile.empty()) progress.instanceFingerprint = CHECKPOINT::fingerprint(problemInstance);
+    const bool resumed = m_resume && resumeFromCheckpoint(problemInstance.packages, progress, resultBag, bestInitialBag, bestBenefit);
 
-    for (auto& bag : constructiveSolutions.greedyBag(problemInstance.maxCapacity, problemInstance.packages))
-        resultBag.push_back(std::move(bag));
+    // Observers of a resumed run get the restored bags first, as if their stages had just finished.
+    if (resumed && results) {
+        for (const auto& bag : resultBag) {
+            bag->setSeed(m_seed);
+            results->publish({RESULT_STREAM::ResultKind::FINISHED, std::make_shared<const Bag>(*bag)});
+        }
+        if (bestInitialBag && m_streamIncumbents) {
+            bestInitialBag->setSeed(m_seed);
+            results->publish({RESULT_STREAM::ResultKind::INCUMBENT, std::make_shared<const Bag>(*bestInitialBag)});
+        }
+    }
 
-    for (auto& bag : constructiveSolutions.randomGreedy(problemInstance.maxCapacity, problemInstance.packages))
-        resultBag.push_back(std::move(bag));
+    // === Calibration Phase ===
+    CALIBRATION::SearchBudget budget = progress.budget;
+    if (m_autoCalibrate && !resumed) {
+        TRACE::ScopedEvent trace("stage", "Calibration");
+        m_calibration = CALIBRATION::calibrate(problemInstance.maxCapacity, problemInstance.packages,
+                                               m_dependencyGraph, m_maxTime, m_seed, m_threadBudget);
+        budget = m_calibration.budget;
+        progress.budget = budget;
+        LOG_INFO("[CALIBRATION] " << m_calibration.toString());
+    }
+    if (m_threadBudget > 0)
+        budget.threads = budget.threads == 0 ? m_threadBudget : std::min(budget.threads, m_threadBudget);
+    if (m_autoCalibrate) calibratedBudget = budget.toString();
 
-    for (auto& bag : resultBag){
-        updateBestBag(bag);
-        bag->setSeed(m_seed);
+    TUNING::Parameters parameters;
+    bool tuned = false;
+    if (!m_tunedParametersFile.empty()) {
+        try {
+            parameters = TUNING::loadParameters(m_tunedParametersFile);
+            tuned = true;
+            budget.lsIterationsWithoutImprovement = parameters.lsIterationsWithoutImprovement;
+            budget.lsMaxIterations = parameters.lsMaxIterations;
+            LOG_INFO("[TUNING] " << parameters.toString());
+        } catch (const std::exception& e) {
+            LOG_WARNING("[TUNING] Ignoring " << m_tunedParametersFile << ": " << e.what());
+        }
     }
+    const int rclSize = parameters.rclSize(problemInstance.packages.size());
+
+    // === Stages: each one is skipped when restored, and checkpointed when it completes ===
+    std::unique_ptr<CHECKPOINT::AsyncWriter> checkpointWriter;
+    if (!m_checkpointFile.empty()) checkpointWriter = std::make_unique<CHECKPOINT::AsyncWriter>(m_checkpointFile);
+    const int restoredStages = progress.completedStages;
+    int stage = 0;
+
+    auto runStage = [&](const char* name, SEARCH_ENGINE::MovementType movement, auto&& body) {
+        if (stage++ < restoredStages) return;
+        if (m_cancelToken && m_cancelToken->load(std::memory_order_relaxed)) return;
+        auto stageStart = std::chrono::steady_clock::now();
+        {
+            TRACE::ScopedEvent trace("stage", name, movement);
+            body();
+        }
+        // Worker threads flush on exit; this thread's lines would otherwise wait for a full buffer.
+        LOGGER::flush();
+        if (!checkpointWriter) return;
+
+        progress.completedStages = stage;
+        progress.elapsedSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - stageStart).count();
+        std::ostringstream generatorState;
+        generatorState << m_generator;
+        progress.generatorState = generatorState.str();
+        checkpointWriter->submit(CHECKPOINT::serialize(progress, bestInitialBag.get(), resultBag, problemInstance.packages));
+    };
+
+    // === Constructive Phase ===
+    runStage("Constructive", SEARCH_ENGINE::MovementType::NONE, [&]() {
+        ConstructiveSolutions constructiveSolutions(m_maxTime, m_generator, m_dependencyGraph, m_timestamp);
+        resultBag.push_back(constructiveSolutions.randomBag(problemInstance.maxCapacity, problemInstance.packages));
 
-    if (!bestInitialBag && !resultBag.empty())
-        bestInitialBag = std::make_shared<Bag>(*resultBag.front());
+        for (auto& bag : constructiveSolutions.greedyBag(problemInstance.maxCapacity, problemInstance.packages))
+            resultBag.push_back(std::move(bag));
 
-    std::vector<SEARCH_ENGINE::MovementType> moves = {
+        for (auto& bag : constructiveSolutions.randomGreedy(problemInstance.maxCapacity, problemInstance.packages))
+            resultBag.push_back(std::move(bag));
+
+        resultBag.push_back(constructiveSolutions.marginalGreedyBag(problemInstance.maxCapacity, problemInstance.packages));
+
+        for (auto& bag : resultBag){
+            updateBestBag(bag);
+            bag->setSeed(m_seed);
+        }
+
+        // A warm start only replaces the incumbent; it is not one of the result bags.
+        if (warmStartBag && warmStartBag->getBenefit() > bestBenefit) {
+            bestBenefit = warmStartBag->getBenefit();
+            bestInitialBag = std::make_shared<Bag>(*warmStartBag);
+        }
+
+        if (!bestInitialBag && !resultBag.empty())
+            bestInitialBag = std::make_shared<Bag>(*resultBag.front());
+    });
+
+    const std::array<SEARCH_ENGINE::MovementType, MOVEMENT_COUNT> moves = {
         SEARCH_ENGINE::MovementType::ADD,
         SEARCH_ENGINE::MovementType::SWAP_REMOVE_1_ADD_1,
         SEARCH_ENGINE::MovementType::SWAP_REMOVE_1_ADD_2,
@@ -114,57 +310,401 @@ std::vector<std::unique_ptr<Bag>> Algorithm::run(const ProblemInstance& problemI
         SEARCH_ENGINE::MovementType::EJECTION_CHAIN
     };
 
-    // === Improvement Phase (Sequential VND + VNS) ===
-    {
+    // === Improvement Phase (Sequential VND + VNS, or a portfolio racing them with GRASP) ===
+    const int maxGraspIterations = budget.graspIterations;
+    if (m_portfolio) runStage("Portfolio", SEARCH_ENGINE::MovementType::NONE, [&]() {
+        const auto deadline = std::chrono::steady_clock::now() +
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(m_maxTime));
+        const Bag startBag = bestInitialBag ? *bestInitialBag : Bag(ALGORITHM::ALGORITHM_TYPE::NONE, m_timestamp);
+        // One bag and search engine per stepper, declared first so they outlive the steppers.
+        std::vector<std::unique_ptr<Bag>> bags;
+        VND vnd(m_maxTime, m_generator());
+        vnd.setLocalSearchLimits(budget.lsIterationsWithoutImprovement, budget.lsMaxIterations);
+        SearchEngine vnsEngine(m_generator());
+        std::vector<std::unique_ptr<GRASP>> grasps;
+        STEPPER::Portfolio portfolio;
+        portfolio.setCancelToken(m_cancelToken);
+
+        bags.push_back(std::make_unique<Bag>(startBag));
+        portfolio.add("VND", vnd.steps(*bags.back(), problemInstance.maxCapacity, problemInstance.packages,
+                                       m_dependencyGraph, deadline));
+
+        bags.push_back(std::make_unique<Bag>(startBag));
+        bags.back()->setBagAlgorithm(ALGORITHM::ALGORITHM_TYPE::VNS);
+        bags.back()->setMetaheuristicParameters("k_max=" + std::to_string(moves.size()));
+        portfolio.add("VNS", VNS_HELPER::vnsSteps(*bags.back(), problemInstance.maxCapacity, problemInstance.packages,
+                                                  m_dependencyGraph, vnsEngine,
+                                                  std::max(1, budget.lsIterationsWithoutImprovement / 20),
+                                                  budget.lsMaxIterations, deadline));
+
+        for (auto move : moves) {
+            auto& grasp = grasps.emplace_back(std::make_unique<GRASP>(m_maxTime, m_generator(), rclSize, parameters.alpha));
+            grasp->setFillThreshold(parameters.fillThreshold);
+            if (m_autoCalibrate || tuned) grasp->setLocalSearchIterations(budget.lsMaxIterations);
+            bags.push_back(std::make_unique<Bag>(ALGORITHM::ALGORITHM_TYPE::GRASP, m_timestamp));
+            bags.back()->setMovementType(move);
+            portfolio.add("GRASP " + SEARCH_ENGINE::toString(move),
+                          grasp->steps(*bags.back(), problemInstance.maxCapacity, problemInstance.packages, move,
+                                       m_dependencyGraph, budget.lsIterationsWithoutImprovement,
+                                       maxGraspIterations, deadline));
+        }
+
+        unsigned int threads = budget.threads;
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        portfolio.run(threads, deadline);
+
+        const auto entries = portfolio.entries();
+        for (size_t i = 0; i < bags.size(); ++i) {
+            auto& bag = bags[i];
+            const std::string stepperParameters = bag->getMetaheuristicParameters();
+            bag->setMetaheuristicParameters((stepperParameters.empty() ? "" : stepperParameters + " | ") +
+                                            "Portfolio slices: " + std::to_string(entries[i].slices) +
+                                            " | Steps: " + std::to_string(entries[i].steps) +
+                                            " | Threads: " + std::to_string(threads));
+            bag->setAlgorithmTime(entries[i].seconds);
+            bag->setTimestamp(m_timestamp);
+            updateBestBag(bag);
+            resultBag.push_back(std::move(bag));
+        }
+    });
+
+    if (!m_portfolio) runStage("VND", SEARCH_ENGINE::MovementType::NONE, [&]() {
         VND vnd(m_maxTime, m_generator());
-        auto bagVND = vnd.run(problemInstance.maxCapacity, bestInitialBag.get(), problemInstance.packages, m_dependencyGraph);
+        vnd.setLocalSearchLimits(budget.lsIterationsWithoutImprovement, budget.lsMaxIterations);
+        std::unique_ptr<Bag> bagVND;
+        if (m_parallelVND) {
+            // Every constructive bag is a start; the result bags so far are exactly those.
+            std::vector<const Bag*> starts;
+            for (const auto& bag : resultBag) starts.push_back(bag.get());
+            const bool warmStartLeads = bestInitialBag &&
+                std::none_of(resultBag.begin(), resultBag.end(), [&](const std::unique_ptr<Bag>& bag) {
+                    return bag->getBenefit() >= bestInitialBag->getBenefit();
+                });
+            if (warmStartLeads) starts.push_back(bestInitialBag.get());
+            // Best first: with fewer threads than starts, the promising descents get the time.
+            std::stable_sort(starts.begin(), starts.end(), [](const Bag* a, const Bag* b) {
+                return a->getBenefit() > b->getBenefit();
+            });
+            vnd.setMaxThreads(m_threadBudget);
+            bagVND = vnd.runMultiStart(problemInstance.maxCapacity, starts, problemInstance.packages, m_dependencyGraph);
+        } else {
+            bagVND = vnd.run(problemInstance.maxCapacity, bestInitialBag.get(), problemInstance.packages, m_dependencyGraph);
+        }
         bagVND->setTimestamp(m_timestamp);
         updateBestBag(bagVND);
         resultBag.push_back(std::move(bagVND));
+    });
 
+    if (!m_portfolio) runStage("VNS", SEARCH_ENGINE::MovementType::NONE, [&]() {
         VNS vns(m_maxTime, m_generator());
+        // Shaken candidates only need a short descent: a twentieth of the VND patience.
+        vns.setIterationLimits(budget.vnsMaxIterations,
+                               std::max(1, budget.lsIterationsWithoutImprovement / 20),
+                               budget.lsMaxIterations);
+        vns.setMaxThreads(m_threadBudget);
         auto bagVNS = vns.run(problemInstance.maxCapacity, bestInitialBag.get(), problemInstance.packages, m_dependencyGraph);
         bagVNS->setTimestamp(m_timestamp);
         updateBestBag(bagVNS);
         resultBag.push_back(std::move(bagVNS));
-    }
+    });
 
     // === GRASP & GRASP_VNS Sequential (Single Loop) ===
-    int maxGraspIterations = 100;
-    using GraspType = std::unique_ptr<Bag>(*)(double, std::mt19937&, int, int);
     for (auto move : moves) {
-        // GRASP
-        {
-            GRASP grasp(m_maxTime, m_generator(), static_cast<int>(problemInstance.packages.size() / 3), -1);
-            auto bagGrasp = grasp.run(problemInstance.maxCapacity, problemInstance.packages, move, m_dependencyGraph, 200, maxGraspIterations);
+        // GRASP (raced in the portfolio instead when it is enabled)
+        if (!m_portfolio) runStage("GRASP", move, [&]() {
+            GRASP grasp(m_maxTime, m_generator(), rclSize, parameters.alpha);
+            grasp.setNumThreads(budget.threads);
+            grasp.setFillThreshold(parameters.fillThreshold);
+            grasp.setThreadPinning(m_threadPinning);
+            if (m_autoCalibrate || tuned) grasp.setLocalSearchIterations(budget.lsMaxIterations);
+            auto bagGrasp = grasp.run(problemInstance.maxCapacity, problemInstance.packages, move, m_dependencyGraph,
+                                      budget.lsIterationsWithoutImprovement, maxGraspIterations);
             bagGrasp->setTimestamp(m_timestamp);
             updateBestBag(bagGrasp);
             resultBag.push_back(std::move(bagGrasp));
-        }
+        });
 
         // GRASP_VNS
-        {
-            GRASP_VNS graspVNS(m_maxTime, m_generator(), static_cast<int>(problemInstance.packages.size() / 3), -1);
-            auto bagGraspVNS = graspVNS.run(problemInstance.maxCapacity, problemInstance.packages, move, m_dependencyGraph, 200, maxGraspIterations);
+        runStage("GRASP_VNS", move, [&]() {
+            GRASP_VNS graspVNS(m_maxTime, m_generator(), rclSize, parameters.alpha);
+            graspVNS.setNumThreads(budget.threads);
+            graspVNS.setInitialSolution(warmStartBag.get());
+            graspVNS.setVnsFrequency(parameters.vnsFrequency);
+            graspVNS.setThreadPinning(m_threadPinning);
+            if (m_autoCalibrate || tuned) graspVNS.setLocalSearchIterations(budget.lsMaxIterations);
+            auto bagGraspVNS = graspVNS.run(problemInstance.maxCapacity, problemInstance.packages, move, m_dependencyGraph,
+                                            budget.lsIterationsWithoutImprovement, maxGraspIterations);
             bagGraspVNS->setTimestamp(m_timestamp);
             updateBestBag(bagGraspVNS);
             resultBag.push_back(std::move(bagGraspVNS));
-        }
+        });
     }
 
     for (auto& bag : resultBag){
         bag->setSeed(m_seed);
     }
 
+    if (m_hardwareCountersProfile) LOG_INFO("[PERF] Hardware counters\n" << m_hardwareCountersProfile->summary());
+
+    if (checkpointWriter) checkpointWriter->flush();
+    if (results) results->flush();
+    LOGGER::flush();
     return resultBag;
 }
 
+// =============================================================
+// == Checkpoint Resume
+// =============================================================
+bool Algorithm::resumeFromCheckpoint(const std::vector<Package*>& packages,
+                                     CHECKPOINT::RunProgress& progress,
+                                     std::vector<std::unique_ptr<Bag>>& resultBag,
+                                     std::shared_ptr<Bag>& bestInitialBag,
+                                     int& bestBenefit)
+{
+    if (m_checkpointFile.empty() || !std::filesystem::exists(m_checkpointFile)) return false;
+
+    CHECKPOINT::RunState state;
+    try {
+        state = CHECKPOINT::load(m_checkpointFile, packages, m_dependencyGraph);
+    } catch (const std::exception& e) {
+        LOG_WARNING("[CHECKPOINT] Ignoring " << m_checkpointFile << ": " << e.what());
+        return false;
+    }
+    if (state.progress.instanceFingerprint != progress.instanceFingerprint || state.progress.seed != m_seed) {
+        LOG_WARNING("[CHECKPOINT] Ignoring " << m_checkpointFile << ": taken on another instance or seed");
+        return false;
+    }
+    if (state.progress.portfolio != progress.portfolio) {
+        LOG_WARNING("[CHECKPOINT] Ignoring " << m_checkpointFile << ": taken with portfolio mode "
+                    << (state.progress.portfolio ? "on" : "off"));
+        return false;
+    }
+
+    std::istringstream generatorState(state.progress.generatorState);
+    generatorState >> m_generator;
+    progress = state.progress;
+
+    // Restored bags join this run's reports.
+    for (auto& bag : state.resultBags) {
+        bag->setTimestamp(m_timestamp);
+        resultBag.push_back(std::move(bag));
+    }
+    if (state.incumbent) {
+        bestBenefit = state.incumbent->getBenefit();
+        bestInitialBag = std::shared_ptr<Bag>(std::move(state.incumbent));
+    }
+
+    LOG_INFO("[CHECKPOINT] Resumed " << progress.completedStages << " stages ("
+             << progress.elapsedSeconds << " s) from " << m_checkpointFile);
+    return true;
+}
+
+// =============================================================
+// == Re-optimization after an instance edit
+// =============================================================
+std::unique_ptr<Bag> Algorithm::reoptimize(ProblemInstance& problemInstance,
+                                           const INSTANCE_DELTA::InstanceDelta& delta,
+                                           const Bag& previousBest,
+                                           const std::string& timestamp)
+{
+    auto start_time = std::chrono::steady_clock::now();
+    m_timestamp = timestamp;
+
+    // The graph survives between calls; rebuild it only when it belongs to another instance.
+    const auto& packages = problemInstance.packages;
+    if (m_dependencyGraph.size() != packages.size() ||
+        (!packages.empty() && m_dependencyGraph.count(packages.front()) == 0))
+        precomputeDependencyGraph(problemInstance.packages, problemInstance.dependencies);
+
+    auto bag = std::make_unique<Bag>(previousBest);
+    const int benefitBefore = bag->getBenefit();
+    std::vector<Package*> touched = INSTANCE_DELTA::apply(delta, problemInstance, m_dependencyGraph, bag.get());
+    const int benefitAfterEdit = bag->getBenefit();
+
+    // The VND outlives the call so its dependency index is built once per graph; only edited links are patched.
+    if (!m_reoptimizeVND) {
+        m_reoptimizeVND = std::make_unique<VND>(m_maxTime, m_generator());
+        m_reoptimizeVND->setLocalSearchLimits(REOPTIMIZE_LS_ITERATIONS_WITHOUT_IMPROVEMENT, REOPTIMIZE_LS_ITERATIONS);
+    }
+    for (const auto* links : {&delta.addedLinks, &delta.removedLinks})
+        for (const auto& link : *links)
+            m_reoptimizeVND->getSearchEngine().onDependencyLinkChanged(problemInstance.packages[link.package],
+                                                                      problemInstance.dependencies[link.dependency]);
+
+    bool repaired = false;
+    if (bag->getSize() > problemInstance.maxCapacity) {
+        repaired = true;
+        if (!SOLUTION_REPAIR::repair(*bag, problemInstance.maxCapacity, m_dependencyGraph, m_seed)) {
+            LOG_WARNING("[REOPTIMIZE] Previous solution could not be repaired; starting from an empty bag");
+            bag = std::make_unique<Bag>(ALGORITHM::ALGORITHM_TYPE::NONE, timestamp);
+        }
+    }
+
+    // A repair or a new capacity frees or takes space bag-wide, so the search widens to every package.
+    const std::vector<Package*>& candidates = (repaired || delta.capacity >= 0) ? problemInstance.packages : touched;
+
+    VND& vnd = *m_reoptimizeVND;
+    vnd.setMaxThreads(m_threadBudget);
+    const bool widened = &candidates == &problemInstance.packages;
+    std::unique_ptr<Bag> result;
+    if (candidates.empty()) result = std::move(bag);
+    else if (m_parallelVND && widened) result = vnd.runParallel(problemInstance.maxCapacity, bag.get(), candidates, m_dependencyGraph);
+    else result = vnd.run(problemInstance.maxCapacity, bag.get(), candidates, m_dependencyGraph);
+
+    auto end_time = std::chrono::steady_clock::now();
+    result->setBagAlgorithm(ALGORITHM::ALGORITHM_TYPE::VND);
+    result->setLocalSearch(ALGORITHM::LOCAL_SEARCH::BEST_IMPROVEMENT);
+    result->setTimestamp(m_timestamp);
+    result->setSeed(m_seed);
+    result->setAlgorithmTime(std::chrono::duration<double>(end_time - start_time).count());
+    result->setMetaheuristicParameters(
+        "Re-optimization | Edits: " + std::to_string(delta.size()) +
+        " | Changed packages: " + std::to_string(touched.size()) +
+        " | Candidates: " + std::to_string(candidates.size()) +
+        " | Repaired: " + std::string(repaired ? "yes" : "no") +
+        " | Parallel VND: " + std::string(m_parallelVND && widened ? "yes" : "no") +
+        " | Benefit before/after edit: " + std::to_string(benefitBefore) + "/" + std::to_string(benefitAfterEdit));
+    PROGRESS::report(PROGRESS::EventKind::FINISHED, result->getBagAlgorithm(), result->getMovementType(),
+                     result->getBenefit(), result->getSize());
+    LOGGER::flush();
+    return result;
+}
+
+// =============================================================
+// == Capacity Sweep
+// =============================================================
+std::vector<std::unique_ptr<Bag>> Algorithm::sweepCapacity(const ProblemInstance& problemInstance,
+                                                           const std::vector<int>& capacities,
+                                                           const std::string& timestamp,
+                                                           unsigned int maxBands)
+{
+    m_timestamp = timestamp;
+    precomputeDependencyGraph(problemInstance.packages, problemInstance.dependencies);
+
+    std::vector<std::unique_ptr<Bag>> curve(capacities.size());
+    if (capacities.empty()) return curve;
+
+    unsigned int bands = maxBands;
+    if (bands == 0) {
+        unsigned int hw = std::thread::hardware_concurrency();
+        bands = hw == 0 ? 1u : hw;
+    }
+    if (m_threadBudget > 0) bands = std::min(bands, m_threadBudget);
+    bands = std::max(1u, std::min<unsigned int>(bands, static_cast<unsigned int>(capacities.size())));
+
+    // Seeds are drawn up front, so the curve does not depend on thread scheduling.
+    const size_t bandSize = (capacities.size() + bands - 1) / bands;
+    std::vector<unsigned int> bandSeeds(bands);
+    for (auto& seed : bandSeeds) seed = m_generator();
+
+    std::vector<std::thread> workers;
+    for (unsigned int band = 0; band < bands; ++band) {
+        const size_t first = band * bandSize;
+        const size_t last = std::min(first + bandSize, capacities.size());
+        if (first >= last) break;
+        workers.emplace_back(&Algorithm::sweepBand, this, std::cref(problemInstance), std::cref(capacities),
+                             first, last, bandSeeds[band], std::ref(curve));
+    }
+    for (auto& worker : workers) worker.join();
+
+    LOGGER::flush();
+    return curve;
+}
+
+void Algorithm::sweepBand(const ProblemInstance& problemInstance, const std::vector<int>& capacities,
+                          size_t first, size_t last, unsigned int seed, std::vector<std::unique_ptr<Bag>>& curve) const
+{
+    // The band edits the capacity of its own deep copy; its bags are mapped back to the caller's packages.
+    ProblemInstance instance = problemInstance;
+    instance.maxCapacity = capacities[first];
+    std::unordered_map<const Package*, size_t> packageIndex;
+    packageIndex.reserve(instance.packages.size());
+    for (size_t i = 0; i < instance.packages.size(); ++i) packageIndex[instance.packages[i]] = i;
+
+    Algorithm solver(m_maxTime, seed);
+    solver.m_timestamp = m_timestamp;
+    solver.precomputeDependencyGraph(instance.packages, instance.dependencies);
+
+    // Anchor: the best greedy bag, improved by a full VND.
+    auto anchorStart = std::chrono::steady_clock::now();
+    std::unique_ptr<Bag> current;
+    {
+        ConstructiveSolutions constructiveSolutions(m_maxTime, solver.m_generator, solver.m_dependencyGraph, m_timestamp);
+        std::vector<std::unique_ptr<Bag>> candidates = constructiveSolutions.greedyBag(instance.maxCapacity, instance.packages);
+        candidates.push_back(constructiveSolutions.marginalGreedyBag(instance.maxCapacity, instance.packages));
+        for (auto& bag : candidates)
+            if (!current || bag->getBenefit() > current->getBenefit()) current = std::move(bag);
+        VND vnd(m_maxTime, solver.m_generator());
+        current = vnd.run(instance.maxCapacity, current.get(), instance.packages, solver.m_dependencyGraph);
+        current->setAlgorithmTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - anchorStart).count());
+        current->setMetaheuristicParameters(current->getMetaheuristicParameters() + " | Sweep anchor");
+    }
+
+    for (size_t i = first; i < last; ++i) {
+        if (i > first) {
+            INSTANCE_DELTA::InstanceDelta delta;
+            delta.capacity = capacities[i];
+            current = solver.reoptimize(instance, delta, *current, m_timestamp);
+        }
+
+        std::vector<Package*> selected;
+        selected.reserve(current->getPackages().size());
+        for (const Package* package : current->getPackages())
+            selected.push_back(problemInstance.packages[packageIndex.at(package)]);
+
+        auto point = std::make_unique<Bag>(selected, m_dependencyGraph);
+        point->setBagAlgorithm(current->getBagAlgorithm());
+        point->setLocalSearch(current->getBagLocalSearch());
+        point->setMovementType(current->getMovementType());
+        point->setFeasibilityStrategy(current->getFeasibilityStrategy());
+        point->setAlgorithmTime(current->getAlgorithmTime());
+        point->setTimestamp(m_timestamp);
+        point->setSeed(m_seed);
+        point->setMetaheuristicParameters(current->getMetaheuristicParameters() +
+                                          " | Capacity: " + std::to_string(capacities[i]));
+        curve[i] = std::move(point);
+    }
+}
+
+// =============================================================
+// == Warm Start
+// =============================================================
+std::unique_ptr<Bag> Algorithm::loadWarmStartBag(const ProblemInstance& problemInstance)
+{
+    if (m_warmStartPath.empty()) return nullptr;
+
+    std::string reportFile = m_warmStartPath;
+    if (std::filesystem::is_directory(m_warmStartPath)) {
+        reportFile = FILE_PROCESSOR::findBestReport(m_warmStartPath, m_warmStartInstance,
+                                                    static_cast<int>(problemInstance.packages.size()));
+        if (reportFile.empty()) {
+            LOG_WARNING("[WARM START] No report for " << m_warmStartInstance << " under " << m_warmStartPath);
+            return nullptr;
+        }
+    }
+
+    try {
+        SolutionReport report = FILE_PROCESSOR::loadReport(reportFile);
+        auto bag = FILE_PROCESSOR::bagFromReport(report, problemInstance.packages, m_dependencyGraph,
+                                                 problemInstance.maxCapacity, m_seed);
+        if (bag->getBenefit() != report.reportedBenefit)
+            LOG_WARNING("[WARM START] " << reportFile << " reports benefit " << report.reportedBenefit
+                        << ", rebuilt bag has " << bag->getBenefit());
+        LOG_INFO("[WARM START] Loaded " << reportFile << " (benefit " << bag->getBenefit() << ")");
+        return bag;
+    } catch (const std::exception& e) {
+        LOG_WARNING("[WARM START] Ignoring " << reportFile << ": " << e.what());
+        return nullptr;
+    }
+}
+
 // =============================================================
 // == Dependency Precomputation (unchanged)
 // =============================================================
 void Algorithm::precomputeDependencyGraph(const std::vector<Package*>& packages,
                                           const std::vector<Dependency*>& dependencies)
 {
+    m_reoptimizeVND.reset();  // its dependency index belongs to the old graph
     m_dependencyGraph.clear();
     m_dependencyGraph.reserve(packages.size());
 
@@ -177,6 +717,7 @@ void Algorithm::precomputeDependencyGraph(const std::vector<Package*>& packages,
                 depVector.push_back(pair.second);
             }
             m_dependencyGraph[package] = std::move(depVector);
+            package->getDependenciesSize(); // fill the lazy cache before worker threads read it
         }
     }
 }
@@ -1,6 +1,7 @@
 #ifndef ALGORITHM_H
 #define ALGORITHM_H
 
+#include <atomic>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -9,11 +10,18 @@
 #include <memory>
 
 #include "data_model.h"
+#include "calibration.h"
+#include "result_stream.h"
 
 class Bag;
 class Package;
 class Dependency;
 class LocalSearch;
+class VND;
+
+namespace CHECKPOINT { struct RunProgress; }
+namespace INSTANCE_DELTA { struct InstanceDelta; }
+namespace PERF_COUNTERS { class Profile; }
 
 namespace ALGORITHM {
     
@@ -29,7 +37,8 @@ enum class ALGORITHM_TYPE {
     VND,
     VNS,
     GRASP,
-    GRASP_VNS
+    GRASP_VNS,
+    GREEDY_PACKAGE_MARGINAL_RATIO  // Appended: checkpoints store the numeric value.
 };
 
 enum class LOCAL_SEARCH {
@@ -55,12 +64,205 @@ std::string toString(LOCAL_SEARCH localSearch);
 class Algorithm {
 public:
 
+    /// Package orders (benefit, benefit/size, size) each filled greedily and randomized-greedily.
+    static constexpr int CONSTRUCTIVE_SORT_ORDERS = 3;
+    /// Constructive bags: random, greedy and random greedy per sort order, marginal greedy.
+    static constexpr int CONSTRUCTIVE_BAG_COUNT = 1 + 2 * CONSTRUCTIVE_SORT_ORDERS + 1;
+    /// Movements each run as a VNS neighborhood, a GRASP and a GRASP_VNS stage.
+    static constexpr int MOVEMENT_COUNT = 5;
+    /// Number of bags returned by run(): the constructive bags, VND, VNS, and GRASP/GRASP_VNS per movement.
+    static constexpr int RESULT_BAG_COUNT = CONSTRUCTIVE_BAG_COUNT + 2 + 2 * MOVEMENT_COUNT;
+
     explicit Algorithm(double maxTime, unsigned int seed);
+    ~Algorithm();
 
     std::vector<std::unique_ptr<Bag>> run(const ProblemInstance& problemInstance, const std::string& timestamp);
 
+    /**
+     * @brief Enables or disables the calibration phase at the start of run().
+     *
+     * When enabled, thread counts and iteration limits are measured on the
+     * instance and machine instead of using the built-in constants, and the
+     * chosen budget is appended to every bag's metaheuristic parameters. Off by
+     * default: calibrated limits depend on wall-clock timing, so a seed alone
+     * no longer reproduces a run.
+     */
+    void setAutoCalibration(bool enabled);
+
+    /**
+     * @brief Gets the measurements and budget of the last calibrated run.
+     */
+    const CALIBRATION::CalibrationResult& getCalibration() const;
+
+    /**
+     * @brief Caps the threads any single metaheuristic may use (0 = hardware concurrency).
+     *
+     * Used when several Algorithm instances run concurrently, so their
+     * internal workers do not oversubscribe the machine.
+     */
+    void setThreadBudget(unsigned int maxThreads);
+
+    /**
+     * @brief Enables checkpointing of run() to a binary file after every stage.
+     *
+     * @param filename Checkpoint path; an empty string disables checkpointing.
+     * @param resume When true and the file holds a checkpoint of the same instance
+     *               and seed, run() restores it and continues after its last stage.
+     *               The restored bags are published to the result callback first.
+     */
+    void setCheckpoint(const std::string& filename, bool resume);
+
+    /**
+     * @brief Warm-starts run() from a previous solution report.
+     *
+     * @param path A report file, or a directory searched for the best report of
+     *             the instance; an empty string disables warm starts.
+     * @param instanceFileName File name of the instance being solved; a directory
+     *             search only accepts reports whose "Input File:" names it.
+     *
+     * The rebuilt bag becomes the incumbent that VND and VNS improve when it beats
+     * the constructive solutions, and it seeds every GRASP_VNS worker.
+     */
+    void setWarmStart(const std::string& path, const std::string& instanceFileName);
+
+    /**
+     * @brief Runs with search parameters tuned offline (see TUNING::tune).
+     *
+     * @param filename A parameter file; an empty string keeps the built-in values.
+     *
+     * The file sets the GRASP RCL size, alpha and fill threshold, the GRASP_VNS
+     * VNS frequency and the local search limits, which then replace the
+     * calibrated ones. A file that cannot be loaded is reported and ignored.
+     */
+    void setTunedParameters(const std::string& filename);
+
+    /**
+     * @brief Collects hardware performance counters during run() (Linux perf_event_open).
+     *
+     * Cycles, instructions, cache misses and branch misses are charged per
+     * algorithm and MovementType and aggregated over all worker threads (see
+     * PERF_COUNTERS). Where perf events are not permitted, a warning is logged
+     * once and run() proceeds without counters.
+     */
+    void setHardwareCounters(bool enabled);
+
+    /**
+     * @brief Gets the counters of the last run() with hardware counters enabled, or nullptr.
+     */
+    std::shared_ptr<const PERF_COUNTERS::Profile> getHardwareCounters() const;
+
+    /**
+     * @brief Pins GRASP and GRASP_VNS workers to CPUs (topology read from /sys).
+     *
+     * Workers are spread over the NUMA nodes and read a copy of the instance
+     * made on their own node. CPUs are shared fairly between concurrent runs.
+     */
+    void setThreadPinning(bool enabled);
+
+    /**
+     * @brief Runs VND on several cores instead of one.
+     *
+     * The VND stage of run() then descends from every constructive bag (and a
+     * warm start that beats them) at once with VND::runMultiStart, and keeps
+     * the best result; a portfolio run is not affected. reoptimize() explores
+     * all neighborhoods concurrently with VND::runParallel when its search
+     * widens to every package. Both use at most the thread budget. Off by
+     * default: the sequential VND starts from the incumbent only.
+     */
+    void setParallelVND(bool enabled);
+
+    /**
+     * @brief Races the VND, VNS and GRASP stages of run() as one portfolio.
+     *
+     * VND, VNS and one GRASP per movement become steppers of a STEPPER::Portfolio
+     * sharing the thread budget and a single time limit; the time slices go to
+     * whichever currently improves fastest. run() still returns one bag per
+     * algorithm and movement, GRASP_VNS stages run afterwards as usual. Off by
+     * default; a checkpoint only resumes a run of the same mode.
+     */
+    void setPortfolio(bool enabled);
+
+    /**
+     * @brief Streams the bags of run() to callback while the run continues.
+     *
+     * Every bag run() will return is emitted as a FINISHED result when its
+     * algorithm ends, followed by an INCUMBENT result if it beats the run's
+     * previous bags and incumbents is true. The callback runs on a thread of
+     * its own, one result at a time; run() returns after the last call.
+     * Bags restored from a checkpoint are not emitted again.
+     *
+     * @param callback Consumer of the results; an empty function disables streaming.
+     */
+    void setResultCallback(RESULT_STREAM::Callback callback, bool incumbents = false);
+
+    /**
+     * @brief Stops run() before its next stage once *cancelToken is true.
+     *
+     * run() then returns the bags of the stages already finished, which have
+     * also been streamed (see setResultCallback).
+     */
+    void setCancelToken(const std::atomic<bool>* cancelToken);
+
+    /**
+     * @brief Applies an instance edit and re-optimizes a previous solution around it.
+     *
+     * The previous bag is carried over to the edited instance and improved by a
+     * VND whose candidates are only the packages the edit touched (see
+     * INSTANCE_DELTA::apply). The dependency graph, and the VND with its search
+     * engine and dependency index, are kept between calls: an edit only patches
+     * the entries it changes, and the index is built once per graph. The search
+     * itself still copies the bag for every neighborhood, so a call costs the
+     * size of the edit times the size of the solution, not the whole instance.
+     * When the bag no longer fits and must be repaired, or the capacity changes
+     * (every step of sweepCapacity), the search widens to every package and
+     * costs as much as a VND over the instance; a parallel VND then also builds
+     * one index per neighborhood.
+     *
+     * @param problemInstance The instance to edit in place.
+     * @param delta The edit to apply.
+     * @param previousBest A solution over problemInstance's packages (e.g. the best bag of run()).
+     * @param timestamp Timestamp stamped on the returned bag.
+     * @return The re-optimized solution of the edited instance.
+     * @throws std::runtime_error if the delta references unknown packages or dependencies.
+     */
+    std::unique_ptr<Bag> reoptimize(ProblemInstance& problemInstance,
+                                    const INSTANCE_DELTA::InstanceDelta& delta,
+                                    const Bag& previousBest,
+                                    const std::string& timestamp);
+
+    /**
+     * @brief Solves the instance for a list of capacities (a benefit-vs-capacity curve).
+     *
+     * The capacities are split into contiguous bands solved in parallel. Each band
+     * solves its first capacity from the best greedy bag improved by VND, then walks
+     * the rest in the given order, warm-starting every point from its neighbor with
+     * reoptimize(): packages are added when the capacity grows and the bag is
+     * repaired when it shrinks. Pass the capacities in increasing or decreasing order.
+     *
+     * @param problemInstance The instance; its own capacity is ignored.
+     * @param capacities Capacities to solve, in sweep order.
+     * @param timestamp Timestamp stamped on the returned bags.
+     * @param maxBands Maximum parallel bands (0 = hardware concurrency, capped by setThreadBudget).
+     * @return One bag per capacity, in the order of capacities.
+     */
+    std::vector<std::unique_ptr<Bag>> sweepCapacity(const ProblemInstance& problemInstance,
+                                                    const std::vector<int>& capacities,
+                                                    const std::string& timestamp,
+                                                    unsigned int maxBands = 0);
+
 private:
 
+    bool resumeFromCheckpoint(const std::vector<Package*>& packages,
+                              CHECKPOINT::RunProgress& progress,
+                              std::vector<std::unique_ptr<Bag>>& resultBag,
+                              std::shared_ptr<Bag>& bestInitialBag,
+                              int& bestBenefit);
+
+    std::unique_ptr<Bag> loadWarmStartBag(const ProblemInstance& problemInstance);
+
+    void sweepBand(const ProblemInstance& problemInstance, const std::vector<int>& capacities,
+                   size_t first, size_t last, unsigned int seed, std::vector<std::unique_ptr<Bag>>& curve) const;
+
     void precomputeDependencyGraph(const std::vector<Package*>& packages,
                                    const std::vector<Dependency*>& dependencies);
 
@@ -68,7 +270,24 @@ private:
     unsigned int m_seed;
     std::mt19937 m_generator;
     std::string m_timestamp;
+    bool m_autoCalibrate = false;
+    unsigned int m_threadBudget = 0;
+    std::string m_checkpointFile;
+    bool m_resume = false;
+    std::string m_warmStartPath;
+    std::string m_warmStartInstance;
+    std::string m_tunedParametersFile;
+    bool m_hardwareCounters = false;
+    bool m_threadPinning = false;
+    bool m_portfolio = false;
+    bool m_parallelVND = false;
+    RESULT_STREAM::Callback m_resultCallback;
+    bool m_streamIncumbents = false;
+    const std::atomic<bool>* m_cancelToken = nullptr;
+    std::shared_ptr<PERF_COUNTERS::Profile> m_hardwareCountersProfile;
+    CALIBRATION::CalibrationResult m_calibration;
     std::unordered_map<const Package*, std::vector<const Dependency*>> m_dependencyGraph;
+    std::unique_ptr<VND> m_reoptimizeVND;  ///< Kept across reoptimize() calls on the same graph.
 };
 
 #endif // ALGORITHM_H
\ No newline at end of file
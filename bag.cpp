@@ -113,6 +113,8 @@ bool Bag::addPackageIfPossible(const Package& package, int maxCapacity,
             m_size += dep->getSize();
         }
     }
+    if (m_journaling)
+        m_journal.push_back({&package, &dependencies, true});
     return true;
 }
 
@@ -122,6 +124,8 @@ void Bag::removePackage(const Package& package, const std::vector<const Dependen
         return;
 
     m_benefit -= package.getBenefit();
+    if (m_journaling)
+        m_journal.push_back({&package, &dependencies, false});
 
     for (const auto* dep : dependencies) {
         auto it = m_dependencyRefCount.find(dep);
@@ -190,6 +194,46 @@ std::vector<const Package*> Bag::getInvalidPackages(
     return invalid;
 }
 
+// =====================================================================================
+// UNDO JOURNAL
+// =====================================================================================
+
+void Bag::beginJournal()
+{
+    m_journal.clear();
+    m_journaling = true;
+}
+
+void Bag::rollbackJournal()
+{
+    m_journaling = false;
+    for (auto it = m_journal.rbegin(); it != m_journal.rend(); ++it) {
+        if (it->added)
+            removePackage(*it->package, *it->dependencies);
+        else
+            addPackageIfPossible(*it->package, INT_MAX, *it->dependencies);
+    }
+    m_journal.clear();
+}
+
+std::vector<Bag::JournalEntry> Bag::commitJournal()
+{
+    m_journaling = false;
+    std::vector<JournalEntry> journal;
+    journal.swap(m_journal);
+    return journal;
+}
+
+void Bag::replayJournal(const std::vector<JournalEntry>& journal)
+{
+    for (const auto& entry : journal) {
+        if (entry.added)
+            addPackageIfPossible(*entry.package, INT_MAX, *entry.dependencies);
+        else
+            removePackage(*entry.package, *entry.dependencies);
+    }
+}
+
 // =====================================================================================
 // Utility
 // =====================================================================================
@@ -66,6 +66,31 @@ public:
     std::vector<const Package*> getInvalidPackages(
         const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph) const;
 
+    // =====================================================================================
+    // UNDO JOURNAL
+    // =====================================================================================
+
+    /**
+     * @brief One recorded add/remove; dependencies point into the caller's dependency graph.
+     */
+    struct JournalEntry {
+        const Package* package;
+        const std::vector<const Dependency*>* dependencies;
+        bool added;
+    };
+
+    /// Starts recording every successful add/remove (clears any previous journal).
+    void beginJournal();
+
+    /// Reverts every change recorded since beginJournal() and stops recording.
+    void rollbackJournal();
+
+    /// Keeps the changes, stops recording and returns the recorded entries.
+    std::vector<JournalEntry> commitJournal();
+
+    /// Re-applies entries recorded on another bag that started from the same state.
+    void replayJournal(const std::vector<JournalEntry>& journal);
+
     // --- Utility ---
     std::string toString() const;
 
@@ -84,6 +109,9 @@ private:
     std::unordered_set<const Package*> m_baggedPackages;
     std::unordered_set<const Dependency*> m_baggedDependencies;
     std::unordered_map<const Dependency*, int> m_dependencyRefCount;
+
+    bool m_journaling = false;
+    std::vector<JournalEntry> m_journal;
 };
 
 #endif // BAG_H
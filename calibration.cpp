@@ -0,0 +1,270 @@
+#include "calibration.h"
+
+#include "bag.h"
+#include "package.h"
+#include "dependency.h"
+#include "grasp_helper.h"
+#include "move_evaluation_cache.h"
+#include "search_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <thread>
+
+namespace CALIBRATION {
+
+// =====================================================================================
+// Tuning Constants
+// =====================================================================================
+static constexpr double CALIBRATION_TIME_FRACTION = 0.01;  // share of the budget spent calibrating
+static constexpr double CALIBRATION_MAX_SECONDS = 0.25;    // hard cap on calibration time
+static constexpr double MIN_PARALLEL_EFFICIENCY = 0.5;     // extra threads must deliver this much each
+static constexpr double LS_STEP_FRACTION = 0.002;          // share of the budget one LS step may use
+static constexpr double ITERATION_HEADROOM = 2.0;          // caps sit above the estimate so the deadline binds
+static constexpr int MIN_LS_MAX_ITERATIONS = 200;
+static constexpr int MAX_LS_MAX_ITERATIONS = 1000000;
+static constexpr int MIN_LS_PATIENCE = 20;
+static constexpr int MAX_LS_PATIENCE = 200;
+static constexpr int K_MAX = 5;                            // neighborhoods explored per VNS/VND round
+static constexpr double SAMPLE_SHARE = 0.2;                // share of the calibration time per cost sample
+static constexpr size_t MIN_CONSTRUCTION_PACKAGES = 256;   // smallest instance slice timed for construction
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(const Clock::time_point& start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static int clampToInt(double value, int low, int high)
+{
+    if (!std::isfinite(value)) return high;
+    return static_cast<int>(std::clamp(value, static_cast<double>(low), static_cast<double>(high)));
+}
+
+/**
+ * @brief Fills a bag in random order; a cheap stand-in for a typical incumbent.
+ *
+ * Stops early at the deadline, leaving a partly filled but still representative bag.
+ */
+static Bag buildSampleBag(int bagSize, const std::vector<Package*>& allPackages,
+    const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+    std::mt19937& rng, const Clock::time_point& deadline)
+{
+    std::vector<Package*> order = allPackages;
+    std::shuffle(order.begin(), order.end(), rng);
+    Bag bag(ALGORITHM::ALGORITHM_TYPE::NONE, "calibration");
+    for (size_t i = 0; i < order.size(); ++i) {
+        if (i % 256 == 255 && Clock::now() >= deadline) break;
+        bag.addPackageIfPossible(*order[i], bagSize, dependencyGraph.at(order[i]));
+    }
+    return bag;
+}
+
+/**
+ * @brief Evaluates random 1-1 swaps on the bag as local search does; returns the feasible count.
+ */
+static long long evaluateMoves(const Bag& bag, int bagSize,
+    const std::vector<const Package*>& inside,
+    const std::vector<const Package*>& outside,
+    const MoveEvaluationCache& moveCache,
+    long long count, unsigned int seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> pickIn(0, inside.size() - 1);
+    std::uniform_int_distribution<size_t> pickOut(0, outside.size() - 1);
+    long long feasible = 0;
+    for (long long i = 0; i < count; ++i) {
+        if (bag.getSize() + moveCache.swapSizeChange(bag, inside[pickIn(rng)], outside[pickOut(rng)]) <= bagSize)
+            ++feasible;
+    }
+    return feasible;
+}
+
+/**
+ * @brief Estimates the cost of one GRASP construction within sampleSeconds.
+ *
+ * Constructions are timed on growing random slices of the instance (with the
+ * capacity scaled alike) until a slice uses the sample time or covers the whole
+ * instance. A construction scans the candidates once per added package, so the
+ * last timing is extrapolated quadratically to the full instance.
+ */
+static double estimateConstructionSeconds(int bagSize, const std::vector<Package*>& allPackages,
+    const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+    double sampleSeconds, std::mt19937& rng)
+{
+    std::vector<Package*> order = allPackages;
+    std::shuffle(order.begin(), order.end(), rng);
+    SearchEngine engine(rng());
+    std::vector<std::pair<Package*, double>> scoreBuffer;
+    std::vector<Package*> rclBuffer;
+
+    const auto start = Clock::now();
+    size_t sliceSize = std::min(order.size(), MIN_CONSTRUCTION_PACKAGES);
+    while (true) {
+        const std::vector<Package*> slice(order.begin(), order.begin() + sliceSize);
+        const double share = static_cast<double>(sliceSize) / static_cast<double>(order.size());
+        const int sliceCapacity = std::max(1, static_cast<int>(bagSize * share));
+        double alpha = 0.5;
+        auto sliceStart = Clock::now();
+        GRASP_HELPER::constructionPhaseFast(sliceCapacity, slice, dependencyGraph, engine,
+                                            scoreBuffer, rclBuffer,
+                                            std::max(1, static_cast<int>(slice.size() / 3)), alpha, alpha);
+        const double elapsed = secondsSince(sliceStart);
+
+        // Doubling the slice roughly quadruples the cost: stop before it overruns the sample time.
+        if (sliceSize == order.size() || secondsSince(start) + 4.0 * elapsed > sampleSeconds)
+            return elapsed / (share * share);
+        sliceSize = std::min(order.size(), sliceSize * 2);
+    }
+}
+
+// =====================================================================================
+// Public API
+// =====================================================================================
+CalibrationResult calibrate(
+    int bagSize,
+    const std::vector<Package*>& allPackages,
+    const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+    double timeBudget,
+    unsigned int seed,
+    unsigned int maxThreads)
+{
+    CalibrationResult result;
+    if (allPackages.empty() || timeBudget <= 0.0) return result;
+
+    const auto calibrationStart = Clock::now();
+    const double calibrationBudget = std::min(CALIBRATION_MAX_SECONDS, timeBudget * CALIBRATION_TIME_FRACTION);
+    std::mt19937 rng(seed);
+
+    // --- 1. Sample incumbent ---
+    const auto sampleDeadline = calibrationStart + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(calibrationBudget * SAMPLE_SHARE));
+    Bag sample = buildSampleBag(bagSize, allPackages, dependencyGraph, rng, sampleDeadline);
+    std::vector<const Package*> inside(sample.getPackages().begin(), sample.getPackages().end());
+    std::vector<const Package*> outside;
+    for (const Package* pkg : allPackages)
+        if (!sample.getPackages().count(pkg)) outside.push_back(pkg);
+
+    DependencyUsers dependencyUsers(dependencyGraph);
+    const MoveEvaluationCache moveCache(dependencyGraph, dependencyUsers);
+
+    // --- 2. Cost of one move evaluation (doubling until the sample is long enough) ---
+    const double moveSampleSeconds = calibrationBudget * SAMPLE_SHARE;
+    if (!inside.empty() && !outside.empty()) {
+        long long count = 64;
+        while (true) {
+            auto start = Clock::now();
+            evaluateMoves(sample, bagSize, inside, outside, moveCache, count, rng());
+            double elapsed = secondsSince(start);
+            if (elapsed >= moveSampleSeconds || count >= (1LL << 24)) {
+                result.moveEvaluationSeconds = elapsed / static_cast<double>(count);
+                break;
+            }
+            count *= 2;
+        }
+    }
+
+    // --- 3. Cost of one GRASP construction ---
+    result.constructionSeconds = estimateConstructionSeconds(bagSize, allPackages, dependencyGraph,
+                                                             calibrationBudget * SAMPLE_SHARE, rng);
+
+    // --- 4. Parallel speedup: same per-thread workload on 1, 2, 4, ... threads ---
+    unsigned int hw = std::thread::hardware_concurrency();
+    const unsigned int threadLimit = maxThreads > 0 ? std::min(maxThreads, std::max(1u, hw)) : std::max(1u, hw);
+    unsigned int chosenThreads = 1;
+    double chosenSpeedup = 1.0;
+    if (threadLimit > 1 && result.moveEvaluationSeconds > 0.0) {
+        std::vector<unsigned int> candidates;
+        for (unsigned int t = 2; t < threadLimit; t *= 2) candidates.push_back(t);
+        candidates.push_back(threadLimit);
+
+        const double remaining = std::max(0.0, calibrationBudget - secondsSince(calibrationStart));
+        const double perRunSeconds = remaining / static_cast<double>(candidates.size() + 1);
+        const long long perThreadMoves = std::max<long long>(
+            64, static_cast<long long>(perRunSeconds / result.moveEvaluationSeconds));
+
+        auto throughput = [&](unsigned int threads) {
+            std::vector<Bag> copies(threads, sample);
+            std::atomic<long long> sink{0};
+            auto start = Clock::now();
+            std::vector<std::thread> workers;
+            for (unsigned int t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t]() {
+                    sink.fetch_add(evaluateMoves(copies[t], bagSize, inside, outside, moveCache,
+                                                 perThreadMoves, seed + t));
+                });
+            }
+            for (auto& w : workers) w.join();
+            double elapsed = std::max(1e-9, secondsSince(start));
+            return static_cast<double>(perThreadMoves) * threads / elapsed;
+        };
+
+        const double baseline = throughput(1);
+        for (unsigned int t : candidates) {
+            double speedup = throughput(t) / baseline;
+            if (speedup / t >= MIN_PARALLEL_EFFICIENCY && speedup > chosenSpeedup) {
+                chosenThreads = t;
+                chosenSpeedup = speedup;
+            }
+        }
+    }
+    result.parallelSpeedup = chosenSpeedup;
+
+    // --- 5. Budget derived from the measurements ---
+    SearchBudget& budget = result.budget;
+    budget.threads = chosenThreads;
+
+    if (result.moveEvaluationSeconds > 0.0) {
+        const double stepSeconds = timeBudget * LS_STEP_FRACTION;
+        budget.lsMaxIterations = clampToInt(stepSeconds / result.moveEvaluationSeconds,
+                                            MIN_LS_MAX_ITERATIONS, MAX_LS_MAX_ITERATIONS);
+        budget.lsIterationsWithoutImprovement = clampToInt(budget.lsMaxIterations / 10.0,
+                                                           MIN_LS_PATIENCE, MAX_LS_PATIENCE);
+    }
+
+    // A local search rarely walks its full patience; budget half of it per call.
+    const double lsCallSeconds = 0.5 * budget.lsIterationsWithoutImprovement *
+                                 budget.lsMaxIterations * result.moveEvaluationSeconds;
+    const double graspIterationSeconds = std::max(1e-6, result.constructionSeconds + lsCallSeconds);
+    budget.graspIterations = clampToInt(ITERATION_HEADROOM * timeBudget / graspIterationSeconds,
+                                        SearchBudget().graspIterations, 100000000);
+
+    const double vnsRoundSeconds = std::max(1e-6, K_MAX * lsCallSeconds / std::min<unsigned int>(K_MAX, chosenThreads));
+    budget.vnsMaxIterations = clampToInt(ITERATION_HEADROOM * timeBudget / vnsRoundSeconds,
+                                         SearchBudget().vnsMaxIterations, 100000000);
+
+    result.calibrationSeconds = secondsSince(calibrationStart);
+    return result;
+}
+
+// =====================================================================================
+// String Conversions
+// =====================================================================================
+std::string SearchBudget::toString() const
+{
+    std::ostringstream oss;
+    oss << "Threads: " << threads
+        << " | GRASP iterations: " << graspIterations
+        << " | LS patience: " << lsIterationsWithoutImprovement
+        << " | LS iterations: " << lsMaxIterations
+        << " | VNS iterations: " << vnsMaxIterations;
+    return oss.str();
+}
+
+std::string CalibrationResult::toString() const
+{
+    std::ostringstream oss;
+    oss << "Move eval (ns): " << moveEvaluationSeconds * 1e9
+        << " | Construction (ms): " << constructionSeconds * 1e3
+        << " | Speedup: " << parallelSpeedup
+        << " | Calibration (ms): " << calibrationSeconds * 1e3
+        << " | " << budget.toString();
+    return oss.str();
+}
+
+} // namespace CALIBRATION
@@ -0,0 +1,77 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Package;
+class Dependency;
+
+/**
+ * @brief Measures the instance and the machine to size thread counts and iteration budgets.
+ *
+ * The built-in limits (GRASP threads = packages/100 + 1, 100 GRASP iterations,
+ * 200/2000 local search iterations, fixed VNS rounds) are right for only one
+ * combination of instance size, machine and time budget. Calibration runs a few
+ * milliseconds of representative work before the solve to measure:
+ *  - the cost of a single move evaluation (MoveEvaluationCache, as local search does),
+ *  - the cost of one GRASP construction (extrapolated from smaller slices),
+ *  - the throughput speedup of 1..N threads on this machine.
+ * It then picks limits that keep all useful cores busy until the deadline
+ * instead of stopping early on an iteration cap.
+ */
+namespace CALIBRATION {
+
+/**
+ * @brief Effort limits handed to the metaheuristics.
+ *
+ * Default values reproduce the hand-picked limits used without calibration.
+ */
+struct SearchBudget {
+    unsigned int threads = 0;                 ///< Worker threads for GRASP/GRASP_VNS (0 = built-in heuristic).
+    int graspIterations = 100;                ///< Max GRASP iterations per worker.
+    int lsIterationsWithoutImprovement = 200; ///< Local search patience.
+    int lsMaxIterations = 2000;               ///< Move evaluations per local search step.
+    int vnsMaxIterations = 200;               ///< Max VNS rounds.
+
+    std::string toString() const;
+};
+
+/**
+ * @brief Measurements taken during calibration, together with the chosen budget.
+ */
+struct CalibrationResult {
+    double moveEvaluationSeconds = 0.0;   ///< Average cost of one move evaluation.
+    double constructionSeconds = 0.0;     ///< Cost of one GRASP construction.
+    double parallelSpeedup = 1.0;         ///< Measured throughput speedup at budget.threads.
+    double calibrationSeconds = 0.0;      ///< Wall time spent calibrating.
+    SearchBudget budget;
+
+    std::string toString() const;
+};
+
+/**
+ * @brief Calibrates the search budget for one instance on the current machine.
+ *
+ * Spends at most about 1% of the time budget (capped at a quarter of a second).
+ *
+ * @param bagSize Maximum bag capacity.
+ * @param allPackages All available packages.
+ * @param dependencyGraph Precomputed package dependency graph.
+ * @param timeBudget Time each metaheuristic is allowed to run, in seconds.
+ * @param seed Seed for the random samples.
+ * @param maxThreads Upper bound for the thread count (0 = hardware concurrency).
+ * @return The measurements and the chosen budget.
+ */
+CalibrationResult calibrate(
+    int bagSize,
+    const std::vector<Package*>& allPackages,
+    const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+    double timeBudget,
+    unsigned int seed,
+    unsigned int maxThreads = 0);
+
+} // namespace CALIBRATION
+
+#endif // CALIBRATION_H
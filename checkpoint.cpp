@@ -0,0 +1,332 @@
+#include "checkpoint.h"
+
+#include "bag.h"
+#include "package.h"
+#include "dependency.h"
+#include "data_model.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace CHECKPOINT {
+
+// =====================================================================================
+// Format
+// =====================================================================================
+static constexpr char MAGIC[4] = {'K', 'S', 'C', 'P'};
+static constexpr uint32_t FORMAT_VERSION = 2;
+
+// =====================================================================================
+// Encoding Helpers
+// =====================================================================================
+namespace {
+
+class Writer {
+public:
+    template <typename T>
+    void pod(const T& value) {
+        m_bytes.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            m_bytes.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        m_bytes.push_back(static_cast<char>(value));
+    }
+
+    void string(const std::string& value) {
+        varint(value.size());
+        m_bytes.append(value);
+    }
+
+    std::string take() { return std::move(m_bytes); }
+
+private:
+    std::string m_bytes;
+};
+
+class Reader {
+public:
+    explicit Reader(const std::string& bytes) : m_bytes(bytes) {}
+
+    template <typename T>
+    T pod() {
+        require(sizeof(T));
+        T value;
+        std::memcpy(&value, m_bytes.data() + m_offset, sizeof(T));
+        m_offset += sizeof(T);
+        return value;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            require(1);
+            const auto byte = static_cast<unsigned char>(m_bytes[m_offset++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return value;
+        }
+        throw std::runtime_error("Error: Malformed varint in checkpoint.");
+    }
+
+    std::string string() {
+        const uint64_t length = varint();
+        require(length);
+        std::string value = m_bytes.substr(m_offset, length);
+        m_offset += length;
+        return value;
+    }
+
+private:
+    void require(uint64_t count) const {
+        if (m_offset + count > m_bytes.size())
+            throw std::runtime_error("Error: Truncated checkpoint.");
+    }
+
+    const std::string& m_bytes;
+    size_t m_offset = 0;
+};
+
+void fnv1a(unsigned long long& hash, const void* data, size_t size)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+void writeBag(Writer& out, const Bag& bag, const std::unordered_map<const Package*, uint32_t>& packageIndex)
+{
+    out.pod(static_cast<uint8_t>(bag.getBagAlgorithm()));
+    out.pod(static_cast<uint8_t>(bag.getBagLocalSearch()));
+    out.pod(static_cast<uint8_t>(bag.getMovementType()));
+    out.pod(static_cast<uint8_t>(bag.getFeasibilityStrategy()));
+    out.pod(static_cast<uint32_t>(bag.getSeed()));
+    out.pod(bag.getAlgorithmTime());
+    out.string(bag.getTimestamp());
+    out.string(bag.getMetaheuristicParameters());
+
+    // Sorted indices, delta-encoded as varints: most gaps fit in one byte.
+    std::vector<uint32_t> indices;
+    indices.reserve(bag.getPackages().size());
+    for (const Package* pkg : bag.getPackages()) indices.push_back(packageIndex.at(pkg));
+    std::sort(indices.begin(), indices.end());
+
+    out.varint(indices.size());
+    uint32_t previous = 0;
+    for (uint32_t index : indices) {
+        out.varint(index - previous);
+        previous = index;
+    }
+}
+
+std::unique_ptr<Bag> readBag(Reader& in, const std::vector<Package*>& allPackages,
+                             const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph)
+{
+    const auto algorithm = static_cast<ALGORITHM::ALGORITHM_TYPE>(in.pod<uint8_t>());
+    const auto localSearch = static_cast<ALGORITHM::LOCAL_SEARCH>(in.pod<uint8_t>());
+    const auto movement = static_cast<SEARCH_ENGINE::MovementType>(in.pod<uint8_t>());
+    const auto feasibility = static_cast<SOLUTION_REPAIR::FEASIBILITY_STRATEGY>(in.pod<uint8_t>());
+    const auto seed = in.pod<uint32_t>();
+    const auto algorithmTime = in.pod<double>();
+    const std::string timestamp = in.string();
+    const std::string parameters = in.string();
+
+    const uint64_t count = in.varint();
+    std::vector<Package*> packages;
+    packages.reserve(std::min<uint64_t>(count, allPackages.size()));
+    uint64_t index = 0;
+    for (uint64_t i = 0; i < count; ++i) {
+        index += in.varint();
+        if (index >= allPackages.size())
+            throw std::runtime_error("Error: Checkpoint references an unknown package.");
+        packages.push_back(allPackages[index]);
+    }
+
+    auto bag = std::make_unique<Bag>(packages, dependencyGraph);
+    bag->setBagAlgorithm(algorithm);
+    bag->setLocalSearch(localSearch);
+    bag->setMovementType(movement);
+    bag->setFeasibilityStrategy(feasibility);
+    bag->setSeed(seed);
+    bag->setAlgorithmTime(algorithmTime);
+    bag->setTimestamp(timestamp);
+    bag->setMetaheuristicParameters(parameters);
+    return bag;
+}
+
+} // namespace
+
+// =====================================================================================
+// Public API
+// =====================================================================================
+unsigned long long fingerprint(const ProblemInstance& problemInstance)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    fnv1a(hash, &problemInstance.maxCapacity, sizeof(problemInstance.maxCapacity));
+    for (const Package* pkg : problemInstance.packages) {
+        const int benefit = pkg->getBenefit();
+        fnv1a(hash, pkg->getName().data(), pkg->getName().size());
+        fnv1a(hash, &benefit, sizeof(benefit));
+    }
+    for (const Dependency* dep : problemInstance.dependencies) {
+        const int size = dep->getSize();
+        fnv1a(hash, dep->getName().data(), dep->getName().size());
+        fnv1a(hash, &size, sizeof(size));
+    }
+    return hash;
+}
+
+std::string serialize(const RunProgress& progress, const Bag* incumbent,
+                      const std::vector<std::unique_ptr<Bag>>& resultBags,
+                      const std::vector<Package*>& allPackages)
+{
+    std::unordered_map<const Package*, uint32_t> packageIndex;
+    packageIndex.reserve(allPackages.size());
+    for (uint32_t i = 0; i < allPackages.size(); ++i) packageIndex[allPackages[i]] = i;
+
+    Writer out;
+    for (char c : MAGIC) out.pod(c);
+    out.pod(FORMAT_VERSION);
+    out.pod(static_cast<uint64_t>(progress.instanceFingerprint));
+    out.pod(static_cast<uint32_t>(progress.seed));
+    out.pod(static_cast<int32_t>(progress.completedStages));
+    out.pod(progress.elapsedSeconds);
+    out.string(progress.generatorState);
+
+    out.pod(static_cast<uint32_t>(progress.budget.threads));
+    out.pod(static_cast<int32_t>(progress.budget.graspIterations));
+    out.pod(static_cast<int32_t>(progress.budget.lsIterationsWithoutImprovement));
+    out.pod(static_cast<int32_t>(progress.budget.lsMaxIterations));
+    out.pod(static_cast<int32_t>(progress.budget.vnsMaxIterations));
+    out.pod(static_cast<uint8_t>(progress.portfolio ? 1 : 0));
+
+    out.pod(static_cast<uint8_t>(incumbent ? 1 : 0));
+    if (incumbent) writeBag(out, *incumbent, packageIndex);
+
+    out.varint(resultBags.size());
+    for (const auto& bag : resultBags) writeBag(out, *bag, packageIndex);
+    return out.take();
+}
+
+RunState load(const std::string& filename,
+              const std::vector<Package*>& allPackages,
+              const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+        throw std::runtime_error("Error: Could not open checkpoint file " + filename);
+    const std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    Reader in(bytes);
+    for (char c : MAGIC) {
+        if (in.pod<char>() != c) throw std::runtime_error("Error: Not a checkpoint file: " + filename);
+    }
+    if (in.pod<uint32_t>() != FORMAT_VERSION)
+        throw std::runtime_error("Error: Unsupported checkpoint version in " + filename);
+
+    RunState state;
+    RunProgress& progress = state.progress;
+    progress.instanceFingerprint = in.pod<uint64_t>();
+    progress.seed = in.pod<uint32_t>();
+    progress.completedStages = in.pod<int32_t>();
+    progress.elapsedSeconds = in.pod<double>();
+    progress.generatorState = in.string();
+
+    progress.budget.threads = in.pod<uint32_t>();
+    progress.budget.graspIterations = in.pod<int32_t>();
+    progress.budget.lsIterationsWithoutImprovement = in.pod<int32_t>();
+    progress.budget.lsMaxIterations = in.pod<int32_t>();
+    progress.budget.vnsMaxIterations = in.pod<int32_t>();
+    progress.portfolio = in.pod<uint8_t>() != 0;
+
+    if (in.pod<uint8_t>()) state.incumbent = readBag(in, allPackages, dependencyGraph);
+
+    const uint64_t bagCount = in.varint();
+    for (uint64_t i = 0; i < bagCount; ++i)
+        state.resultBags.push_back(readBag(in, allPackages, dependencyGraph));
+    return state;
+}
+
+// =====================================================================================
+// AsyncWriter
+// =====================================================================================
+AsyncWriter::AsyncWriter(const std::string& filename)
+    : m_filename(filename), m_thread(&AsyncWriter::writerLoop, this)
+{
+}
+
+AsyncWriter::~AsyncWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void AsyncWriter::submit(std::string bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.swap(bytes);
+        m_hasPending = true;
+    }
+    m_cv.notify_all();
+}
+
+void AsyncWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return !m_hasPending && !m_writing; });
+}
+
+void AsyncWriter::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_cv.wait(lock, [this] { return m_stop || m_hasPending; });
+        if (!m_hasPending && m_stop) break;
+
+        std::string bytes;
+        bytes.swap(m_pending);
+        m_hasPending = false;
+        m_writing = true;
+        lock.unlock();
+
+        // Write next to the target and rename, so readers never see a partial file.
+        const std::string temporary = m_filename + ".tmp";
+        bool written;
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+            out.close();
+            written = !out.fail();
+        }
+        std::error_code ec;
+        if (!written) {
+            // A partial file must not replace the last good checkpoint.
+            LOG_CRITICAL("[CHECKPOINT] Could not write " << temporary << "; keeping the previous checkpoint");
+            std::filesystem::remove(temporary, ec);
+        } else {
+            std::filesystem::rename(temporary, m_filename, ec);
+            if (ec) LOG_CRITICAL("[CHECKPOINT] Could not replace " << m_filename << " (" << ec.message() << ")");
+        }
+
+        lock.lock();
+        m_writing = false;
+        m_cv.notify_all();
+    }
+}
+
+} // namespace CHECKPOINT
@@ -0,0 +1,119 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "calibration.h"
+
+class Bag;
+class Package;
+class Dependency;
+struct ProblemInstance;
+
+/**
+ * @brief Binary checkpoints of Algorithm::run, so long solves survive a restart.
+ *
+ * Algorithm::run executes a fixed sequence of stages (constructive phase, VND,
+ * VNS, then GRASP and GRASP_VNS per movement). After each stage it snapshots:
+ *  - the number of completed stages and the time they consumed,
+ *  - the state of the run's random generator,
+ *  - the calibrated search budget,
+ *  - the incumbent and every result bag produced so far (the elite set).
+ *
+ * Bags are stored as delta-encoded varint package indices, so a checkpoint is
+ * a few bytes per selected package. A resumed run restores the bags, skips the
+ * completed stages and continues with exactly the generator state the
+ * uninterrupted run would have had.
+ *
+ * Files are written by a background thread (AsyncWriter) to a temporary file
+ * and renamed into place, so a crash mid-write keeps the previous checkpoint.
+ */
+namespace CHECKPOINT {
+
+/**
+ * @brief Scalar progress of a run between two stages of Algorithm::run.
+ */
+struct RunProgress {
+    unsigned long long instanceFingerprint = 0;
+    unsigned int seed = 0;
+    int completedStages = 0;
+    double elapsedSeconds = 0.0;          ///< Wall time of the completed stages, across sessions.
+    std::string generatorState;           ///< std::mt19937 state as written by operator<<.
+    CALIBRATION::SearchBudget budget;
+    bool portfolio = false;               ///< Improvement stages ran as one portfolio (other stage list).
+};
+
+/**
+ * @brief A loaded checkpoint: progress plus the bags rebuilt against the instance.
+ */
+struct RunState {
+    RunProgress progress;
+    std::unique_ptr<Bag> incumbent;
+    std::vector<std::unique_ptr<Bag>> resultBags;
+};
+
+/**
+ * @brief Hashes the instance (capacity, package names and benefits, dependency names and sizes).
+ *
+ * Used to refuse resuming a checkpoint taken on a different instance.
+ */
+unsigned long long fingerprint(const ProblemInstance& problemInstance);
+
+/**
+ * @brief Serializes run progress, incumbent and result bags into the compact binary format.
+ */
+std::string serialize(const RunProgress& progress, const Bag* incumbent,
+                      const std::vector<std::unique_ptr<Bag>>& resultBags,
+                      const std::vector<Package*>& allPackages);
+
+/**
+ * @brief Parses a checkpoint file; bags are rebuilt against the given packages.
+ * @throws std::runtime_error if the file cannot be read or is malformed.
+ */
+RunState load(const std::string& filename,
+              const std::vector<Package*>& allPackages,
+              const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph);
+
+/**
+ * @brief Writes checkpoints on a background thread.
+ *
+ * submit() only swaps the serialized bytes into a pending slot; when the
+ * writer is still busy, a newer checkpoint replaces the pending one.
+ */
+class AsyncWriter {
+public:
+    explicit AsyncWriter(const std::string& filename);
+    ~AsyncWriter();
+
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    void submit(std::string bytes);
+
+    /**
+     * @brief Waits until the latest submitted checkpoint is on disk.
+     */
+    void flush();
+
+private:
+    void writerLoop();
+
+    std::string m_filename;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::string m_pending;
+    bool m_hasPending = false;
+    bool m_writing = false;
+    bool m_stop = false;
+    std::thread m_thread;
+};
+
+} // namespace CHECKPOINT
+
+#endif // CHECKPOINT_H
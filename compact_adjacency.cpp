@@ -0,0 +1,150 @@
+#include "compact_adjacency.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+namespace ADJACENCY {
+
+// =====================================================================================
+// IdArray
+// =====================================================================================
+IdArray::IdArray(size_t count, uint32_t maxValue)
+    : m_count(count), m_wide(maxValue > UINT16_MAX)
+{
+    if (m_wide) m_wideIds.assign(count, 0);
+    else m_narrow.assign(count, 0);
+}
+
+uint32_t IdArray::get(size_t index) const
+{
+    return m_wide ? m_wideIds[index] : m_narrow[index];
+}
+
+void IdArray::set(size_t index, uint32_t value)
+{
+    if (m_wide) m_wideIds[index] = value;
+    else m_narrow[index] = static_cast<uint16_t>(value);
+}
+
+size_t IdArray::memoryBytes() const
+{
+    return m_narrow.capacity() * sizeof(uint16_t) + m_wideIds.capacity() * sizeof(uint32_t);
+}
+
+// =====================================================================================
+// SetTable
+// =====================================================================================
+namespace {
+
+void encode(uint32_t value, std::string& out)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+} // namespace
+
+uint32_t SetTable::decode(const uint8_t*& it)
+{
+    uint32_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        const uint8_t byte = *it++;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+}
+
+SetTable SetTable::build(size_t ownerCount, const std::vector<std::pair<uint32_t, uint32_t>>& sortedLinks)
+{
+    SetTable table;
+    std::vector<uint32_t> ownerSet(ownerCount, 0);
+    std::unordered_map<std::string, uint32_t> setIds;  // encoded set -> id, only while building
+    std::string encoded;
+
+    auto addSet = [&](const std::string& bytes, uint32_t degree) {
+        auto [it, inserted] = setIds.emplace(bytes, static_cast<uint32_t>(table.m_degrees.size()));
+        if (inserted) {
+            table.m_offsets.push_back(static_cast<uint32_t>(table.m_bytes.size()));
+            table.m_bytes.insert(table.m_bytes.end(), bytes.begin(), bytes.end());
+            table.m_degrees.push_back(degree);
+        }
+        return it->second;
+    };
+
+    // The empty set is id 0, so owners without links need no entry.
+    addSet(std::string(), 0);
+
+    size_t i = 0;
+    while (i < sortedLinks.size()) {
+        const uint32_t owner = sortedLinks[i].first;
+        encoded.clear();
+        uint32_t previous = 0;
+        uint32_t degree = 0;
+        for (; i < sortedLinks.size() && sortedLinks[i].first == owner; ++i, ++degree) {
+            encode(sortedLinks[i].second - previous, encoded);
+            previous = sortedLinks[i].second;
+        }
+        ownerSet[owner] = addSet(encoded, degree);
+    }
+    if (table.m_bytes.size() > UINT32_MAX) throw std::length_error("Error: Adjacency exceeds 4 GB");
+    table.m_offsets.push_back(static_cast<uint32_t>(table.m_bytes.size()));
+
+    table.m_ownerSet = IdArray(ownerCount, static_cast<uint32_t>(std::max(ownerCount, table.m_degrees.size())));
+    for (size_t owner = 0; owner < ownerCount; ++owner) table.m_ownerSet.set(owner, ownerSet[owner]);
+
+    table.m_offsets.shrink_to_fit();
+    table.m_degrees.shrink_to_fit();
+    table.m_bytes.shrink_to_fit();
+    return table;
+}
+
+size_t SetTable::memoryBytes() const
+{
+    return m_ownerSet.memoryBytes() + m_offsets.capacity() * sizeof(uint32_t) +
+           m_degrees.capacity() * sizeof(uint32_t) + m_bytes.capacity();
+}
+
+// =====================================================================================
+// CompactAdjacency
+// =====================================================================================
+CompactAdjacency CompactAdjacency::build(size_t packageCount, size_t dependencyCount,
+                                         std::vector<std::pair<uint32_t, uint32_t>> links)
+{
+    for (const auto& [package, dependency] : links) {
+        if (package >= packageCount || dependency >= dependencyCount)
+            throw std::invalid_argument("Error: Link (" + std::to_string(package) + ", " +
+                                        std::to_string(dependency) + ") is out of range");
+    }
+
+    CompactAdjacency adjacency;
+    adjacency.m_packageCount = packageCount;
+    adjacency.m_dependencyCount = dependencyCount;
+
+    std::sort(links.begin(), links.end());
+    links.erase(std::unique(links.begin(), links.end()), links.end());
+    adjacency.m_linkCount = links.size();
+    adjacency.m_dependenciesOf = SetTable::build(packageCount, links);
+
+    // Reverse the links in place for the other direction.
+    for (auto& link : links) std::swap(link.first, link.second);
+    std::sort(links.begin(), links.end());
+    adjacency.m_packagesOf = SetTable::build(dependencyCount, links);
+    return adjacency;
+}
+
+size_t CompactAdjacency::memoryBytes() const
+{
+    return m_dependenciesOf.memoryBytes() + m_packagesOf.memoryBytes();
+}
+
+size_t CompactProblem::memoryBytes() const
+{
+    return benefits.capacity() * sizeof(int) + sizes.capacity() * sizeof(int) + adjacency.memoryBytes();
+}
+
+} // namespace ADJACENCY
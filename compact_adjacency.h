@@ -0,0 +1,151 @@
+#ifndef COMPACT_ADJACENCY_H
+#define COMPACT_ADJACENCY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Compact package/dependency links for very large instances.
+ *
+ * The object model keeps every link four times: a string-keyed map entry
+ * and a pointer on both sides, plus the solver's dependency graph. Here
+ * packages and dependencies are plain indices and:
+ *  - each direction stores every distinct neighbor set once; packages with
+ *    identical dependencies (and dependencies with identical packages) share it;
+ *  - a set is its sorted ids, delta-encoded as LEB128 varints, so dense
+ *    neighborhoods cost about one byte per link;
+ *  - the tables mapping an index to its set use 16-bit ids when the instance
+ *    is small enough, 32-bit ones otherwise.
+ *
+ * Only solution validation reads instances this way (see
+ * FILE_PROCESSOR::loadCompactProblem); the solver keeps the object model.
+ */
+namespace ADJACENCY {
+
+/**
+ * @brief Array of ids stored with 2 or 4 bytes each, chosen when it is built.
+ */
+class IdArray {
+public:
+    IdArray() = default;
+
+    /**
+     * @brief Creates count zero ids wide enough to hold maxValue.
+     */
+    IdArray(size_t count, uint32_t maxValue);
+
+    uint32_t get(size_t index) const;
+    void set(size_t index, uint32_t value);
+
+    size_t size() const { return m_count; }
+    int bytesPerId() const { return m_wide ? 4 : 2; }
+    size_t memoryBytes() const;
+
+private:
+    size_t m_count = 0;
+    bool m_wide = false;
+    std::vector<uint16_t> m_narrow;
+    std::vector<uint32_t> m_wideIds;
+};
+
+/**
+ * @brief Deduplicated, delta-encoded neighbor sets of one direction.
+ */
+class SetTable {
+public:
+    /**
+     * @brief Builds the table from links sorted by (owner, neighbor) without duplicates.
+     *
+     * @param ownerCount Number of owners (indices 0 .. ownerCount - 1).
+     */
+    static SetTable build(size_t ownerCount, const std::vector<std::pair<uint32_t, uint32_t>>& sortedLinks);
+
+    /**
+     * @brief Calls fn(neighbor) for every neighbor of owner, in ascending order.
+     */
+    template <typename Fn>
+    void forEach(size_t owner, Fn&& fn) const {
+        const uint32_t set = m_ownerSet.get(owner);
+        const uint8_t* it = m_bytes.data() + m_offsets[set];
+        const uint8_t* end = m_bytes.data() + m_offsets[set + 1];
+        uint32_t id = 0;
+        while (it < end) {
+            id += decode(it);
+            fn(id);
+        }
+    }
+
+    uint32_t degree(size_t owner) const { return m_degrees[m_ownerSet.get(owner)]; }
+    size_t distinctSets() const { return m_degrees.size(); }
+    int bytesPerId() const { return m_ownerSet.bytesPerId(); }
+    size_t memoryBytes() const;
+
+private:
+    static uint32_t decode(const uint8_t*& it);
+
+    IdArray m_ownerSet;               ///< Owner index -> set id.
+    std::vector<uint32_t> m_offsets;  ///< Set id -> first byte (one past the end for the last set).
+    std::vector<uint32_t> m_degrees;  ///< Set id -> number of neighbors.
+    std::vector<uint8_t> m_bytes;     ///< Concatenated encoded sets.
+};
+
+/**
+ * @brief Links of an instance in both directions.
+ */
+class CompactAdjacency {
+public:
+    CompactAdjacency() = default;
+
+    /**
+     * @brief Builds both directions from (package, dependency) links.
+     *
+     * Duplicate links are kept once, as the object model does.
+     *
+     * @throws std::invalid_argument if a link is out of range.
+     */
+    static CompactAdjacency build(size_t packageCount, size_t dependencyCount,
+                                  std::vector<std::pair<uint32_t, uint32_t>> links);
+
+    template <typename Fn>
+    void forEachDependency(size_t package, Fn&& fn) const { m_dependenciesOf.forEach(package, fn); }
+
+    template <typename Fn>
+    void forEachPackage(size_t dependency, Fn&& fn) const { m_packagesOf.forEach(dependency, fn); }
+
+    uint32_t dependencyCount(size_t package) const { return m_dependenciesOf.degree(package); }
+    uint32_t packageCount(size_t dependency) const { return m_packagesOf.degree(dependency); }
+
+    size_t packages() const { return m_packageCount; }
+    size_t dependencies() const { return m_dependencyCount; }
+    size_t links() const { return m_linkCount; }
+
+    /// Distinct dependency sets, shared by packages that require the same dependencies.
+    size_t distinctDependencySets() const { return m_dependenciesOf.distinctSets(); }
+    int bytesPerId() const { return m_dependenciesOf.bytesPerId(); }
+    size_t memoryBytes() const;
+
+private:
+    size_t m_packageCount = 0;
+    size_t m_dependencyCount = 0;
+    size_t m_linkCount = 0;
+    SetTable m_dependenciesOf;  ///< Package -> dependencies.
+    SetTable m_packagesOf;      ///< Dependency -> packages.
+};
+
+/**
+ * @brief An instance without the object model: benefits, sizes and compact links.
+ */
+struct CompactProblem {
+    int maxCapacity = 0;
+    std::vector<int> benefits;  ///< Per package.
+    std::vector<int> sizes;     ///< Per dependency.
+    CompactAdjacency adjacency;
+
+    size_t memoryBytes() const;
+};
+
+} // namespace ADJACENCY
+
+#endif // COMPACT_ADJACENCY_H
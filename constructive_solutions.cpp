@@ -2,12 +2,20 @@
 
 #include <chrono>
 #include <algorithm>
+#include <functional>
+#include <limits>
 #include <memory>
-#include <unordered_set> // Include for unordered_set
+#include <queue>
+#include <utility>
 
+#include "perf_counters.h"
 #include "random_provider.h"
+#include "trace.h"
 #include "solution_repair.h"
 
+// The deadline is read once per this many picks; a pick is a few nanoseconds.
+static constexpr int DEADLINE_CHECK_INTERVAL = 64;
+
 ConstructiveSolutions::ConstructiveSolutions(double maxTime, std::mt19937& generator,
                               std::unordered_map<const Package*, std::vector<const Dependency*>>& depGraph,
                               const std::string& timestamp)
@@ -18,11 +26,10 @@ ConstructiveSolutions::ConstructiveSolutions(double maxTime, std::mt19937& gener
 // Return std::unique_ptr<Bag>
 std::unique_ptr<Bag> ConstructiveSolutions::randomBag(int bagSize, const std::vector<Package *> &packages)
 {
-    auto mutablePackages = packages;
-    auto pickStrategy = [&](std::vector<Package*>& pkgs) {
-        return this->pickRandomPackage(pkgs);
+    auto pickStrategy = [this](Candidates& candidates) {
+        return this->pickRandomPackage(candidates);
     };
-    return fillBagWithStrategy(bagSize, mutablePackages, pickStrategy, ALGORITHM::ALGORITHM_TYPE::RANDOM);
+    return fillBagWithStrategy(bagSize, packages, pickStrategy, ALGORITHM::ALGORITHM_TYPE::RANDOM);
 }
 
 // Return std::vector<std::unique_ptr<Bag>>
@@ -30,20 +37,20 @@ std::vector<std::unique_ptr<Bag>> ConstructiveSolutions::greedyBag(int bagSize,
 {
     // Vector now holds unique_ptrs
     std::vector<std::unique_ptr<Bag>> bags;
-    bags.reserve(3);
+    bags.reserve(Algorithm::CONSTRUCTIVE_SORT_ORDERS);
     
     std::vector<Package *> sortedByBenefit = sortedPackagesByBenefit(packages);
     std::vector<Package *> sortedByRatio = sortedPackagesByBenefitToSizeRatio(packages);
     std::vector<Package *> sortedBySize = sortedPackagesBySize(packages);
 
-    auto pickStrategy = [&](std::vector<Package*>& pkgs) {
-        return this->pickTopPackage(pkgs);
+    auto pickStrategy = [this](Candidates& candidates) {
+        return this->pickTopPackage(candidates);
     };
 
     // fillBagWithStrategy returns a unique_ptr, which is moved into the vector
-    bags.push_back(fillBagWithStrategy(bagSize, sortedByBenefit, pickStrategy, ALGORITHM::ALGORITHM_TYPE::GREEDY_PACKAGE_BENEFIT));
-    bags.push_back(fillBagWithStrategy(bagSize, sortedByRatio, pickStrategy, ALGORITHM::ALGORITHM_TYPE::GREEDY_PACKAGE_BENEFIT_RATIO));
-    bags.push_back(fillBagWithStrategy(bagSize, sortedBySize, pickStrategy, ALGORITHM::ALGORITHM_TYPE::GREEDY_PACKAGE_SIZE));
+    bags.push_back(fillBagWithStrategy(bagSize, std::move(sortedByBenefit), pickStrategy, ALGORITHM::ALGORITHM_TYPE::GREEDY_PACKAGE_BENEFIT));
+    bags.push_back(fillBagWithStrategy(bagSize, std::move(sortedByRatio), pickStrategy, ALGORITHM::ALGORITHM_TYPE::GREEDY_PACKAGE_BENEFIT_RATIO));
+    bags.push_back(fillBagWithStrategy(bagSize, std::move(sortedBySize), pickStrategy, ALGORITHM::ALGORITHM_TYPE::GREEDY_PACKAGE_SIZE));
     return bags;
 }
 
@@ -52,105 +59,225 @@ std::vector<std::unique_ptr<Bag>> ConstructiveSolutions::randomGreedy(int bagSiz
 {
     // Vector now holds unique_ptrs
     std::vector<std::unique_ptr<Bag>> bags;
-    bags.reserve(3);
+    bags.reserve(Algorithm::CONSTRUCTIVE_SORT_ORDERS);
     
     std::vector<Package *> sortedByBenefit = sortedPackagesByBenefit(packages);
     std::vector<Package *> sortedByRatio = sortedPackagesByBenefitToSizeRatio(packages);
     std::vector<Package *> sortedBySize = sortedPackagesBySize(packages);
 
-    auto pickStrategy = [&](std::vector<Package*>& pkgs) {
+    auto pickStrategy = [this](Candidates& candidates) {
         const int candidatePoolSize = 10;
-        return this->pickSemiRandomPackage(pkgs, candidatePoolSize);
+        return this->pickSemiRandomPackage(candidates, candidatePoolSize);
     };
 
     // fillBagWithStrategy returns a unique_ptr, which is moved into the vector
-    bags.push_back(fillBagWithStrategy(bagSize, sortedByBenefit, pickStrategy, ALGORITHM::ALGORITHM_TYPE::GREEDY_PACKAGE_BENEFIT));
-    bags.push_back(fillBagWithStrategy(bagSize, sortedByRatio, pickStrategy, ALGORITHM::ALGORITHM_TYPE::GREEDY_PACKAGE_BENEFIT_RATIO));
-    bags.push_back(fillBagWithStrategy(bagSize, sortedBySize, pickStrategy, ALGORITHM::ALGORITHM_TYPE::RANDOM_GREEDY_PACKAGE_SIZE));
+    bags.push_back(fillBagWithStrategy(bagSize, std::move(sortedByBenefit), pickStrategy, ALGORITHM::ALGORITHM_TYPE::GREEDY_PACKAGE_BENEFIT));
+    bags.push_back(fillBagWithStrategy(bagSize, std::move(sortedByRatio), pickStrategy, ALGORITHM::ALGORITHM_TYPE::GREEDY_PACKAGE_BENEFIT_RATIO));
+    bags.push_back(fillBagWithStrategy(bagSize, std::move(sortedBySize), pickStrategy, ALGORITHM::ALGORITHM_TYPE::RANDOM_GREEDY_PACKAGE_SIZE));
     return bags;
 }
 
-Package* ConstructiveSolutions::pickRandomPackage(std::vector<Package*>& packageList) {
-    if (packageList.empty()) {
-        return nullptr;
+std::unique_ptr<Bag> ConstructiveSolutions::marginalGreedyBag(int bagSize, const std::vector<Package*>& packages)
+{
+    auto bag = std::make_unique<Bag>(ALGORITHM::ALGORITHM_TYPE::GREEDY_PACKAGE_MARGINAL_RATIO, m_timestamp);
+    bag->setMovementType(SEARCH_ENGINE::MovementType::NONE);
+    if (packages.empty()) return bag;
+
+    PERF_COUNTERS::ScopedContext perfContext(PERF_COUNTERS::currentProfile(), bag->getBagAlgorithm());
+    PERF_COUNTERS::ScopedSample perfSample(SEARCH_ENGINE::MovementType::NONE);
+    TRACE::ScopedEvent trace("construct", "marginalGreedy");
+
+    auto start_time = std::chrono::steady_clock::now();
+    auto deadline = start_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                     std::chrono::duration<double>(m_maxTime));
+
+    // Dense dependency ids and the dependency -> package reverse index.
+    const int packageCount = static_cast<int>(packages.size());
+    std::unordered_map<const Dependency*, int> dependencyIds;
+    std::vector<const Dependency*> dependencies;
+    std::vector<std::vector<int>> packagesOfDependency;
+    std::vector<int> missingSize(packageCount, 0);
+    for (int i = 0; i < packageCount; ++i) {
+        for (const Dependency* dependency : m_dependencyGraph.at(packages[i])) {
+            auto [it, inserted] = dependencyIds.try_emplace(dependency, static_cast<int>(dependencies.size()));
+            if (inserted) {
+                dependencies.push_back(dependency);
+                packagesOfDependency.emplace_back();
+            }
+            packagesOfDependency[it->second].push_back(i);
+            missingSize[i] += dependency->getSize();
+        }
     }
-    // Note: RANDOM_PROVIDER::getInt is inclusive, so (0, size - 1) is correct
-    int index = RANDOM_PROVIDER::getInt(0, packageList.size() - 1, m_generator);
-    Package* pickedPackage = packageList[index];
-    packageList.erase(packageList.begin() + index);
-    return pickedPackage;
+    std::vector<char> dependencyInBag(dependencies.size(), 0);
+
+    // Heap entries carry the package's version when pushed; older versions are stale.
+    struct Entry {
+        double ratio;
+        int benefit;
+        int package;
+        int version;
+        bool operator<(const Entry& other) const {
+            if (ratio != other.ratio) return ratio < other.ratio;
+            if (benefit != other.benefit) return benefit < other.benefit;
+            return package > other.package;
+        }
+    };
+    auto entryFor = [&](int i, int version) {
+        const int benefit = packages[i]->getBenefit();
+        const double ratio = missingSize[i] > 0 ? static_cast<double>(benefit) / missingSize[i]
+                                                : std::numeric_limits<double>::infinity();
+        return Entry{ratio, benefit, i, version};
+    };
+
+    std::vector<int> version(packageCount, 0);
+    std::vector<char> inBag(packageCount, 0);
+    std::vector<Entry> heapStorage;
+    heapStorage.reserve(packageCount);
+    for (int i = 0; i < packageCount; ++i) {
+        if (packages[i]->getBenefit() > 0) heapStorage.push_back(entryFor(i, 0));
+    }
+    std::priority_queue<Entry> heap(std::less<Entry>(), std::move(heapStorage));
+
+    for (int pops = 0; !heap.empty(); ++pops) {
+        if (pops % DEADLINE_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline)
+            break;
+
+        const Entry entry = heap.top();
+        heap.pop();
+        const int i = entry.package;
+        if (inBag[i] || entry.version != version[i]) continue;
+
+        // Too big for now; it is pushed again if one of its dependencies gets in.
+        if (bag->getSize() + missingSize[i] > bagSize) continue;
+        if (!bag->addPackageIfPossible(*packages[i], bagSize, m_dependencyGraph.at(packages[i]))) continue;
+        inBag[i] = 1;
+
+        for (const Dependency* dependency : m_dependencyGraph.at(packages[i])) {
+            const int d = dependencyIds.at(dependency);
+            if (dependencyInBag[d]) continue;
+            dependencyInBag[d] = 1;
+            for (int j : packagesOfDependency[d]) {
+                missingSize[j] -= dependency->getSize();
+                if (inBag[j] || packages[j]->getBenefit() <= 0) continue;
+                heap.push(entryFor(j, ++version[j]));
+            }
+        }
+    }
+
+    auto end_time = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed_seconds = end_time - start_time;
+    bag->setAlgorithmTime(elapsed_seconds.count());
+    return bag;
 }
 
-Package* ConstructiveSolutions::pickTopPackage(std::vector<Package*>& packageList) {
-    if (packageList.empty()) {
+// =====================================================================================
+// Pick Strategies
+// =====================================================================================
+Package* ConstructiveSolutions::Candidates::take(size_t offset)
+{
+    std::swap(items[next], items[next + offset]);
+    return items[next++];
+}
+
+Package* ConstructiveSolutions::pickRandomPackage(Candidates& candidates) {
+    if (candidates.remaining() == 0) {
         return nullptr;
     }
-    Package* pickedPackage = packageList.front();
-    packageList.erase(packageList.begin());
-    return pickedPackage;
+    // Note: RANDOM_PROVIDER::getInt is inclusive, so (0, size - 1) is correct
+    int index = RANDOM_PROVIDER::getInt(0, static_cast<int>(candidates.remaining()) - 1, m_generator);
+    return candidates.take(index);
 }
 
-// Removed default argument 'poolSize = 10' as it's already in the header
-Package* ConstructiveSolutions::pickSemiRandomPackage(std::vector<Package*>& packageList, int poolSize) {
-    if (packageList.empty()) {
+Package* ConstructiveSolutions::pickTopPackage(Candidates& candidates) {
+    if (candidates.remaining() == 0) {
         return nullptr;
     }
-    int candidatePoolSize = std::min(poolSize, static_cast<int>(packageList.size()));
+    return candidates.take(0);
+}
+
+// The pool is the first poolSize remaining packages; take() leaves every package
+// beyond the pool in sorted order, so the next pool is the same as after an erase.
+Package* ConstructiveSolutions::pickSemiRandomPackage(Candidates& candidates, int poolSize) {
+    int candidatePoolSize = std::min(poolSize, static_cast<int>(candidates.remaining()));
     // Handle edge case where candidatePoolSize could be 0 if poolSize is <= 0
     if (candidatePoolSize <= 0) {
         return nullptr;
     }
     int index = RANDOM_PROVIDER::getInt(0, candidatePoolSize - 1, m_generator);
-    Package* pickedPackage = packageList[index];
-    packageList.erase(packageList.begin() + index);
-    return pickedPackage;
+    return candidates.take(index);
 }
 
-std::vector<Package *> ConstructiveSolutions::sortedPackagesByBenefit(const std::vector<Package *> &packages)
+// =====================================================================================
+// Sort Orders
+// =====================================================================================
+namespace {
+
+/**
+ * @brief Sorts packages by a key computed once per package rather than once per comparison.
+ *
+ * The sort is stable, so equal keys keep the instance order on every platform.
+ */
+template <typename KeyFunction, typename Compare>
+std::vector<Package*> sortedByKey(const std::vector<Package*>& packages, KeyFunction key, Compare compare)
 {
-    auto sortedList = packages;
-    std::sort(sortedList.begin(), sortedList.end(), [](const Package* a, const Package* b) {
-        return a->getBenefit() > b->getBenefit();
+    std::vector<std::pair<double, Package*>> keyed;
+    keyed.reserve(packages.size());
+    for (Package* package : packages) keyed.emplace_back(key(*package), package);
+
+    std::stable_sort(keyed.begin(), keyed.end(), [&](const auto& a, const auto& b) {
+        return compare(a.first, b.first);
     });
+
+    std::vector<Package*> sortedList;
+    sortedList.reserve(keyed.size());
+    for (const auto& entry : keyed) sortedList.push_back(entry.second);
     return sortedList;
 }
 
+} // namespace
+
+std::vector<Package *> ConstructiveSolutions::sortedPackagesByBenefit(const std::vector<Package *> &packages)
+{
+    return sortedByKey(packages, [](const Package& p) {
+        return static_cast<double>(p.getBenefit());
+    }, std::greater<double>());
+}
+
 std::vector<Package*> ConstructiveSolutions::sortedPackagesByBenefitToSizeRatio(const std::vector<Package*>& packages) {
-    auto sortedList = packages;
-    std::sort(sortedList.begin(), sortedList.end(), [](const Package* a, const Package* b) {
-        double ratio_a = (a->getDependenciesSize() > 0) ? static_cast<double>(a->getBenefit()) / a->getDependenciesSize() : a->getBenefit();
-        double ratio_b = (b->getDependenciesSize() > 0) ? static_cast<double>(b->getBenefit()) / b->getDependenciesSize() : b->getBenefit();
-        return ratio_a > ratio_b;
-    });
-    return sortedList;
+    return sortedByKey(packages, [](const Package& p) {
+        const int size = p.getDependenciesSize();
+        return (size > 0) ? static_cast<double>(p.getBenefit()) / size : static_cast<double>(p.getBenefit());
+    }, std::greater<double>());
 }
 
 std::vector<Package*> ConstructiveSolutions::sortedPackagesBySize(const std::vector<Package*>& packages) {
-    auto sortedList = packages;
-    std::sort(sortedList.begin(), sortedList.end(), [](const Package* a, const Package* b) {
-        return a->getDependenciesSize() < b->getDependenciesSize();
-    });
-    return sortedList;
+    return sortedByKey(packages, [](const Package& p) {
+        return static_cast<double>(p.getDependenciesSize());
+    }, std::less<double>());
 }
 
+// =====================================================================================
+// Fill
+// =====================================================================================
+template <typename PickStrategy>
 std::unique_ptr<Bag> ConstructiveSolutions::fillBagWithStrategy(
     int bagSize,
-    std::vector<Package*>& packages,
-    std::function<Package*(std::vector<Package*>&)> pickStrategy,
+    std::vector<Package*> packages,
+    PickStrategy&& pickStrategy,
     ALGORITHM::ALGORITHM_TYPE type
 ) {
     auto bag = std::make_unique<Bag>(type, m_timestamp);
     bag->setMovementType(SEARCH_ENGINE::MovementType::NONE);
     if (packages.empty()) return bag;
 
+    PERF_COUNTERS::ScopedContext perfContext(PERF_COUNTERS::currentProfile(), type);
+    PERF_COUNTERS::ScopedSample perfSample(SEARCH_ENGINE::MovementType::NONE);
+    TRACE::ScopedEvent trace("construct", "constructive");
+
     // Thread-safe RNG initialization
     unsigned int localSeed = static_cast<unsigned int>(m_generator());
     SearchEngine searchEngine(localSeed);
 
-    // Caches
-    std::unordered_map<const Package*, bool> compatibilityCache;
-    std::unordered_set<const Package*> inBagCache;
-
     // Timing
     auto start_time = std::chrono::steady_clock::now();
     auto total_duration = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::duration<double>(m_maxTime));
@@ -166,15 +293,19 @@ std::unique_ptr<Bag> ConstructiveSolutions::fillBagWithStrategy(
     auto local2_deadline       = local1_deadline + std::chrono::duration_cast<std::chrono::steady_clock::duration>(total_duration * local2_fraction);
 
     // --- Constructive phase ---
-    while (!packages.empty()) {
-        if (std::chrono::steady_clock::now() >= constructive_deadline)
+    // Each package is picked at most once, so a failed add is never retried.
+    Candidates candidates{std::move(packages)};
+    for (int picks = 0; candidates.remaining() > 0; ++picks) {
+        if (picks % DEADLINE_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= constructive_deadline)
             break;
 
-        Package* packageToAdd = pickStrategy(packages);
+        Package* packageToAdd = pickStrategy(candidates);
         if (!packageToAdd) break;
 
-        canPackageBeAdded(*bag, *packageToAdd, bagSize, compatibilityCache, inBagCache);
+        bag->addPackageIfPossible(*packageToAdd, bagSize, m_dependencyGraph.at(packageToAdd));
     }
+    // The local searches work on the packages the constructive phase did not reach.
+    packages.assign(candidates.items.begin() + candidates.next, candidates.items.end());
 
     // --- Local search phase 1 ---
     searchEngine.localSearch(
@@ -212,26 +343,3 @@ std::unique_ptr<Bag> ConstructiveSolutions::fillBagWithStrategy(
 
     return bag;
 }
-
-bool ConstructiveSolutions::canPackageBeAdded(Bag& bag, const Package& package, int maxCapacity,
-                                  std::unordered_map<const Package*, bool>& cache,
-                                  std::unordered_set<const Package*>& inBagCache) {
-    
-    if (inBagCache.count(&package)) {
-        return false;
-    }
-    
-    auto it = cache.find(&package);
-    if (it != cache.end()) {
-        return it->second;
-    }
-    const auto& deps = m_dependencyGraph.at(&package);
-    bool result = bag.addPackageIfPossible(package, maxCapacity, deps);
-    cache[&package] = result;
-    
-    if (result) {
-        inBagCache.insert(&package);
-    }
-    
-    return result;
-}
\ No newline at end of file
@@ -2,11 +2,9 @@
 #define CONSTRUCTIVE_SOLUTIONS_H
 
 #include <vector>
-#include <functional>
 #include <random>
 #include <unordered_map>
 #include <memory>
-#include <unordered_set> // Include for unordered_set
 
 #include "bag.h"
 #include "package.h"
@@ -23,25 +21,45 @@ public:
     std::vector<std::unique_ptr<Bag>> greedyBag(int bagSize, const std::vector<Package*>& packages);
     std::vector<std::unique_ptr<Bag>> randomGreedy(int bagSize, const std::vector<Package*>& packages);
 
+    /**
+     * @brief Greedy by current marginal ratio: benefit over the size of the dependencies not yet in the bag.
+     *
+     * Scores live in a lazy max-heap. Adding a package re-scores only the packages
+     * sharing one of its new dependencies (found through a dependency -> package
+     * index), so construction costs O(L log L) for L package-dependency links.
+     */
+    std::unique_ptr<Bag> marginalGreedyBag(int bagSize, const std::vector<Package*>& packages);
+
 private:
-    Package* pickRandomPackage(std::vector<Package*>& packageList);
-    Package* pickTopPackage(std::vector<Package*>& packageList);
-    Package* pickSemiRandomPackage(std::vector<Package*>& packageList, int poolSize = 10);
+    /**
+     * @brief Packages not picked yet: items[next..end).
+     *
+     * take() swaps the chosen package into items[next] and advances next, so a
+     * pick is O(1) instead of a vector erase. Packages past the chosen offset
+     * keep their order, which is all the greedy and pool picks rely on.
+     */
+    struct Candidates {
+        std::vector<Package*> items;
+        size_t next = 0;
+
+        [[nodiscard]] size_t remaining() const { return items.size() - next; }
+        Package* take(size_t offset);
+    };
 
-    // Return std::unique_ptr
-    std::unique_ptr<Bag> fillBagWithStrategy(int bagSize, std::vector<Package*>& packages,
-                                 std::function<Package*(std::vector<Package*>&)> pickStrategy,
-                                 ALGORITHM::ALGORITHM_TYPE type);
+    Package* pickRandomPackage(Candidates& candidates);
+    Package* pickTopPackage(Candidates& candidates);
+    Package* pickSemiRandomPackage(Candidates& candidates, int poolSize = 10);
+
+    // The pick strategy is a template parameter so each call site inlines it.
+    template <typename PickStrategy>
+    std::unique_ptr<Bag> fillBagWithStrategy(int bagSize, std::vector<Package*> packages,
+                                             PickStrategy&& pickStrategy,
+                                             ALGORITHM::ALGORITHM_TYPE type);
 
     std::vector<Package*> sortedPackagesByBenefit(const std::vector<Package*>& packages);
     std::vector<Package*> sortedPackagesByBenefitToSizeRatio(const std::vector<Package*>& packages);
     std::vector<Package*> sortedPackagesBySize(const std::vector<Package*>& packages);
 
-    // FIX: Added inBagCache parameter
-    bool canPackageBeAdded(Bag& bag, const Package& package, int maxCapacity,
-                           std::unordered_map<const Package*, bool>& compatibilityCache,
-                           std::unordered_set<const Package*>& inBagCache);
-
     double m_maxTime;
     std::mt19937& m_generator;
     std::unordered_map<const Package*, std::vector<const Dependency*>>& m_dependencyGraph;
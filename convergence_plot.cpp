@@ -0,0 +1,78 @@
+#include "convergence_plot.h"
+
+#include <algorithm>
+
+#include <QPainter>
+#include <QPaintEvent>
+
+static constexpr int PLOT_MARGIN = 40;
+static constexpr int LEGEND_ROW_HEIGHT = 14;
+
+ConvergencePlot::ConvergencePlot(QWidget *parent)
+    : QWidget(parent)
+{
+    setMinimumSize(200, 120);
+    setAutoFillBackground(true);
+}
+
+void ConvergencePlot::addPoint(const QString& series, double seconds, int benefit)
+{
+    QVector<QPointF>& points = m_series[series];
+    if (!points.isEmpty() && benefit <= points.last().y()) return;
+
+    const bool first = m_series.size() == 1 && points.isEmpty();
+    points.append(QPointF(seconds, benefit));
+    m_maxSeconds = std::max(m_maxSeconds, seconds);
+    m_minBenefit = first ? benefit : std::min(m_minBenefit, benefit);
+    m_maxBenefit = std::max(m_maxBenefit, benefit);
+    update();
+}
+
+void ConvergencePlot::clear()
+{
+    m_series.clear();
+    m_maxSeconds = 1.0;
+    m_minBenefit = 0;
+    m_maxBenefit = 1;
+    update();
+}
+
+void ConvergencePlot::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    const QRectF area(PLOT_MARGIN, 10, width() - PLOT_MARGIN - 10, height() - PLOT_MARGIN);
+    painter.setPen(palette().color(QPalette::WindowText));
+    painter.drawRect(area);
+    painter.drawText(QRectF(0, area.bottom() + 4, width(), 16), Qt::AlignHCenter,
+                     QString("time (s) 0 - %1").arg(m_maxSeconds, 0, 'f', 1));
+    painter.drawText(QRectF(0, area.top(), PLOT_MARGIN - 4, 16), Qt::AlignRight, QString::number(m_maxBenefit));
+    painter.drawText(QRectF(0, area.bottom() - 16, PLOT_MARGIN - 4, 16), Qt::AlignRight, QString::number(m_minBenefit));
+
+    if (m_series.isEmpty()) return;
+
+    const double benefitRange = std::max(1, m_maxBenefit - m_minBenefit);
+    auto toScreen = [&](const QPointF& p) {
+        return QPointF(area.left() + area.width() * p.x() / m_maxSeconds,
+                       area.bottom() - area.height() * (p.y() - m_minBenefit) / benefitRange);
+    };
+
+    int index = 0;
+    for (auto it = m_series.cbegin(); it != m_series.cend(); ++it, ++index) {
+        const QColor color = QColor::fromHsv((index * 47) % 360, 200, 200);
+        painter.setPen(QPen(color, 1.5));
+
+        // Best-so-far is a step function: hold each value until the next improvement.
+        const QVector<QPointF>& points = it.value();
+        for (int i = 1; i < points.size(); ++i) {
+            const QPointF corner(points[i].x(), points[i - 1].y());
+            painter.drawLine(toScreen(points[i - 1]), toScreen(corner));
+            painter.drawLine(toScreen(corner), toScreen(points[i]));
+        }
+        painter.drawEllipse(toScreen(points.last()), 2, 2);
+
+        painter.drawText(QPointF(area.left() + 6, area.top() + LEGEND_ROW_HEIGHT * (index + 1)), it.key());
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef CONVERGENCE_PLOT_H
+#define CONVERGENCE_PLOT_H
+
+#include <QWidget>
+#include <QMap>
+#include <QString>
+#include <QVector>
+#include <QPointF>
+
+/**
+ * @brief Lightweight best-so-far plot: benefit over elapsed time, one step line per series.
+ *
+ * Painted with QPainter so the GUI does not need the Qt Charts module.
+ */
+class ConvergencePlot : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit ConvergencePlot(QWidget *parent = nullptr);
+
+    /**
+     * @brief Adds a point to a series; ignored unless it improves the series' best benefit.
+     */
+    void addPoint(const QString& series, double seconds, int benefit);
+
+    void clear();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QMap<QString, QVector<QPointF>> m_series;
+    double m_maxSeconds = 1.0;
+    int m_minBenefit = 0;
+    int m_maxBenefit = 1;
+};
+
+#endif // CONVERGENCE_PLOT_H
@@ -73,13 +73,15 @@ private:
 
 /**
  * @brief Holds the data parsed from a solution report file.
- * Used for solution validation.
+ * Used for solution validation and warm starts.
  */
 struct SolutionReport {
     long reportedBenefit = 0;
     long reportedWeight = 0;
     std::vector<int> packageVector;
     std::vector<int> dependencyVector;
+    int totalPackages = 0; ///< Length of the binary package vector, i.e. packages in the instance.
+    std::string inputFile; ///< "Input File:" field: instance file name, '-', execution id.
 
     /**
      * @brief Generates a string representation of the solution report.
@@ -20,6 +20,13 @@ int Dependency::getSize() const {
     return m_size;
 }
 
+void Dependency::setSize(int size) {
+    m_size = size;
+    for (auto& pair : m_associatedPackages) {
+        if (pair.second) pair.second->invalidateDependenciesSize();
+    }
+}
+
 int Dependency::getTotalBenefit() const {
     // Use std::accumulate to sum the benefits of all packages in the map.
     // The initial sum is 0. The lambda function is called for each element.
@@ -44,6 +51,10 @@ void Dependency::addAssociatedPackage(Package* package) {
     }
 }
 
+bool Dependency::removeAssociatedPackage(const Package& package) {
+    return m_associatedPackages.erase(package.getName()) > 0;
+}
+
 std::string Dependency::toString() const {
     return "Dependency(Name: '" + m_name +
            "', Size: " + std::to_string(m_size) +
@@ -37,6 +37,14 @@ public:
      */
     int getSize() const;
 
+    /**
+     * @brief Sets the size requirement, e.g. when the catalog is edited.
+     *
+     * Invalidates the cached dependency size of every associated package.
+     * @param size The new size of the dependency.
+     */
+    void setSize(int size);
+
     /**
      * @brief Calculates the total benefit of all packages associated with this dependency.
      *
@@ -74,6 +82,13 @@ public:
      */
     void addAssociatedPackage(Package* package);
 
+    /**
+     * @brief Removes a package from the associated packages.
+     * @param package The package to remove.
+     * @return true if the package was associated with this dependency.
+     */
+    bool removeAssociatedPackage(const Package& package);
+
     /**
      * @brief Creates a string representation of the Dependency object.
      *
@@ -4,6 +4,7 @@
 #include "search_engine.h"
 #include "solution_repair.h"
 #include "algorithm.h"
+#include "perf_counters.h"
 
 // Standard library headers
 #include <filesystem>
@@ -12,6 +13,7 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <charconv>
 #include <string_view>
 #include <unordered_set>
 
@@ -335,6 +337,176 @@ ProblemInstance loadProblem(const std::string& filename) {
     return problem;
 }
 
+// ----------------------
+// Compact problem loader
+// ----------------------
+namespace {
+
+/**
+ * @brief Parses the next integer of a line; returns false at the end of the line.
+ */
+bool nextInt(std::string_view& line, int& value)
+{
+    size_t start = line.find_first_not_of(" \t\r");
+    if (start == std::string_view::npos) return false;
+    auto [end, ec] = std::from_chars(line.data() + start, line.data() + line.size(), value);
+    if (ec != std::errc()) return false;
+    line.remove_prefix(static_cast<size_t>(end - line.data()));
+    return true;
+}
+
+} // namespace
+
+ADJACENCY::CompactProblem loadCompactProblem(const std::string& filename) {
+    ADJACENCY::CompactProblem problem;
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open problem file: " + filename);
+    }
+
+    // --- 1. Header: num_packages num_dependencies num_pairs max_capacity ---
+    std::string line;
+    int numPackages = 0;
+    int numDependencies = 0;
+    int numPairs = 0;
+    if (!std::getline(file, line)) {
+        throw std::runtime_error("Error: Cannot read header from file: " + filename);
+    }
+    std::string_view header(line);
+    nextInt(header, numPackages);
+    nextInt(header, numDependencies);
+    nextInt(header, numPairs);
+    nextInt(header, problem.maxCapacity);
+    if (numPackages <= 0 || numDependencies <= 0) {
+        throw std::runtime_error("Error: Invalid package or dependency count in file: " + filename);
+    }
+
+    // --- 2. Package benefits and dependency sizes ---
+    auto readValues = [&](std::vector<int>& values, int count, const char* what) {
+        if (!std::getline(file, line)) {
+            throw std::runtime_error(std::string("Error: Cannot read ") + what + " from file: " + filename);
+        }
+        values.reserve(count);
+        std::string_view rest(line);
+        int value;
+        while (static_cast<int>(values.size()) < count && nextInt(rest, value)) values.push_back(value);
+        if (static_cast<int>(values.size()) != count) {
+            throw std::runtime_error(std::string("Error: Mismatch in ") + what + " count. Expected " + std::to_string(count));
+        }
+    };
+    readValues(problem.benefits, numPackages, "package benefit");
+    readValues(problem.sizes, numDependencies, "dependency size");
+
+    // --- 3. Links ---
+    std::vector<std::pair<uint32_t, uint32_t>> links;
+    links.reserve(numPairs > 0 ? numPairs : 0);
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '}' || line[0] == '[') continue;
+
+        std::string_view rest(line);
+        int packageIndex, dependencyIndex;
+        if (!nextInt(rest, packageIndex) || !nextInt(rest, dependencyIndex)) continue;
+        if (packageIndex >= 0 && packageIndex < numPackages &&
+            dependencyIndex >= 0 && dependencyIndex < numDependencies) {
+            links.emplace_back(packageIndex, dependencyIndex);
+        } else {
+            std::cerr << "Warning: Out-of-bounds index in " << filename << ": " << line << std::endl;
+        }
+    }
+
+    problem.adjacency = ADJACENCY::CompactAdjacency::build(numPackages, numDependencies, std::move(links));
+    return problem;
+}
+
+
+// ----------------------
+// Capacity curve saver
+// ----------------------
+std::string saveCapacityCurve(const std::vector<std::unique_ptr<Bag>>& curve,
+                              const std::vector<int>& capacities,
+                              const std::string& outputDir,
+                              const std::string& inputFilename)
+{
+    if (curve.size() != capacities.size() || outputDir.empty()) {
+        std::cerr << "Error: Capacity curve is inconsistent or output directory is empty.\n";
+        return "";
+    }
+
+    std::string timestampSafe = curve.empty() || !curve.front() ? "" :
+        "-" + FILE_PROCESSOR::formatTimestampForFileName(curve.front()->getTimestamp());
+    std::filesystem::path csvPath = std::filesystem::path(outputDir) /
+        ("capacity_curve-" + std::filesystem::path(inputFilename).stem().string() + timestampSafe + ".csv");
+
+    std::ofstream outFile(csvPath);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Could not open CSV file " << csvPath.string() << std::endl;
+        return "";
+    }
+
+    std::string sep = ",";
+    outFile << "Capacity" << sep
+            << "Bag Benefit" << sep
+            << "Bag Weight" << sep
+            << "Packages" << sep
+            << "Processing Time (s)" << "\n";
+    for (size_t i = 0; i < curve.size(); ++i) {
+        if (!curve[i]) continue;
+        outFile << capacities[i] << sep
+                << curve[i]->getBenefit() << sep
+                << curve[i]->getSize() << sep
+                << curve[i]->getPackages().size() << sep
+                << curve[i]->getAlgorithmTime() << "\n";
+    }
+    return csvPath.string();
+}
+
+std::string saveHardwareCounters(const PERF_COUNTERS::Profile& profile,
+                                 const std::string& timestamp,
+                                 const std::string& outputDir,
+                                 const std::string& inputFilename,
+                                 const std::string& executionNumber)
+{
+    if (outputDir.empty()) {
+        std::cerr << "Error: Output directory is empty.\n";
+        return "";
+    }
+
+    std::filesystem::path csvPath = std::filesystem::path(outputDir) /
+        ("hardware_counters-" + std::filesystem::path(inputFilename).stem().string() + "-" +
+         FILE_PROCESSOR::formatTimestampForFileName(timestamp) + "-" + executionNumber + ".csv");
+
+    std::ofstream outFile(csvPath);
+    if (!outFile.is_open()) {
+        std::cerr << "Error: Could not open CSV file " << csvPath.string() << std::endl;
+        return "";
+    }
+
+    std::string sep = ",";
+    outFile << "Algorithm" << sep
+            << "Movement" << sep
+            << "Samples" << sep
+            << "Cycles" << sep
+            << "Instructions" << sep
+            << "Cache Misses" << sep
+            << "Branch Misses" << sep
+            << "IPC" << sep
+            << "Cache MPKI" << sep
+            << "Branch MPKI" << "\n";
+    for (const PERF_COUNTERS::Row& row : profile.rows()) {
+        const PERF_COUNTERS::Counters& c = row.counters;
+        outFile << ALGORITHM::toString(row.algorithm) << sep
+                << SEARCH_ENGINE::toString(row.movement) << sep
+                << c.samples << sep
+                << c.cycles << sep
+                << c.instructions << sep
+                << c.cacheMisses << sep
+                << c.branchMisses << sep
+                << c.instructionsPerCycle() << sep
+                << c.cacheMissesPerKiloInstruction() << sep
+                << c.branchMissesPerKiloInstruction() << "\n";
+    }
+    return csvPath.string();
+}
 
 // ----------------------
 // Load solution report
@@ -356,6 +528,11 @@ SolutionReport loadReport(const std::string& filename) {
         else if (line.find("Bag Weight:") != std::string::npos) {
             report.reportedWeight = std::stol(line.substr(line.find(":") + 1));
         }
+        // Parse the instance the report was written for
+        else if (line.rfind("Input File:", 0) == 0) {
+            const size_t start = line.find_first_not_of(' ', std::string("Input File:").size());
+            report.inputFile = start == std::string::npos ? "" : line.substr(start);
+        }
         // --- MODIFIED SECTION: PACKAGES ---
         // Parse packages from binary vector [0,0,1,...]
         else if (line.find("=== PACKAGES ===") != std::string::npos) {
@@ -370,6 +547,7 @@ SolutionReport loadReport(const std::string& filename) {
                     }
                     // Ignore '[' ']' and ','
                 }
+                report.totalPackages = index;
             }
         }
         // --- END MODIFIED SECTION ---
@@ -396,17 +574,113 @@ SolutionReport loadReport(const std::string& filename) {
     return report;
 }
 
+// ----------------------
+// Load instance delta
+// ----------------------
+INSTANCE_DELTA::InstanceDelta loadInstanceDelta(const std::string& filename) {
+    INSTANCE_DELTA::InstanceDelta delta;
+    std::ifstream file(filename);
+    if (!file.is_open()) throw std::runtime_error("Cannot open delta file: " + filename);
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        std::stringstream ss(line);
+        std::string keyword;
+        if (!(ss >> keyword) || keyword[0] == '#') continue;
+
+        int first = 0, second = 0;
+        bool valid = false;
+        if (keyword == "capacity") {
+            valid = static_cast<bool>(ss >> delta.capacity) && delta.capacity >= 0;
+        } else if (keyword == "benefit" && (ss >> first >> second)) {
+            delta.benefitChanges.push_back({first, second});
+            valid = true;
+        } else if (keyword == "size" && (ss >> first >> second)) {
+            delta.sizeChanges.push_back({first, second});
+            valid = true;
+        } else if (keyword == "link" && (ss >> first >> second)) {
+            delta.addedLinks.push_back({first, second});
+            valid = true;
+        } else if (keyword == "unlink" && (ss >> first >> second)) {
+            delta.removedLinks.push_back({first, second});
+            valid = true;
+        }
+        if (!valid)
+            throw std::runtime_error("Error: Malformed line " + std::to_string(lineNumber) + " in " + filename + ": " + line);
+    }
+    return delta;
+}
+
+// ----------------------
+// Find best report
+// ----------------------
+std::string findBestReport(const std::string& directory, const std::string& instanceFileName, int totalPackages) {
+    std::error_code ec;
+    if (!std::filesystem::is_directory(directory, ec)) return "";
+
+    std::string bestReport;
+    long bestBenefit = -1;
+    for (auto it = std::filesystem::recursive_directory_iterator(directory, ec);
+         !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (!it->is_regular_file() || it->path().extension() != ".txt") continue;
+
+        SolutionReport report;
+        try {
+            report = loadReport(it->path().string());
+        } catch (const std::exception&) {
+            continue;
+        }
+        // Instance files and reports of other instances have no (or a differently sized) package vector.
+        if (report.packageVector.empty() || report.totalPackages != totalPackages) continue;
+        // Sibling instances often share a size: the report must name this instance (saveReport
+        // writes "<instance file>-<execution id>").
+        if (instanceFileName.empty() || (report.inputFile != instanceFileName &&
+                                         report.inputFile.rfind(instanceFileName + "-", 0) != 0)) continue;
+
+        if (report.reportedBenefit > bestBenefit) {
+            bestBenefit = report.reportedBenefit;
+            bestReport = it->path().string();
+        }
+    }
+    return bestReport;
+}
+
+// ----------------------
+// Rebuild bag from report
+// ----------------------
+std::unique_ptr<Bag> bagFromReport(const SolutionReport& report,
+                                   const std::vector<Package*>& allPackages,
+                                   const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+                                   int maxCapacity,
+                                   unsigned int seed) {
+    if (report.totalPackages != static_cast<int>(allPackages.size()))
+        throw std::runtime_error("Error: Report has " + std::to_string(report.totalPackages) +
+                                 " packages, the instance has " + std::to_string(allPackages.size()) + ".");
+
+    std::vector<Package*> packages;
+    packages.reserve(report.packageVector.size());
+    for (int pkgIdx : report.packageVector) packages.push_back(allPackages[pkgIdx]);
+
+    // Dependencies are re-derived from the packages; the report's own dependency vector is not trusted.
+    auto bag = std::make_unique<Bag>(packages, dependencyGraph);
+    if (bag->getSize() > maxCapacity && !SOLUTION_REPAIR::repair(*bag, maxCapacity, dependencyGraph, seed))
+        throw std::runtime_error("Error: Report solution exceeds the capacity and could not be repaired.");
+    return bag;
+}
+
 // ----------------------
 // Validate solution
 // ----------------------
 ValidationResult validateSolution(const std::string& problemFilename,
                                   const std::string& reportFilename) {
-    ProblemInstance problem = loadProblem(problemFilename);
-    problem.buildDependencyMap(); // build name->Dependency* map
+    // Validation only needs the links, so the compact loader keeps huge instances in memory.
+    ADJACENCY::CompactProblem problem = loadCompactProblem(problemFilename);
     SolutionReport report = loadReport(reportFilename);
 
     ValidationResult result;
-    std::unordered_set<std::string> usedDependencies;
+    std::unordered_set<uint32_t> usedDependencies;
 
     // --- Validate packages ---
     result.packageCount = static_cast<int>(report.packageVector.size());
@@ -414,14 +688,13 @@ ValidationResult validateSolution(const std::string& problemFilename,
     result.trueWeight = 0;
 
     for (int pkgIdx : report.packageVector) {
-        if (pkgIdx >= 0 && pkgIdx < static_cast<int>(problem.packages.size())) {
-            Package* pkg = problem.packages[pkgIdx];
-            result.calculatedBenefit += pkg->getBenefit();
+        if (pkgIdx >= 0 && pkgIdx < static_cast<int>(problem.benefits.size())) {
+            result.calculatedBenefit += problem.benefits[pkgIdx];
 
-            // Collect dependencies by name
-            for (const auto& dep : pkg->getDependencies()) {
-                usedDependencies.insert(dep.first);
-            }
+            // Collect dependencies by index
+            problem.adjacency.forEachDependency(pkgIdx, [&](uint32_t dependency) {
+                usedDependencies.insert(dependency);
+            });
         } else {
             std::cerr << "Warning: Package index " << pkgIdx << " not found in problem instance\n";
         }
@@ -430,12 +703,11 @@ ValidationResult validateSolution(const std::string& problemFilename,
     // --- Validate dependencies from report ---
     result.reportedDependencyCount = static_cast<int>(report.dependencyVector.size());
     for (int depIdx : report.dependencyVector) {
-        if (depIdx >= 0 && depIdx < static_cast<int>(problem.dependencies.size())) {
-            Dependency* d = problem.dependencies[depIdx];
-            result.trueWeight += d->getSize();
+        if (depIdx >= 0 && depIdx < static_cast<int>(problem.sizes.size())) {
+            result.trueWeight += problem.sizes[depIdx];
 
-            if (usedDependencies.find(d->getName()) == usedDependencies.end()) {
-                std::cerr << "Warning: Reported dependency " << d->getName()
+            if (usedDependencies.find(depIdx) == usedDependencies.end()) {
+                std::cerr << "Warning: Reported dependency D" << depIdx
                           << " not actually used by selected packages\n";
             }
         } else {
@@ -6,14 +6,18 @@
 #include "bag.h"
 #include "dependency.h"
 #include "package.h"
+#include "instance_delta.h"
+#include "compact_adjacency.h"
 
 // Standard library headers
 #include <string>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 // Forward declaration for Bag
 class Bag;
+namespace PERF_COUNTERS { class Profile; }
 
 /**
  * @brief Contains utilities for loading problem files, loading solution reports,
@@ -34,6 +38,22 @@ namespace FILE_PROCESSOR {
  */
 ProblemInstance loadProblem(const std::string& filename);
 
+/**
+ * @brief Loads a problem instance without building Package and Dependency objects.
+ *
+ * Reads the same format as loadProblem into ADJACENCY::CompactProblem, for
+ * instances whose links would not fit the object model in memory.
+ *
+ * Validation only: validateSolution is its one user. The solver (Algorithm,
+ * its dependency graph, repair and search indices) still works on the
+ * ProblemInstance from loadProblem, so solving a huge instance still needs
+ * the memory of the full object model.
+ *
+ * @param filename The path to the problem file.
+ * @throws std::runtime_error if the file cannot be opened or is malformed.
+ */
+ADJACENCY::CompactProblem loadCompactProblem(const std::string& filename);
+
 /**
  * @brief Appends the summary of results from a vector of Bags
  * to a CSV file, including Seed, Local Search, and Metaheuristic parameters.
@@ -69,6 +89,41 @@ std::string saveReport(const std::unique_ptr<Bag>& bag,
                        const std::string& inputFilename,
                        const std::string& fileId);
 
+/**
+ * @brief Writes a benefit-vs-capacity curve (see Algorithm::sweepCapacity) as CSV.
+ *
+ * One row per capacity: capacity, benefit, weight, package count and solve time.
+ *
+ * @param curve One bag per capacity.
+ * @param capacities The swept capacities, in the same order as curve.
+ * @param outputDir The directory to save the file in.
+ * @param inputFilename The name of the original problem file.
+ * @returns Path to the saved CSV file, or an empty string on failure.
+ */
+std::string saveCapacityCurve(const std::vector<std::unique_ptr<Bag>>& curve,
+                              const std::vector<int>& capacities,
+                              const std::string& outputDir,
+                              const std::string& inputFilename);
+
+/**
+ * @brief Writes the hardware counters of one execution (see Algorithm::setHardwareCounters) as CSV.
+ *
+ * One row per algorithm and movement: samples, cycles, instructions, cache and
+ * branch misses, IPC and misses per thousand instructions.
+ *
+ * @param profile The counters collected by Algorithm::run.
+ * @param timestamp The run timestamp, used in the file name.
+ * @param outputDir The directory to save the file in.
+ * @param inputFilename The name of the original problem file.
+ * @param executionNumber The execution the counters belong to.
+ * @returns Path to the saved CSV file, or an empty string on failure.
+ */
+std::string saveHardwareCounters(const PERF_COUNTERS::Profile& profile,
+                                 const std::string& timestamp,
+                                 const std::string& outputDir,
+                                 const std::string& inputFilename,
+                                 const std::string& executionNumber);
+
 /**
  * @brief Loads a previously generated solution report file for validation.
  *
@@ -78,6 +133,50 @@ std::string saveReport(const std::unique_ptr<Bag>& bag,
  */
 SolutionReport loadReport(const std::string& filename);
 
+/**
+ * @brief Loads an instance edit from a text file.
+ *
+ * One edit per line; packages and dependencies are given by index and lines
+ * starting with '#' are comments:
+ *   capacity <value>
+ *   benefit <package> <value>
+ *   size <dependency> <value>
+ *   link <package> <dependency>
+ *   unlink <package> <dependency>
+ *
+ * @param filename The path to the delta file.
+ * @return The parsed InstanceDelta.
+ * @throws std::runtime_error if the file cannot be opened or a line is malformed.
+ */
+INSTANCE_DELTA::InstanceDelta loadInstanceDelta(const std::string& filename);
+
+/**
+ * @brief Finds the report with the highest reported benefit under a directory.
+ *
+ * Searches recursively; only reports whose "Input File:" field names the
+ * instance and whose package vector has exactly totalPackages entries qualify.
+ *
+ * @param directory The directory to search.
+ * @param instanceFileName File name of the target instance (without directory).
+ * @param totalPackages Number of packages of the target instance.
+ * @return Path to the best report, or an empty string if none qualifies.
+ */
+std::string findBestReport(const std::string& directory, const std::string& instanceFileName, int totalPackages);
+
+/**
+ * @brief Rebuilds the solution of a report as a Bag, e.g. to warm-start a search.
+ *
+ * The selected packages are added with their dependencies; a bag that does
+ * not fit maxCapacity is repaired with SOLUTION_REPAIR::repair.
+ *
+ * @throws std::runtime_error if the report does not match the instance or cannot be made feasible.
+ */
+std::unique_ptr<Bag> bagFromReport(const SolutionReport& report,
+                                   const std::vector<Package*>& allPackages,
+                                   const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+                                   int maxCapacity,
+                                   unsigned int seed);
+
 /**
  * @brief Validates a solution report against a problem instance file.
  *
@@ -88,6 +187,9 @@ SolutionReport loadReport(const std::string& filename);
  * max capacity.
  * 3. Correctness (Benefit/Weight): Reported values match calculated values.
  *
+ * The problem is read with loadCompactProblem, so instances too large for
+ * loadProblem can still be validated.
+ *
  * @param problemFilename The path to the original problem file (.txt).
  * @param reportFilename The path to the solution report file (.txt).
  * @return String describing the validation result.
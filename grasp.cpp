@@ -1,14 +1,25 @@
 #include "grasp.h"
 #include "grasp_helper.h"
+#include "progress_channel.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include "topology.h"
+
+#include <iomanip>
+#include <optional>
+#include <sstream>
 
 static constexpr int DEFAULT_TIME_CHECK_FREQ = 10;             // check time every N iterations
 static constexpr int DEFAULT_SYNC_FREQ = 10;                    // sync best bag every N iterations
+static constexpr double DEFAULT_FILL_THRESHOLD = 0.95;          // bags filled above this share skip local search
+static constexpr size_t LOCAL_OPTIMUM_CACHE_ENTRIES = 4096;     // constructions remembered per run
 
 GRASP::GRASP(double maxTime, unsigned int seed, int rclSize, double alpha)
     : m_maxTime(maxTime),
       m_alpha(alpha),
       m_alpha_random(alpha),
       m_rclSize(std::max(1, rclSize)),
+      m_fillThreshold(DEFAULT_FILL_THRESHOLD),
       m_searchEngine(seed)
 {
 }
@@ -30,16 +41,26 @@ std::unique_ptr<Bag> GRASP::run(
         std::chrono::duration<double>(m_maxTime));
     std::unique_ptr<Bag> bestBagOverall = std::make_unique<Bag>(ALGORITHM::ALGORITHM_TYPE::NONE, "0");
     std::mutex bestBagMutex;
-    unsigned int hw = std::thread::hardware_concurrency();
-    unsigned int numThreads = hw == 0 ? 1u : hw;
-    unsigned int cap = static_cast<unsigned int>(std::max<size_t>(1, dependencyGraph.size() / 100 + 1));
-    numThreads = std::min(numThreads, cap);
+    unsigned int numThreads = m_numThreads;
+    if (numThreads == 0) {
+        unsigned int hw = std::thread::hardware_concurrency();
+        numThreads = hw == 0 ? 1u : hw;
+        unsigned int cap = static_cast<unsigned int>(std::max<size_t>(1, dependencyGraph.size() / 100 + 1));
+        numThreads = std::min(numThreads, cap);
+        if (allPackages.size() < 200) numThreads = std::min<unsigned int>(numThreads, 2u);
+    }
     numThreads = std::min<unsigned int>(numThreads, static_cast<unsigned int>(std::max<size_t>(1, allPackages.size())));
-    if (allPackages.size() < 200) numThreads = std::min<unsigned int>(numThreads, 2u);
     std::vector<std::thread> workers;
     workers.reserve(numThreads);
     m_totalIterations.store(0, std::memory_order_relaxed);
     m_improvements.store(0, std::memory_order_relaxed);
+    GRASP_HELPER::LocalOptimumCache localOptimumCache(LOCAL_OPTIMUM_CACHE_ENTRIES);
+    std::optional<TOPOLOGY::CpuReservation> cpus;
+    std::optional<TOPOLOGY::InstanceReplicas> replicas;
+    if (m_threadPinning) {
+        cpus.emplace(TOPOLOGY::machine(), numThreads);
+        replicas.emplace(allPackages, dependencyGraph, TOPOLOGY::machine());
+    }
 
     for (unsigned int i = 0; i < numThreads; ++i) {
         WorkerContext ctx;
@@ -49,9 +70,17 @@ std::unique_ptr<Bag> GRASP::run(
         ctx.dependencyGraph = &dependencyGraph;
         ctx.maxLS_IterationsWithoutImprovement = maxLS_IterationsWithoutImprovement;
         ctx.max_Iterations = max_Iterations;
+        ctx.maxLS_Iterations = m_maxLS_Iterations > 0 ? m_maxLS_Iterations : max_Iterations / 2;
         ctx.deadline = deadline;
         ctx.bestBagOverall = &bestBagOverall;
         ctx.bestBagMutex = &bestBagMutex;
+        ctx.progressTag = PROGRESS::currentTag();
+        ctx.perfProfile = PERF_COUNTERS::currentProfile();
+        ctx.localOptimumCache = &localOptimumCache;
+        if (cpus) {
+            ctx.placement = &(*cpus)[i];
+            ctx.replicas = &*replicas;
+        }
         workers.emplace_back(&GRASP::graspWorker, this, std::move(ctx));
     }
     for (auto& w : workers) {
@@ -65,109 +94,197 @@ std::unique_ptr<Bag> GRASP::run(
     auto total_iterations = m_totalIterations.load();
     auto improvements = m_improvements.load();
     auto no_improvements = total_iterations - improvements;
+    std::ostringstream cacheHitRate;
+    cacheHitRate << std::fixed << std::setprecision(1) << localOptimumCache.getHitRate() * 100.0 << "%";
     bestBagOverall->setMetaheuristicParameters(
         "Alpha: " + std::to_string(m_alpha_random) +
         " | Total GRASP iterations: " + std::to_string(total_iterations) +
         " | Improvements: " + std::to_string(improvements) +
         " | No improvements: " + std::to_string(no_improvements) +
-        " | RCL size: " + std::to_string(m_rclSize)
+        " | RCL size: " + std::to_string(m_rclSize) +
+        " | LS cache hits: " + std::to_string(localOptimumCache.getHits()) +
+        "/" + std::to_string(localOptimumCache.getLookups()) + " (" + cacheHitRate.str() + ")" +
+        " | Threads: " + std::to_string(numThreads)
     );
     return bestBagOverall;
 }
 
+void GRASP::setNumThreads(unsigned int numThreads)
+{
+    m_numThreads = numThreads;
+}
+
+void GRASP::setLocalSearchIterations(int maxLS_Iterations)
+{
+    m_maxLS_Iterations = maxLS_Iterations;
+}
+
+void GRASP::setFillThreshold(double fillThreshold)
+{
+    m_fillThreshold = fillThreshold;
+}
+
+void GRASP::setThreadPinning(bool enabled)
+{
+    m_threadPinning = enabled;
+}
+
 // ------------------- Grasp Worker -------------------
+unsigned int GRASP::nextWorkerSeed()
+{
+    std::lock_guard<std::mutex> lock(m_seeder_mutex);
+    return m_searchEngine.getRandomGenerator()();
+}
+
 void GRASP::graspWorker(WorkerContext ctx) {
-    unsigned int thread_seed;
-    {
-        std::lock_guard<std::mutex> lock(m_seeder_mutex);
-        thread_seed = m_searchEngine.getRandomGenerator()();
+    // Pin before allocating, so the worker's state is first touched on its own node.
+    if (ctx.placement) {
+        TOPOLOGY::pinCurrentThread(ctx.placement->cpu);
+        const auto replica = ctx.replicas->forNode(ctx.placement->node);
+        ctx.allPackages = replica.allPackages;
+        ctx.dependencyGraph = replica.dependencyGraph;
     }
-    SearchEngine localEngine(thread_seed);
-    long long localIterations = 0;
-    long long localImprovements = 0;
 
-    thread_local std::vector<std::pair<Package*, double>> candidateScoresBuffer;
-    thread_local std::vector<Package*> rclBuffer;
+    WorkerState state(nextWorkerSeed());
 
     // local copy of best bag
-    std::unique_ptr<Bag> localBest;
     {
-        std::lock_guard<std::mutex> lk(*ctx.bestBagMutex);
-        localBest = std::make_unique<Bag>(*(*ctx.bestBagOverall));
+        TRACE::ScopedEvent syncTrace("sync", "bestBag sync");
+        auto lk = TRACE::lock(*ctx.bestBagMutex, "bestBagMutex wait");
+        state.localBest = std::make_unique<Bag>(*(*ctx.bestBagOverall));
     }
 
-    auto workerStart = std::chrono::steady_clock::now();
-
-    while (localIterations < ctx.max_Iterations) {
-        ++localIterations;
-
-        // 1. GRASP construction
-        auto currentBag = GRASP_HELPER::constructionPhaseFast(
-            ctx.bagSize, *ctx.allPackages, *ctx.dependencyGraph, localEngine,
-            candidateScoresBuffer, rclBuffer,
-            m_rclSize, m_alpha, m_alpha_random
-        );
-
-        // 2. Only run local search if solution is promising
-        if (currentBag->getSize() < static_cast<int>(ctx.bagSize * 0.95) || currentBag->getBenefit() > localBest->getBenefit()) {
-            localSearchPhase(localEngine, *currentBag, ctx.bagSize, *ctx.allPackages,
-                             ctx.moveType, ALGORITHM::LOCAL_SEARCH::BEST_IMPROVEMENT,
-                             *ctx.dependencyGraph, ctx.maxLS_IterationsWithoutImprovement / 2,
-                             ctx.max_Iterations / 2, ctx.deadline);
-            localSearchPhase(localEngine, *currentBag, ctx.bagSize, *ctx.allPackages,
-                             ctx.moveType, ALGORITHM::LOCAL_SEARCH::RANDOM_IMPROVEMENT,
-                             *ctx.dependencyGraph, ctx.maxLS_IterationsWithoutImprovement / 2,
-                             ctx.max_Iterations / 2, ctx.deadline);
-        }
+    // Live progress for observers: moves are reported as deltas since the previous event.
+    PROGRESS::ScopedTag progressTag(ctx.progressTag);
+    PERF_COUNTERS::ScopedContext perfContext(ctx.perfProfile, ALGORITHM::ALGORITHM_TYPE::GRASP);
+    PERF_COUNTERS::ScopedSample perfSample(SEARCH_ENGINE::MovementType::NONE);
+    TRACE::setThreadName("GRASP worker");
+    TRACE::ScopedEvent workerTrace("worker", "GRASP worker", ctx.moveType);
+    long long movesReported = 0;
+    auto reportProgress = [&](PROGRESS::EventKind kind) {
+        const long long moves = state.engine.getMovesApplied();
+        PROGRESS::report(kind, ALGORITHM::ALGORITHM_TYPE::GRASP, ctx.moveType,
+                         state.localBest->getBenefit(), state.localBest->getSize(), moves - movesReported);
+        movesReported = moves;
+    };
 
-        // 3. Check improvement
-        if (currentBag->getBenefit() > localBest->getBenefit()) {
-            localBest = std::move(currentBag);
-            ++localImprovements;
-        }
+    while (state.iterations < ctx.max_Iterations) {
+        ++state.iterations;
+
+        // 1-3. Construction, local search and improvement check
+        const long long improvementsBefore = state.improvements;
+        iterationSteps(ctx, state).finish();
+        if (state.improvements > improvementsBefore) reportProgress(PROGRESS::EventKind::INCUMBENT);
 
         // 4. Batch-update global best
-        if ((localIterations % DEFAULT_SYNC_FREQ) == 0) {
-            std::lock_guard<std::mutex> lk(*ctx.bestBagMutex);
-            if (localBest->getBenefit() > (*ctx.bestBagOverall)->getBenefit()) {
-                *ctx.bestBagOverall = std::make_unique<Bag>(*localBest);
+        if ((state.iterations % DEFAULT_SYNC_FREQ) == 0) {
+            TRACE::ScopedEvent syncTrace("sync", "bestBag sync");
+            auto lk = TRACE::lock(*ctx.bestBagMutex, "bestBagMutex wait");
+            if (state.localBest->getBenefit() > (*ctx.bestBagOverall)->getBenefit()) {
+                *ctx.bestBagOverall = std::make_unique<Bag>(*state.localBest);
             }
         }
 
         // 5. Periodic time check
-        if ((localIterations % DEFAULT_TIME_CHECK_FREQ) == 0) {
+        if ((state.iterations % DEFAULT_TIME_CHECK_FREQ) == 0) {
+            reportProgress(PROGRESS::EventKind::HEARTBEAT);
             if (std::chrono::steady_clock::now() >= ctx.deadline) break;
         }
     }
 
     // 6. Final sync
     {
-        std::lock_guard<std::mutex> lk(*ctx.bestBagMutex);
-        if (localBest->getBenefit() > (*ctx.bestBagOverall)->getBenefit()) {
-            *ctx.bestBagOverall = std::make_unique<Bag>(*localBest);
+        TRACE::ScopedEvent syncTrace("sync", "bestBag sync");
+        auto lk = TRACE::lock(*ctx.bestBagMutex, "bestBagMutex wait");
+        if (state.localBest->getBenefit() > (*ctx.bestBagOverall)->getBenefit()) {
+            *ctx.bestBagOverall = std::make_unique<Bag>(*state.localBest);
         }
     }
 
-    m_totalIterations.fetch_add(localIterations, std::memory_order_relaxed);
-    m_improvements.fetch_add(localImprovements, std::memory_order_relaxed);
+    m_totalIterations.fetch_add(state.iterations, std::memory_order_relaxed);
+    m_improvements.fetch_add(state.improvements, std::memory_order_relaxed);
 }
 
-// ------------------- local Search Phase -------------------
-// This function was unique to GRASP, so it stays.
-void GRASP::localSearchPhase(
-    SearchEngine& searchEngine,
-    Bag& bag,
+// ------------------- GRASP Iteration -------------------
+STEPPER::Stepper GRASP::iterationSteps(const WorkerContext& ctx, WorkerState& state)
+{
+    // 1. GRASP construction
+    auto currentBag = GRASP_HELPER::constructionPhaseFast(
+        ctx.bagSize, *ctx.allPackages, *ctx.dependencyGraph, state.engine,
+        state.candidateScoresBuffer, state.rclBuffer,
+        m_rclSize, m_alpha, m_alpha_random
+    );
+    co_yield state.localBest->getBenefit();
+
+    // 2. Only run local search if solution is promising; a repeated construction reuses its local optimum
+    const int fillSize = static_cast<int>(ctx.bagSize * m_fillThreshold);
+    if (currentBag->getSize() < fillSize || currentBag->getBenefit() > state.localBest->getBenefit()) {
+        const uint64_t fingerprint = GRASP_HELPER::LocalOptimumCache::fingerprint(*currentBag);
+        if (auto cached = ctx.localOptimumCache->find(fingerprint)) {
+            currentBag = std::make_unique<Bag>(*cached);
+        } else {
+            for (auto method : {ALGORITHM::LOCAL_SEARCH::BEST_IMPROVEMENT, ALGORITHM::LOCAL_SEARCH::RANDOM_IMPROVEMENT}) {
+                // A well filled bag skips the remaining phases.
+                if (currentBag->getBenefit() > 0 && currentBag->getSize() >= fillSize) break;
+                auto search = state.engine.localSearchSteps(
+                    *currentBag, ctx.bagSize, *ctx.allPackages, ctx.moveType, method, *ctx.dependencyGraph,
+                    ctx.maxLS_IterationsWithoutImprovement / 2, ctx.maxLS_Iterations, ctx.deadline);
+                while (search.step()) co_yield state.localBest->getBenefit();
+            }
+            // A search cut short by the deadline has not reached its optimum.
+            if (std::chrono::steady_clock::now() < ctx.deadline)
+                ctx.localOptimumCache->insert(fingerprint, *currentBag);
+        }
+    }
+
+    // 3. Check improvement
+    if (currentBag->getBenefit() > state.localBest->getBenefit()) {
+        state.localBest = std::move(currentBag);
+        ++state.improvements;
+        co_yield state.localBest->getBenefit();
+    }
+}
+
+// ------------------- Steppable Worker -------------------
+STEPPER::Stepper GRASP::steps(
+    Bag& best,
     int bagSize,
     const std::vector<Package*>& allPackages,
     SEARCH_ENGINE::MovementType moveType,
-    ALGORITHM::LOCAL_SEARCH localSearchMethod,
     const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
     int maxLS_IterationsWithoutImprovement,
-    int maxLS_Iterations,
-    const std::chrono::steady_clock::time_point& deadline)
+    int max_Iterations,
+    std::chrono::steady_clock::time_point deadline)
 {
-    if (bag.getBenefit() > 0 && bag.getSize() >= static_cast<int>(bagSize * 0.95)) return;
+    // Same iterations as graspWorker, without threads: the caller decides when each step runs.
+    WorkerState state(nextWorkerSeed());
+    state.localBest = std::make_unique<Bag>(best);
+    GRASP_HELPER::LocalOptimumCache localOptimumCache(LOCAL_OPTIMUM_CACHE_ENTRIES);
+
+    WorkerContext ctx;
+    ctx.bagSize = bagSize;
+    ctx.allPackages = &allPackages;
+    ctx.moveType = moveType;
+    ctx.dependencyGraph = &dependencyGraph;
+    ctx.maxLS_IterationsWithoutImprovement = maxLS_IterationsWithoutImprovement;
+    ctx.max_Iterations = max_Iterations;
+    ctx.maxLS_Iterations = m_maxLS_Iterations > 0 ? m_maxLS_Iterations : max_Iterations / 2;
+    ctx.deadline = deadline;
+    ctx.localOptimumCache = &localOptimumCache;
 
-    searchEngine.localSearch(bag, bagSize, allPackages, moveType, localSearchMethod,
-        dependencyGraph, maxLS_IterationsWithoutImprovement, maxLS_Iterations, deadline);
-}
\ No newline at end of file
+    long long improvementsPublished = 0;
+    while (state.iterations < ctx.max_Iterations && std::chrono::steady_clock::now() < ctx.deadline) {
+        ++state.iterations;
+        auto iteration = iterationSteps(ctx, state);
+        while (iteration.step()) {
+            // Publish a new local best before yielding, so best is current between steps.
+            if (state.improvements > improvementsPublished) {
+                improvementsPublished = state.improvements;
+                best = *state.localBest;
+                best.setBagAlgorithm(ALGORITHM::ALGORITHM_TYPE::GRASP);
+                best.setMovementType(moveType);
+            }
+            co_yield best.getBenefit();
+        }
+    }
+}
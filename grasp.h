@@ -20,6 +20,11 @@
 #include "package.h"
 #include "dependency.h"
 #include "search_engine.h"
+#include "stepper.h"
+
+namespace PERF_COUNTERS { class Profile; }
+namespace GRASP_HELPER { class LocalOptimumCache; }
+namespace TOPOLOGY { class InstanceReplicas; struct Placement; }
 
 // WorkerContext reused to pass args into worker thread
 struct WorkerContext {
@@ -29,9 +34,15 @@ struct WorkerContext {
     const std::unordered_map<const Package*, std::vector<const Dependency*>>* dependencyGraph = nullptr;
     int maxLS_IterationsWithoutImprovement = 0;
     int max_Iterations = 0;
+    int maxLS_Iterations = 0;
     std::chrono::steady_clock::time_point deadline{};
     std::unique_ptr<Bag>* bestBagOverall = nullptr;
     std::mutex* bestBagMutex = nullptr;
+    int progressTag = 0;
+    PERF_COUNTERS::Profile* perfProfile = nullptr;
+    GRASP_HELPER::LocalOptimumCache* localOptimumCache = nullptr;
+    const TOPOLOGY::Placement* placement = nullptr;   ///< CPU to pin to, nullptr when unpinned
+    TOPOLOGY::InstanceReplicas* replicas = nullptr;   ///< Per-node instance copies, with placement
 };
 
 class GRASP {
@@ -46,9 +57,54 @@ public:
         int maxLS_IterationsWithoutImprovement,
         int max_Iterations);
 
+    /// Overrides the worker thread count (0 keeps the instance-size heuristic).
+    void setNumThreads(unsigned int numThreads);
+
+    /// Overrides move evaluations per local search step (0 keeps max_Iterations / 2).
+    void setLocalSearchIterations(int maxLS_Iterations);
+
+    /// Overrides the fill ratio of the capacity above which a construction skips local search.
+    void setFillThreshold(double fillThreshold);
+
+    /// Pins workers to CPUs spread over the NUMA nodes, each reading a node-local instance copy.
+    void setThreadPinning(bool enabled);
+
+    /**
+     * @brief A single GRASP worker as a stepper: one construction or local search iteration per step.
+     *
+     * Runs the same iterations as a worker thread of run(), with its own search
+     * engine and local optimum cache. best holds the best bag between steps and
+     * must start empty or feasible. The arguments and this GRASP must outlive
+     * the stepper.
+     */
+    STEPPER::Stepper steps(
+        Bag& best,
+        int bagSize,
+        const std::vector<Package*>& allPackages,
+        SEARCH_ENGINE::MovementType moveType,
+        const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+        int maxLS_IterationsWithoutImprovement,
+        int max_Iterations,
+        std::chrono::steady_clock::time_point deadline);
+
 private:
+    // State a worker keeps between GRASP iterations.
+    struct WorkerState {
+        explicit WorkerState(unsigned int seed) : engine(seed) {}
+
+        SearchEngine engine;
+        std::unique_ptr<Bag> localBest;
+        std::vector<std::pair<Package*, double>> candidateScoresBuffer;
+        std::vector<Package*> rclBuffer;
+        long long iterations = 0;
+        long long improvements = 0;
+    };
+
     // worker and phases
     void graspWorker(WorkerContext ctx);
+    unsigned int nextWorkerSeed();
+    /// One GRASP iteration (construction, local search, improvement check), yielding per work unit.
+    STEPPER::Stepper iterationSteps(const WorkerContext& ctx, WorkerState& state);
     std::unique_ptr<Bag> constructionPhaseFast(
         int bagSize,
         const std::vector<Package*>& allPackages,
@@ -58,23 +114,16 @@ private:
         std::vector<Package*>& rclBuffer);
     double calculateGreedyScore(const Package* pkg, const Bag& bag,
                                 const std::vector<const Dependency*>& dependencies) const;
-    void localSearchPhase(
-        SearchEngine& searchEngine,
-        Bag& bag,
-        int bagSize,
-        const std::vector<Package*>& allPackages,
-        SEARCH_ENGINE::MovementType moveType,
-        ALGORITHM::LOCAL_SEARCH localSearchMethod,
-        const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
-        int maxLS_IterationsWithoutImprovement,
-        int maxLS_Iterations,
-        const std::chrono::steady_clock::time_point& deadline);
 
 private:
     const double m_maxTime;
     const double m_alpha;
     double m_alpha_random;
     const int m_rclSize;
+    unsigned int m_numThreads = 0;
+    int m_maxLS_Iterations = 0;
+    double m_fillThreshold;
+    bool m_threadPinning = false;
     SearchEngine m_searchEngine;
     std::mutex m_seeder_mutex;
 
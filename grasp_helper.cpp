@@ -1,4 +1,5 @@
 #include "grasp_helper.h"
+#include "trace.h"
 #include <algorithm>
 #include <limits>
 
@@ -32,6 +33,7 @@ std::unique_ptr<Bag> constructionPhaseFast(
     double alpha,
     double& alpha_random_out)
 {
+    TRACE::ScopedEvent trace("construct", "graspConstruction");
     auto bag = std::make_unique<Bag>(ALGORITHM::ALGORITHM_TYPE::GRASP, "construction");
     std::mt19937& rng = searchEngine.getRandomGenerator();
 
@@ -113,4 +115,65 @@ std::unique_ptr<Bag> constructionPhaseFast(
     return bag;
 }
 
+// ------------------- Local Optimum Cache -------------------
+LocalOptimumCache::LocalOptimumCache(size_t maxEntries)
+    : m_maxEntriesPerShard(std::max<size_t>(1, maxEntries / SHARD_COUNT))
+{
+}
+
+uint64_t LocalOptimumCache::fingerprint(const Bag& bag)
+{
+    // Summing mixed per-package hashes makes the fingerprint independent of insertion order.
+    uint64_t sum = 0;
+    for (const Package* package : bag.getPackages()) {
+        uint64_t x = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(package));
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        sum += x ^ (x >> 31);
+    }
+    return sum ^ static_cast<uint64_t>(bag.getPackages().size());
+}
+
+LocalOptimumCache::Shard& LocalOptimumCache::shardFor(uint64_t fingerprint)
+{
+    return m_shards[(fingerprint >> 59) % SHARD_COUNT];
+}
+
+std::shared_ptr<const Bag> LocalOptimumCache::find(uint64_t fingerprint)
+{
+    m_lookups.fetch_add(1, std::memory_order_relaxed);
+    Shard& shard = shardFor(fingerprint);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.entries.find(fingerprint);
+    if (it == shard.entries.end()) return nullptr;
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return it->second;
+}
+
+void LocalOptimumCache::insert(uint64_t fingerprint, const Bag& localOptimum)
+{
+    auto entry = std::make_shared<const Bag>(localOptimum);
+    Shard& shard = shardFor(fingerprint);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.entries.size() >= m_maxEntriesPerShard) return;
+    shard.entries.emplace(fingerprint, std::move(entry));
+}
+
+long long LocalOptimumCache::getLookups() const
+{
+    return m_lookups.load(std::memory_order_relaxed);
+}
+
+long long LocalOptimumCache::getHits() const
+{
+    return m_hits.load(std::memory_order_relaxed);
+}
+
+double LocalOptimumCache::getHitRate() const
+{
+    const long long lookups = getLookups();
+    return lookups > 0 ? static_cast<double>(getHits()) / lookups : 0.0;
+}
+
 } // namespace GRASP_HELPER 
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 #include <random>
@@ -47,4 +51,45 @@ namespace GRASP_HELPER {
         double alpha,
         double& alpha_random_out);
 
+    /**
+     * @brief Concurrent map from a construction's fingerprint to the local optimum reached from it.
+     *
+     * Workers that construct a bag already seen skip local search and reuse the
+     * stored optimum. The map is split into mutex-guarded shards so workers rarely
+     * contend, and each shard stops accepting entries once full to bound memory.
+     * A fingerprint collision only returns another feasible local optimum.
+     */
+    class LocalOptimumCache {
+    public:
+        explicit LocalOptimumCache(size_t maxEntries);
+
+        /// Order-independent hash of the bag's package set.
+        static uint64_t fingerprint(const Bag& bag);
+
+        /// Returns the cached local optimum, or nullptr; counts the lookup.
+        std::shared_ptr<const Bag> find(uint64_t fingerprint);
+
+        /// Stores a copy of the optimum reached from the construction with this fingerprint.
+        void insert(uint64_t fingerprint, const Bag& localOptimum);
+
+        long long getLookups() const;
+        long long getHits() const;
+        double getHitRate() const;
+
+    private:
+        static constexpr size_t SHARD_COUNT = 16;
+
+        struct Shard {
+            std::mutex mutex;
+            std::unordered_map<uint64_t, std::shared_ptr<const Bag>> entries;
+        };
+
+        Shard& shardFor(uint64_t fingerprint);
+
+        std::array<Shard, SHARD_COUNT> m_shards;
+        const size_t m_maxEntriesPerShard;
+        std::atomic<long long> m_lookups{0};
+        std::atomic<long long> m_hits{0};
+    };
+
 } // namespace GRASP_HELPER 
@@ -1,6 +1,12 @@
 #include "grasp_vns.h"
 #include "grasp_helper.h"
 #include "vns_helper.h"
+#include "progress_channel.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include "topology.h"
+
+#include <optional>
 
 // --- Add these tuning constants near top of file or inside GRASP_VNS as static members ---
 static constexpr int DEFAULT_VNS_FREQUENCY = 2;                // run VNS every 2 GRASP iterations (set to 1 to always run)
@@ -14,6 +20,7 @@ GRASP_VNS::GRASP_VNS(double maxTime, unsigned int seed, int rclSize, double alph
       m_alpha(alpha),
       m_alpha_random(alpha),
       m_rclSize(std::max(1, rclSize)),
+      m_vnsFrequency(DEFAULT_VNS_FREQUENCY),
       m_searchEngine(seed)
 {
 }
@@ -36,18 +43,29 @@ std::unique_ptr<Bag> GRASP_VNS::run(
     auto start_time = std::chrono::steady_clock::now();
     auto deadline = start_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
         std::chrono::duration<double>(m_maxTime));
-    std::unique_ptr<Bag> bestBagOverall = std::make_unique<Bag>(ALGORITHM::ALGORITHM_TYPE::NONE, "0");
+    std::unique_ptr<Bag> bestBagOverall = m_initialSolution
+        ? std::make_unique<Bag>(*m_initialSolution)
+        : std::make_unique<Bag>(ALGORITHM::ALGORITHM_TYPE::NONE, "0");
     std::mutex bestBagMutex;
-    unsigned int hw = std::thread::hardware_concurrency();
-    unsigned int numThreads = hw == 0 ? 1u : hw;
-    unsigned int cap = static_cast<unsigned int>(std::max<size_t>(1, dependencyGraph.size() / 100 + 1));
-    numThreads = std::min(numThreads, cap);
+    unsigned int numThreads = m_numThreads;
+    if (numThreads == 0) {
+        unsigned int hw = std::thread::hardware_concurrency();
+        numThreads = hw == 0 ? 1u : hw;
+        unsigned int cap = static_cast<unsigned int>(std::max<size_t>(1, dependencyGraph.size() / 100 + 1));
+        numThreads = std::min(numThreads, cap);
+        if (allPackages.size() < 200) numThreads = std::min<unsigned int>(numThreads, 2u);
+    }
     numThreads = std::min<unsigned int>(numThreads, static_cast<unsigned int>(std::max<size_t>(1, allPackages.size())));
-    if (allPackages.size() < 200) numThreads = std::min<unsigned int>(numThreads, 2u);
     std::vector<std::thread> workers;
     workers.reserve(numThreads);
     m_totalIterations.store(0, std::memory_order_relaxed);
     m_improvements.store(0, std::memory_order_relaxed);
+    std::optional<TOPOLOGY::CpuReservation> cpus;
+    std::optional<TOPOLOGY::InstanceReplicas> replicas;
+    if (m_threadPinning) {
+        cpus.emplace(TOPOLOGY::machine(), numThreads);
+        replicas.emplace(allPackages, dependencyGraph, TOPOLOGY::machine());
+    }
 
     for (unsigned int i = 0; i < numThreads; ++i) {
         WorkerContext ctx;
@@ -57,9 +75,15 @@ std::unique_ptr<Bag> GRASP_VNS::run(
         ctx.dependencyGraph = &dependencyGraph;
         ctx.maxLS_IterationsWithoutImprovement = maxLS_IterationsWithoutImprovement;
         ctx.max_Iterations = max_Iterations;
+        ctx.maxLS_Iterations = m_maxLS_Iterations > 0 ? m_maxLS_Iterations : max_Iterations / 4;
         ctx.deadline = deadline;
         ctx.bestBagOverall = &bestBagOverall;
         ctx.bestBagMutex = &bestBagMutex;
+        ctx.progressTag = PROGRESS::currentTag();
+        ctx.perfProfile = PERF_COUNTERS::currentProfile();
+        ctx.startFromBest = m_initialSolution != nullptr;
+        ctx.placement = cpus ? &(*cpus)[i] : nullptr;
+        ctx.replicas = cpus ? &*replicas : nullptr;
         workers.emplace_back(&GRASP_VNS::graspWorker, this, std::move(ctx));
     }
     for (auto& w : workers) {
@@ -79,13 +103,47 @@ std::unique_ptr<Bag> GRASP_VNS::run(
         " | Total GRASP iterations: " + std::to_string(total_iterations) +
         " | Improvements: " + std::to_string(improvements) +
         " | No improvements: " + std::to_string(no_improvements) +
-        " | RCL size: " + std::to_string(m_rclSize)
+        " | RCL size: " + std::to_string(m_rclSize) +
+        " | Threads: " + std::to_string(numThreads)
     );
     return bestBagOverall;
 }
 
+void GRASP_VNS::setNumThreads(unsigned int numThreads)
+{
+    m_numThreads = numThreads;
+}
+
+void GRASP_VNS::setLocalSearchIterations(int maxLS_Iterations)
+{
+    m_maxLS_Iterations = maxLS_Iterations;
+}
+
+void GRASP_VNS::setVnsFrequency(int vnsFrequency)
+{
+    m_vnsFrequency = std::max(1, vnsFrequency);
+}
+
+void GRASP_VNS::setInitialSolution(const Bag* initialSolution)
+{
+    m_initialSolution = initialSolution ? std::make_unique<Bag>(*initialSolution) : nullptr;
+}
+
+void GRASP_VNS::setThreadPinning(bool enabled)
+{
+    m_threadPinning = enabled;
+}
+
 // ------------------- Grasp Worker -------------------
 void GRASP_VNS::graspWorker(WorkerContext ctx) {
+    // Pin before allocating, so the worker's state is first touched on its own node.
+    if (ctx.placement) {
+        TOPOLOGY::pinCurrentThread(ctx.placement->cpu);
+        const auto replica = ctx.replicas->forNode(ctx.placement->node);
+        ctx.allPackages = replica.allPackages;
+        ctx.dependencyGraph = replica.dependencyGraph;
+    }
+
     SearchEngine localEngine(m_searchEngine.getSeed());
     long long localIterations = 0;
     long long localImprovements = 0;
@@ -96,35 +154,53 @@ void GRASP_VNS::graspWorker(WorkerContext ctx) {
     // local copy of the best bag (start from the global best)
     std::unique_ptr<Bag> localBest;
     {
-        std::lock_guard<std::mutex> lk(*ctx.bestBagMutex);
+        TRACE::ScopedEvent syncTrace("sync", "bestBag sync");
+        auto lk = TRACE::lock(*ctx.bestBagMutex, "bestBagMutex wait");
         localBest = std::make_unique<Bag>(*(*ctx.bestBagOverall));
     }
 
-    const int vnsFrequency = DEFAULT_VNS_FREQUENCY;
+    const int vnsFrequency = m_vnsFrequency;
     const double minRemainingTimeForVNS = DEFAULT_MIN_REMAINING_TIME_FOR_VNS;
     const int timeCheckFreq = DEFAULT_TIME_CHECK_FREQ;
     const int syncFreq = DEFAULT_SYNC_FREQ;
 
     auto workerStart = std::chrono::steady_clock::now();
 
+    // Live progress for observers: moves are reported as deltas since the previous event.
+    PROGRESS::ScopedTag progressTag(ctx.progressTag);
+    PERF_COUNTERS::ScopedContext perfContext(ctx.perfProfile, ALGORITHM::ALGORITHM_TYPE::GRASP_VNS);
+    PERF_COUNTERS::ScopedSample perfSample(SEARCH_ENGINE::MovementType::NONE);
+    TRACE::setThreadName("GRASP_VNS worker");
+    TRACE::ScopedEvent workerTrace("worker", "GRASP_VNS worker", ctx.moveType);
+    long long movesReported = 0;
+    auto reportProgress = [&](PROGRESS::EventKind kind) {
+        const long long moves = localEngine.getMovesApplied();
+        PROGRESS::report(kind, ALGORITHM::ALGORITHM_TYPE::GRASP_VNS, ctx.moveType,
+                         localBest->getBenefit(), localBest->getSize(), moves - movesReported);
+        movesReported = moves;
+    };
+
     while (localIterations < ctx.max_Iterations) {
         ++localIterations;
 
-        // 1. GRASP Construction Phase (fast construction)
-        std::unique_ptr<Bag> currentBag = GRASP_HELPER::constructionPhaseFast(
-            ctx.bagSize, *ctx.allPackages, *ctx.dependencyGraph,
-            localEngine,
-            candidateScoresBuffer,
-            rclBuffer,
-            m_rclSize,
-            m_alpha,
-            m_alpha_random
-        );
+        // 1. GRASP Construction Phase (fast construction); a seeded run first intensifies around the seed
+        const bool fromSeed = ctx.startFromBest && localIterations == 1;
+        std::unique_ptr<Bag> currentBag = fromSeed
+            ? std::make_unique<Bag>(*localBest)
+            : GRASP_HELPER::constructionPhaseFast(
+                ctx.bagSize, *ctx.allPackages, *ctx.dependencyGraph,
+                localEngine,
+                candidateScoresBuffer,
+                rclBuffer,
+                m_rclSize,
+                m_alpha,
+                m_alpha_random
+            );
 
         double benefitBeforeVNS = currentBag->getBenefit();
 
         // Decide whether to run VNS now:
-        bool runVnsThisIteration = (vnsFrequency <= 1) || ((localIterations % vnsFrequency) == 0);
+        bool runVnsThisIteration = fromSeed || (vnsFrequency <= 1) || ((localIterations % vnsFrequency) == 0);
 
         if (runVnsThisIteration) {
             // Compute remaining time safely (deadline may be shared across threads)
@@ -142,7 +218,7 @@ void GRASP_VNS::graspWorker(WorkerContext ctx) {
                     *ctx.dependencyGraph,
                     localEngine,
                     ctx.maxLS_IterationsWithoutImprovement / 2,
-                    ctx.max_Iterations / 4,
+                    ctx.maxLS_Iterations,
                     ctx.deadline
                 );
             } else {
@@ -154,11 +230,13 @@ void GRASP_VNS::graspWorker(WorkerContext ctx) {
         if (currentBag->getBenefit() > localBest->getBenefit()) {
             ++localImprovements;
             localBest = std::move(currentBag);
+            reportProgress(PROGRESS::EventKind::INCUMBENT);
         }
 
         // Batch-update global best less often to reduce locking overhead
         if ((localIterations % syncFreq) == 0) {
-            std::lock_guard<std::mutex> lk(*ctx.bestBagMutex);
+            TRACE::ScopedEvent syncTrace("sync", "bestBag sync");
+            auto lk = TRACE::lock(*ctx.bestBagMutex, "bestBagMutex wait");
             if (localBest->getBenefit() > (*ctx.bestBagOverall)->getBenefit()) {
                 *ctx.bestBagOverall = std::make_unique<Bag>(*localBest);
             }
@@ -166,13 +244,15 @@ void GRASP_VNS::graspWorker(WorkerContext ctx) {
 
         // Periodic time check to allow graceful exit before deadline
         if ((localIterations % timeCheckFreq) == 0) {
+            reportProgress(PROGRESS::EventKind::HEARTBEAT);
             if (std::chrono::steady_clock::now() >= ctx.deadline) break;
         }
     }
 
     // Final sync to global best
     {
-        std::lock_guard<std::mutex> lk(*ctx.bestBagMutex);
+        TRACE::ScopedEvent syncTrace("sync", "bestBag sync");
+        auto lk = TRACE::lock(*ctx.bestBagMutex, "bestBagMutex wait");
         if (localBest->getBenefit() > (*ctx.bestBagOverall)->getBenefit()) {
             *ctx.bestBagOverall = std::make_unique<Bag>(*localBest);
         }
@@ -15,6 +15,8 @@
 class Bag;
 class Package;
 class Dependency;
+namespace PERF_COUNTERS { class Profile; }
+namespace TOPOLOGY { class InstanceReplicas; struct Placement; }
 
 /**
  * @brief GRASP_VNS combines GRASP construction and VNS intensification phases.
@@ -52,6 +54,42 @@ public:
         int maxLS_IterationsWithoutImprovement,
         int max_Iterations);
 
+    /**
+     * @brief Overrides the worker thread count.
+     * @param numThreads Number of workers (0 keeps the instance-size heuristic)
+     */
+    void setNumThreads(unsigned int numThreads);
+
+    /**
+     * @brief Overrides move evaluations per local search step inside VNS.
+     * @param maxLS_Iterations Evaluations per step (0 keeps max_Iterations / 4)
+     */
+    void setLocalSearchIterations(int maxLS_Iterations);
+
+    /**
+     * @brief Overrides how often a worker runs VNS on its construction.
+     * @param vnsFrequency Run VNS every N GRASP iterations (1 = always)
+     */
+    void setVnsFrequency(int vnsFrequency);
+
+    /**
+     * @brief Seeds the search with a known solution (e.g. a warm start).
+     *
+     * The solution becomes the initial global best, and each worker spends its
+     * first iteration running VNS from it instead of constructing a new bag.
+     * @param initialSolution Solution to copy (nullptr clears the seed)
+     */
+    void setInitialSolution(const Bag* initialSolution);
+
+    /**
+     * @brief Pins workers to CPUs spread over the NUMA nodes (see TOPOLOGY).
+     *
+     * Each worker allocates its state after pinning and reads a copy of the
+     * instance made on its node.
+     * @param enabled True to pin (default: unpinned)
+     */
+    void setThreadPinning(bool enabled);
+
 private:
     // ---------------- Worker Context ----------------
     struct WorkerContext {
@@ -61,10 +99,16 @@ private:
         const std::unordered_map<const Package*, std::vector<const Dependency*>>* dependencyGraph;
         int maxLS_IterationsWithoutImprovement;
         int max_Iterations;
+        int maxLS_Iterations;
         std::chrono::steady_clock::time_point deadline;
 
         std::unique_ptr<Bag>* bestBagOverall;
         std::mutex* bestBagMutex;
+        int progressTag;
+        PERF_COUNTERS::Profile* perfProfile;
+        bool startFromBest;
+        const TOPOLOGY::Placement* placement;  ///< CPU to pin to, nullptr when unpinned
+        TOPOLOGY::InstanceReplicas* replicas;  ///< Per-node instance copies, with placement
     };
 
     /**
@@ -79,6 +123,11 @@ private:
     double m_alpha;                   ///< GRASP alpha (balance between greediness and randomness)
     double m_alpha_random;            ///< Randomized alpha (used when < 0)
     int m_rclSize;                    ///< Restricted Candidate List size
+    unsigned int m_numThreads = 0;    ///< Worker threads (0 = instance-size heuristic)
+    int m_maxLS_Iterations = 0;       ///< LS evaluations per step (0 = max_Iterations / 4)
+    int m_vnsFrequency;               ///< Run VNS every N GRASP iterations
+    bool m_threadPinning = false;     ///< Pin workers and replicate the instance per NUMA node
+    std::unique_ptr<Bag> m_initialSolution; ///< Optional seed solution (warm start)
     SearchEngine m_searchEngine;      ///< Base random engine (thread-local copies are used per worker)
 
     // ---------------- Statistics ----------------
@@ -0,0 +1,116 @@
+#include "instance_delta.h"
+
+#include "bag.h"
+#include "package.h"
+#include "dependency.h"
+#include "data_model.h"
+
+#include <climits>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace INSTANCE_DELTA {
+
+size_t InstanceDelta::size() const
+{
+    return benefitChanges.size() + sizeChanges.size() + addedLinks.size() + removedLinks.size() +
+           (capacity >= 0 ? 1 : 0);
+}
+
+std::string InstanceDelta::toString() const
+{
+    std::ostringstream oss;
+    oss << "InstanceDelta {\n"
+        << "  benefit changes: " << benefitChanges.size() << "\n"
+        << "  size changes: " << sizeChanges.size() << "\n"
+        << "  added links: " << addedLinks.size() << "\n"
+        << "  removed links: " << removedLinks.size() << "\n"
+        << "  capacity: " << (capacity >= 0 ? std::to_string(capacity) : "unchanged") << "\n"
+        << "}";
+    return oss.str();
+}
+
+// =====================================================================================
+// Apply
+// =====================================================================================
+std::vector<Package*> apply(const InstanceDelta& delta,
+                            ProblemInstance& problemInstance,
+                            std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+                            Bag* bag)
+{
+    auto packageAt = [&](int index) {
+        if (index < 0 || index >= static_cast<int>(problemInstance.packages.size()))
+            throw std::runtime_error("Error: Delta references unknown package " + std::to_string(index));
+        return problemInstance.packages[index];
+    };
+    auto dependencyAt = [&](int index) {
+        if (index < 0 || index >= static_cast<int>(problemInstance.dependencies.size()))
+            throw std::runtime_error("Error: Delta references unknown dependency " + std::to_string(index));
+        return problemInstance.dependencies[index];
+    };
+
+    // 1. Collect the affected packages first, so an invalid delta changes nothing.
+    std::vector<Package*> touched;
+    std::unordered_set<const Package*> seen;
+    auto touch = [&](Package* package) {
+        if (seen.insert(package).second) touched.push_back(package);
+    };
+
+    for (const BenefitChange& change : delta.benefitChanges) touch(packageAt(change.package));
+    for (const SizeChange& change : delta.sizeChanges) {
+        for (const auto& pair : dependencyAt(change.dependency)->getAssociatedPackages()) touch(pair.second);
+    }
+    // A (un)linked dependency changes what sharing it costs for all of its packages.
+    for (const auto* links : {&delta.addedLinks, &delta.removedLinks}) {
+        for (const Link& link : *links) {
+            touch(packageAt(link.package));
+            for (const auto& pair : dependencyAt(link.dependency)->getAssociatedPackages()) touch(pair.second);
+        }
+    }
+
+    // 2. Take affected packages out of the bag while their old benefit and dependencies still hold.
+    std::vector<Package*> rebag;
+    if (bag) {
+        for (Package* package : touched) {
+            if (bag->getPackages().count(package) == 0) continue;
+            bag->removePackage(*package, dependencyGraph.at(package));
+            rebag.push_back(package);
+        }
+    }
+
+    // 3. Edit the instance.
+    for (const BenefitChange& change : delta.benefitChanges) packageAt(change.package)->setBenefit(change.benefit);
+    for (const SizeChange& change : delta.sizeChanges) dependencyAt(change.dependency)->setSize(change.size);
+    for (const Link& link : delta.addedLinks) {
+        Package* package = packageAt(link.package);
+        Dependency* dependency = dependencyAt(link.dependency);
+        package->addDependency(*dependency);
+        dependency->addAssociatedPackage(package);
+    }
+    for (const Link& link : delta.removedLinks) {
+        Package* package = packageAt(link.package);
+        Dependency* dependency = dependencyAt(link.dependency);
+        package->removeDependency(*dependency);
+        dependency->removeAssociatedPackage(*package);
+    }
+    if (delta.capacity >= 0) problemInstance.maxCapacity = delta.capacity;
+
+    // 4. Rebuild only the graph entries whose links changed; refill the size caches of every touched package.
+    for (const auto* links : {&delta.addedLinks, &delta.removedLinks}) {
+        for (const Link& link : *links) {
+            const Package* package = problemInstance.packages[link.package];
+            std::vector<const Dependency*>& entry = dependencyGraph[package];
+            entry.clear();
+            for (const auto& pair : package->getDependencies()) entry.push_back(pair.second);
+        }
+    }
+    for (const Package* package : touched) package->getDependenciesSize();
+
+    // 5. Put the bagged packages back with their new benefit and dependencies.
+    for (Package* package : rebag) bag->addPackageIfPossible(*package, INT_MAX, dependencyGraph.at(package));
+
+    return touched;
+}
+
+} // namespace INSTANCE_DELTA
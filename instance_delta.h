@@ -0,0 +1,84 @@
+#ifndef INSTANCE_DELTA_H
+#define INSTANCE_DELTA_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Bag;
+class Package;
+class Dependency;
+struct ProblemInstance;
+
+/**
+ * @brief Small edits to a loaded problem instance, applied in place.
+ *
+ * A catalog usually changes a little at a time: a benefit is revised, a
+ * dependency grows, a few links appear or disappear. Applying an
+ * InstanceDelta updates the instance, the solver's dependency graph and a
+ * previous solution Bag, touching only the entries reachable from the edit,
+ * so callers can re-optimize (see Algorithm::reoptimize) instead of
+ * reloading the instance and solving from scratch.
+ *
+ * Packages and dependencies are addressed by their index in the instance,
+ * the same indices used by problem files and solution reports.
+ */
+namespace INSTANCE_DELTA {
+
+struct BenefitChange {
+    int package;
+    int benefit;
+};
+
+struct SizeChange {
+    int dependency;
+    int size;
+};
+
+struct Link {
+    int package;
+    int dependency;
+};
+
+struct InstanceDelta {
+    std::vector<BenefitChange> benefitChanges;
+    std::vector<SizeChange> sizeChanges;
+    std::vector<Link> addedLinks;
+    std::vector<Link> removedLinks;
+    int capacity = -1; ///< New knapsack capacity; negative keeps the current one.
+
+    /**
+     * @brief Gets the number of individual edits in the delta.
+     */
+    [[nodiscard]] size_t size() const;
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    [[nodiscard]] std::string toString() const;
+};
+
+/**
+ * @brief Applies a delta to an instance, its dependency graph and (optionally) a Bag.
+ *
+ * Bagged packages affected by the edit are taken out of the bag before the
+ * instance changes and put back afterwards (capacity is not checked), so the
+ * bag's size and benefit match the edited instance. Only the graph entries of
+ * packages whose links changed are rebuilt.
+ *
+ * @param delta The edits to apply.
+ * @param problemInstance The instance to edit.
+ * @param dependencyGraph Graph built for problemInstance; patched in place.
+ * @param bag Solution over problemInstance's packages to keep consistent, or nullptr.
+ * @return The packages whose benefit or cost may have changed: packages with a new
+ *         benefit, and the packages of every resized or (un)linked dependency.
+ *         They are the candidate set of a focused local search after the edit.
+ * @throws std::runtime_error if the delta references an unknown package or dependency.
+ */
+std::vector<Package*> apply(const InstanceDelta& delta,
+                            ProblemInstance& problemInstance,
+                            std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+                            Bag* bag);
+
+} // namespace INSTANCE_DELTA
+
+#endif // INSTANCE_DELTA_H
@@ -2,19 +2,84 @@
 #include "ui_knapsackwindow.h"
 
 #include <memory>
+#include <algorithm>
 #include <exception>
 #include <chrono>
+#include <mutex>
+#include <random>
 
 #include <QString>
 #include <QFileDialog>
+#include <QDir>
+#include <QFile>
 #include <QMessageBox>
 #include <QDateTime>
 #include <QtConcurrent>
 #include <QLineEdit>
+#include <QTableWidgetItem>
+#include <QThread>
+#include <QHeaderView>
+#include <QInputDialog>
+#include <QCoreApplication>
 
 #include "file_processor.h"
 #include "algorithm.h"
 #include "bag.h"
+#include "package.h"
+#include "dependency.h"
+#include "instance_delta.h"
+#include "progress_channel.h"
+#include "perf_counters.h"
+#include "trace.h"
+#include "tuning.h"
+
+static constexpr int PROGRESS_DRAIN_INTERVAL_MS = 100;   // GUI refresh period for live progress
+static constexpr double THROUGHPUT_WINDOW_SECONDS = 1.0;  // moves/s averaging window
+
+/**
+ * @brief Seed of one execution: the base seed for the first, a seed_seq mix of (seed, execution) after.
+ */
+static unsigned int deriveExecutionSeed(unsigned int seed, int execution)
+{
+    if (execution == 0) return seed;
+    std::seed_seq sequence{seed, static_cast<unsigned int>(execution)};
+    unsigned int derived = 0;
+    sequence.generate(&derived, &derived + 1);
+    return derived;
+}
+
+/**
+ * @brief Path of the parameters written by "KnapsackProblem --tune" next to the executable, or empty.
+ */
+static std::string tunedParametersFile()
+{
+    const QString path = QDir(QCoreApplication::applicationDirPath()).filePath(TUNING::DEFAULT_PARAMETERS_FILE);
+    return QFileInfo::exists(path) ? path.toStdString() : std::string();
+}
+
+/**
+ * @brief Checkpoint path of one execution, next to the instance so a later session finds it.
+ *
+ * Seed and time budget are part of the name: a checkpoint only resumes the same execution.
+ */
+static std::string checkpointFile(const QString& instancePath, unsigned int seed, double maxTime)
+{
+    const QFileInfo instance(instancePath);
+    return instance.absoluteDir().filePath(QString("checkpoint-%1-seed%2-t%3.ckpt")
+                                               .arg(instance.completeBaseName())
+                                               .arg(seed)
+                                               .arg(static_cast<int>(maxTime))).toStdString();
+}
+
+// Job queue table columns
+static constexpr int JOB_COLUMN_FILE = 0;
+static constexpr int JOB_COLUMN_SEED = 1;
+static constexpr int JOB_COLUMN_TIME = 2;
+static constexpr int JOB_COLUMN_EXECUTIONS = 3;
+static constexpr int JOB_COLUMN_STATUS = 4;
+static constexpr int JOB_COLUMN_PROGRESS = 5;
+static constexpr int JOB_COLUMN_BEST = 6;
+static constexpr int JOB_COLUMN_COUNT = 7;
 
 knapsackWindow::knapsackWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -22,10 +87,16 @@ knapsackWindow::knapsackWindow(QWidget *parent)
 {
     ui->setupUi(this);
     initializeUi();
+    connect(&m_progressTimer, &QTimer::timeout, this, &knapsackWindow::drainProgress);
 }
 
 knapsackWindow::~knapsackWindow()
 {
+    // Queued jobs post to this window; let running ones stop at their next execution.
+    m_stopRequested = true;
+    m_jobPool.clear();
+    m_jobPool.waitForDone();
+    PROGRESS::channel().setEnabled(false);
     delete ui;
 }
 
@@ -39,6 +110,122 @@ void knapsackWindow::initializeUi()
     ui->spinBox_algorithmSeed->setValue(75);
     ui->spinBox_executionTimes->setRange(1, 100);
     ui->spinBox_executionTimes->setValue(1);
+    m_progressTimer.setInterval(PROGRESS_DRAIN_INTERVAL_MS);
+
+    const int idealThreads = std::max(1, QThread::idealThreadCount());
+    ui->spinBox_jobSeeds->setRange(1, 100);
+    ui->spinBox_jobSeeds->setValue(1);
+    ui->spinBox_parallelJobs->setRange(1, idealThreads);
+    ui->spinBox_parallelJobs->setValue(std::max(1, idealThreads / 2));
+    ui->tableWidget_jobs->setColumnCount(JOB_COLUMN_COUNT);
+    ui->tableWidget_jobs->setHorizontalHeaderLabels(
+        {"Instance", "Seed", "Time (s)", "Executions", "Status", "Progress", "Best"});
+    ui->tableWidget_jobs->horizontalHeader()->setSectionResizeMode(JOB_COLUMN_FILE, QHeaderView::Stretch);
+    ui->tableWidget_jobs->setEditTriggers(QAbstractItemView::NoEditTriggers);
+}
+
+void knapsackWindow::startProgressStream(int maxExecutions)
+{
+    m_runStart = std::chrono::steady_clock::now();
+    m_throughput.clear();
+    m_activeSeries.clear();
+    m_bestSeries.clear();
+    m_bestBenefit = 0;
+    m_finishedResults = 0;
+    m_expectedResults = std::max(1, maxExecutions * Algorithm::RESULT_BAG_COUNT);
+    ui->widget_convergence->clear();
+    ui->label_liveStatus->clear();
+    acquireProgressStream();
+}
+
+void knapsackWindow::acquireProgressStream()
+{
+    if (m_progressStreams++ > 0) return;
+    PROGRESS::channel().setEnabled(true);
+    m_progressTimer.start();
+}
+
+void knapsackWindow::releaseProgressStream()
+{
+    if (--m_progressStreams > 0) return;
+    PROGRESS::channel().setEnabled(false);
+    m_progressTimer.stop();
+    drainProgress();
+}
+
+void knapsackWindow::drainProgress()
+{
+    auto secondsSinceStart = [this](const std::chrono::steady_clock::time_point& time) {
+        return std::chrono::duration<double>(time - m_runStart).count();
+    };
+
+    PROGRESS::channel().drain([&](const PROGRESS::ProgressEvent& event) {
+        // Tagged events belong to queued jobs: tag = job index + 1.
+        if (event.tag > 0) {
+            const int jobIndex = event.tag - 1;
+            if (jobIndex >= m_jobs.size()) return;
+            QueuedJob& job = m_jobs[jobIndex];
+            if (event.benefit > job.bestBenefit) {
+                job.bestBenefit = event.benefit;
+                setJobCell(jobIndex, JOB_COLUMN_BEST, QString::number(job.bestBenefit));
+            }
+            if (event.kind == PROGRESS::EventKind::FINISHED) {
+                ++job.finishedResults;
+                const int expected = std::max(1, job.executions * Algorithm::RESULT_BAG_COUNT);
+                setJobCell(jobIndex, JOB_COLUMN_PROGRESS,
+                           QString("%1%").arg(std::min(100, 100 * job.finishedResults / expected)));
+            }
+            return;
+        }
+
+        QString series = QString::fromStdString(ALGORITHM::toString(event.algorithm));
+        const bool perMovement = event.algorithm == ALGORITHM::ALGORITHM_TYPE::GRASP ||
+                                 event.algorithm == ALGORITHM::ALGORITHM_TYPE::GRASP_VNS;
+        if (perMovement)
+            series += " " + QString::fromStdString(SEARCH_ENGINE::toString(event.movement));
+
+        if (event.benefit > m_bestBenefit) {
+            m_bestBenefit = event.benefit;
+            m_bestSeries = series;
+        }
+
+        if (event.kind == PROGRESS::EventKind::FINISHED) {
+            ++m_finishedResults;
+            return;
+        }
+
+        m_activeSeries = series;
+        ui->widget_convergence->addPoint(series, secondsSinceStart(event.time), event.benefit);
+
+        auto throughput = m_throughput.find(series);
+        if (throughput == m_throughput.end())
+            throughput = m_throughput.insert(series, Throughput{0, secondsSinceStart(event.time), 0.0});
+        throughput->moves += event.moves;
+    });
+
+    // Close throughput windows that are older than a second.
+    const double now = secondsSinceStart(std::chrono::steady_clock::now());
+    for (Throughput& throughput : m_throughput) {
+        const double elapsed = now - throughput.windowStart;
+        if (elapsed >= THROUGHPUT_WINDOW_SECONDS) {
+            throughput.movesPerSecond = throughput.moves / elapsed;
+            throughput.moves = 0;
+            throughput.windowStart = now;
+        }
+    }
+
+    const int progressValue = static_cast<int>((100.0 * m_finishedResults) / m_expectedResults);
+    ui->progressBar->setValue(std::max(ui->progressBar->value(), std::min(100, progressValue)));
+
+    QString status = QString("Best: %1 (%2)").arg(m_bestBenefit).arg(m_bestSeries);
+    if (!m_activeSeries.isEmpty()) {
+        status += QString(" | Running: %1 at %2 moves/s")
+                      .arg(m_activeSeries)
+                      .arg(m_throughput.value(m_activeSeries).movesPerSecond, 0, 'f', 0);
+    }
+    const long long dropped = PROGRESS::channel().droppedEvents();
+    if (dropped > 0) status += QString(" | Dropped events: %1").arg(dropped);
+    ui->label_liveStatus->setText(status);
 }
 
 void knapsackWindow::on_pushButton_problemFile_clicked()
@@ -71,7 +258,10 @@ void knapsackWindow::on_pushButton_findBag_clicked()
     // --- Disable UI elements ---
     ui->pushButton_findBag->setEnabled(false);
     ui->pushButton_problemFile->setEnabled(false);
+    ui->pushButton_reoptimize->setEnabled(false);
+    ui->pushButton_sweep->setEnabled(false);
     ui->pushButton_stop->setEnabled(true);
+    setQueueControlsEnabled(false);
     m_stopRequested = false;
 
     // --- Set display formats once ---
@@ -91,43 +281,111 @@ void knapsackWindow::on_pushButton_findBag_clicked()
     QString folderPath = fileInfo.absolutePath();
     QString fileName = fileInfo.fileName();
 
+    // Warm start from the selected report, else from the best report saved next to the instance
+    std::string warmStartPath;
+    if (ui->checkBox_warmStart->isChecked()) {
+        QFileInfo reportInfo(ui->pushButton_reportFile->text());
+        warmStartPath = (reportInfo.isFile() ? reportInfo.absoluteFilePath() : folderPath).toStdString();
+    }
+
+    const std::string tunedParameters = tunedParametersFile();
+    const bool hardwareCounters = ui->checkBox_hardwareCounters->isChecked();
+    const bool traceTimeline = ui->checkBox_trace->isChecked();
+    const bool pinThreads = ui->checkBox_pinThreads->isChecked();
+    const bool checkpointing = ui->checkBox_checkpoint->isChecked();
+    const bool portfolio = ui->checkBox_portfolio->isChecked();
+    const bool parallelVND = ui->checkBox_parallelVND->isChecked();
+    const bool calibrate = ui->checkBox_calibrate->isChecked();
+
     ProblemInstance problemCopy = m_problemInstance;
     auto start_time = std::chrono::steady_clock::now();
+    startProgressStream(maxExecutions);
+
+    // --- Execution schedule: independent executions share the cores with GRASP's own workers ---
+    const int idealThreads = std::max(1, QThread::idealThreadCount());
+    const int concurrentExecutions = std::min(maxExecutions, idealThreads);
+    const unsigned int threadsPerExecution = static_cast<unsigned int>(std::max(1, idealThreads / concurrentExecutions));
+    const int waves = (maxExecutions + concurrentExecutions - 1) / concurrentExecutions;
 
     // --- Run algorithm in background ---
     m_future = QtConcurrent::run([=, this]() mutable {
 
         auto resetUI = [this]() {
             QMetaObject::invokeMethod(this, [=]() {
+                releaseProgressStream();
+                setQueueControlsEnabled(true);
                 ui->pushButton_stop->setText("Stop");
                 ui->pushButton_stop->setEnabled(false);
                 ui->pushButton_findBag->setEnabled(true);
                 ui->pushButton_problemFile->setEnabled(true);
+                ui->pushButton_reoptimize->setEnabled(true);
+                ui->pushButton_sweep->setEnabled(true);
                 ui->progressBar->setValue(0);
             }, Qt::QueuedConnection);
         };
 
-        Algorithm algorithm(maxExecutionTime - 1, seed);
-        std::unique_ptr<Bag> bestBagOverall = nullptr;
-        int bestBenefitOverall = std::numeric_limits<int>::min();
+        // Fill the packages' lazy size caches before executions read them from several threads
+        // (the lambda owns a deep copy of the instance, so this must happen here).
+        for (const Package* package : problemCopy.getPackages()) package->getDependenciesSize();
 
-        for (int execution = 0; execution < maxExecutions; ++execution) {
-            if (m_stopRequested) break;
+        std::mutex saveMutex;
+        std::atomic<int> completedExecutions{0};
+        std::atomic<bool> estimatePublished{false};
+
+        auto runExecution = [&](int execution) {
+            if (m_stopRequested) return;
             std::string executionNumber = std::to_string(execution + 1);
 
             auto exec_start = std::chrono::steady_clock::now();
 
-            // Run algorithm
-            auto resultBags = algorithm.run(problemCopy, timestamp);
+            // Run algorithm: every execution owns its Algorithm and a seed derived from the base seed
+            const unsigned int executionSeed = deriveExecutionSeed(seed, execution);
+            const std::string checkpoint = checkpointing
+                ? checkpointFile(fileInfo.absoluteFilePath(), executionSeed, maxExecutionTime) : std::string();
+            Algorithm algorithm(maxExecutionTime - 1, executionSeed);
+            algorithm.setCheckpoint(checkpoint, true);
+            algorithm.setThreadBudget(threadsPerExecution);
+            algorithm.setWarmStart(warmStartPath, fileName.toStdString());
+            algorithm.setTunedParameters(tunedParameters);
+            algorithm.setAutoCalibration(calibrate);
+            algorithm.setHardwareCounters(hardwareCounters);
+            algorithm.setThreadPinning(pinThreads);
+            algorithm.setPortfolio(portfolio);
+            algorithm.setParallelVND(parallelVND);
+            algorithm.setCancelToken(&m_stopRequested);
+
+            // --- Save each bag as its algorithm finishes, so a stopped execution keeps them ---
+            algorithm.setResultCallback([&](const RESULT_STREAM::Result& result) {
+                if (result.bag->getSize() <= 0) return;
+                const auto bag = std::make_unique<Bag>(*result.bag);
+                std::lock_guard<std::mutex> lock(saveMutex);
+                // Save detailed report
+                FILE_PROCESSOR::saveReport(
+                    bag,
+                    problemCopy.getPackages(),
+                    problemCopy.getDependencies(),
+                    timestamp,
+                    folderPath.toStdString(),
+                    fileName.toStdString(),
+                    executionNumber
+                );
+
+                // Save summary CSV (single bag)
+                FILE_PROCESSOR::saveData(bag, folderPath.toStdString(), fileName.toStdString(), executionNumber);
+            });
+            algorithm.run(problemCopy, timestamp);
+
+            // A stopped execution resumes from its checkpoint next time; a finished one starts over.
+            if (!checkpoint.empty() && !m_stopRequested) QFile::remove(QString::fromStdString(checkpoint));
 
             auto exec_end = std::chrono::steady_clock::now();
             auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
                 exec_end - exec_start
             );
 
-            // Estimate total time based on first execution
-            if (execution == 0) {
-                auto estimatedTotalMs = elapsedMs.count() * maxExecutions;
+            // Estimate total time from the first finished execution and the number of waves
+            if (!estimatePublished.exchange(true)) {
+                auto estimatedTotalMs = elapsedMs.count() * waves;
                 QMetaObject::invokeMethod(this, [=]() {
                     ui->timeEdit_estimatedTotalTime->setTime(
                         QTime::fromMSecsSinceStartOfDay(static_cast<int>(estimatedTotalMs % 86400000))
@@ -135,27 +393,18 @@ void knapsackWindow::on_pushButton_findBag_clicked()
                 }, Qt::QueuedConnection);
             }
 
-            // --- Save all bags in this execution ---
-        for (const std::unique_ptr<Bag>& bag : resultBags) {
-            if (bag && bag->getSize() > 0) {
-                // Save detailed report
-                std::string reportPath = FILE_PROCESSOR::saveReport(
-                    bag,
-                    m_problemInstance.getPackages(),
-                    m_problemInstance.getDependencies(),
-                    timestamp,
-                    folderPath.toStdString(),
-                    fileName.toStdString(),
-                    executionNumber
-                );
-
-                // Save summary CSV (single bag)
-                FILE_PROCESSOR::saveData(bag, folderPath.toStdString(), fileName.toStdString(), executionNumber);
+            // --- Save the counters of this execution (its bags were saved as they finished) ---
+            if (auto counters = algorithm.getHardwareCounters()) {
+                std::lock_guard<std::mutex> lock(saveMutex);
+                FILE_PROCESSOR::saveHardwareCounters(*counters, timestamp, folderPath.toStdString(),
+                                                     fileName.toStdString(), executionNumber);
             }
-        }
+
             // --- Update progress ---
-            int progressValue = static_cast<int>((100.0 * (execution + 1)) / maxExecutions);
-            QMetaObject::invokeMethod(ui->progressBar, "setValue", Qt::QueuedConnection, Q_ARG(int, progressValue));
+            int progressValue = static_cast<int>((100.0 * (completedExecutions.fetch_add(1) + 1)) / maxExecutions);
+            QMetaObject::invokeMethod(this, [=]() {
+                ui->progressBar->setValue(std::max(ui->progressBar->value(), progressValue));
+            }, Qt::QueuedConnection);
 
             // --- Update elapsed time ---
             auto now = std::chrono::steady_clock::now();
@@ -165,6 +414,30 @@ void knapsackWindow::on_pushButton_findBag_clicked()
                     QTime::fromMSecsSinceStartOfDay(static_cast<int>(durationMs % 86400000))
                 );
             }, Qt::QueuedConnection);
+        };
+
+        if (traceTimeline) TRACE::start();
+        QThreadPool executionPool;
+        executionPool.setMaxThreadCount(concurrentExecutions);
+        for (int execution = 0; execution < maxExecutions; ++execution) {
+            executionPool.start([&runExecution, execution]() { runExecution(execution); });
+        }
+        executionPool.waitForDone();
+
+        // --- Timeline of all executions, next to the reports ---
+        if (traceTimeline) {
+            TRACE::stop();
+            const QString tracePath = QDir(folderPath).filePath(
+                "trace-" + fileInfo.completeBaseName() + "-" +
+                QString::fromStdString(FILE_PROCESSOR::formatTimestampForFileName(timestamp)) + ".json");
+            try {
+                TRACE::writeChromeJson(tracePath.toStdString());
+            } catch (const std::exception& e) {
+                const QString error = e.what();
+                QMetaObject::invokeMethod(this, [=]() {
+                    QMessageBox::critical(this, "Error", QString("Failed to write trace:\n%1").arg(error));
+                }, Qt::QueuedConnection);
+            }
         }
 
         resetUI();
@@ -214,3 +487,355 @@ void knapsackWindow::on_pushButton_validateReport_clicked()
     QMessageBox::information(this, "Report Validation", "Validation finished!");
 }
 
+void knapsackWindow::on_pushButton_reoptimize_clicked()
+{
+    QFileInfo reportInfo(ui->pushButton_reportFile->text());
+    if (m_problemInstance.getPackages().empty() || !reportInfo.isFile()) {
+        QMessageBox::information(this, "Re-optimize", "Select an instance and the report to start from first.");
+        return;
+    }
+    const QString deltaFile = QFileDialog::getOpenFileName(
+        this,
+        tr("Open Instance Delta"),
+        reportInfo.absolutePath(),
+        tr("Text Files (*.txt)")
+    );
+    if (deltaFile.isEmpty()) return;
+
+    QTime time = ui->timeEdit_maxExecutionTime->time();
+    const double maxExecutionTime = time.minute() * 60 + time.second();
+    const int seed = ui->spinBox_algorithmSeed->value();
+    const QFileInfo problemInfo(ui->pushButton_problemFile->text());
+    const std::string reportFile = reportInfo.absoluteFilePath().toStdString();
+    const bool parallelVND = ui->checkBox_parallelVND->isChecked();
+    auto edited = std::make_shared<ProblemInstance>(m_problemInstance);
+
+    ui->pushButton_reoptimize->setEnabled(false);
+    ui->pushButton_findBag->setEnabled(false);
+
+    m_future = QtConcurrent::run([=, this]() {
+        QString error;
+        std::shared_ptr<Bag> reoptimized;
+        std::string reportPath;
+        try {
+            INSTANCE_DELTA::InstanceDelta delta = FILE_PROCESSOR::loadInstanceDelta(deltaFile.toStdString());
+
+            // The previous best is rebuilt on the copy, before the edit is applied to it.
+            std::unordered_map<const Package*, std::vector<const Dependency*>> dependencyGraph;
+            for (const Package* package : edited->getPackages()) {
+                auto& dependencies = dependencyGraph[package];
+                for (const auto& pair : package->getDependencies()) dependencies.push_back(pair.second);
+            }
+            SolutionReport report = FILE_PROCESSOR::loadReport(reportFile);
+            auto previousBest = FILE_PROCESSOR::bagFromReport(report, edited->getPackages(), dependencyGraph,
+                                                              edited->maxCapacity, seed);
+
+            const std::string timestamp = QDateTime::currentDateTime().toString("yyyy:MM:dd HH:mm:ss:ms").toStdString();
+            Algorithm algorithm(maxExecutionTime, seed);
+            algorithm.setParallelVND(parallelVND);
+            std::unique_ptr<Bag> result = algorithm.reoptimize(*edited, delta, *previousBest, timestamp);
+            reportPath = FILE_PROCESSOR::saveReport(result, edited->getPackages(), edited->getDependencies(), timestamp,
+                                                    problemInfo.absolutePath().toStdString(),
+                                                    problemInfo.fileName().toStdString(), "reoptimized");
+            reoptimized = std::move(result);
+        } catch (const std::exception &e) {
+            error = e.what();
+        }
+
+        QMetaObject::invokeMethod(this, [=, this]() {
+            ui->pushButton_reoptimize->setEnabled(true);
+            ui->pushButton_findBag->setEnabled(true);
+            if (!reoptimized) {
+                QMessageBox::critical(this, "Error", QString("Failed to re-optimize:\n%1").arg(error));
+                return;
+            }
+
+            // The edited instance replaces the loaded one, so further deltas chain on the new report.
+            m_problemInstance = *edited;
+            ui->plainTextEdit_problem->setPlainText(QString::fromStdString(m_problemInstance.toString()));
+            if (!reportPath.empty()) ui->pushButton_reportFile->setText(QString::fromStdString(reportPath));
+            ui->plainTextEdit_report->setPlainText(QString::fromStdString(reoptimized->toString()));
+            QMessageBox::information(this, "Re-optimize",
+                                     QString("Benefit %1 after the edit (%2 s).\nThe edited instance is kept in memory only.")
+                                         .arg(reoptimized->getBenefit())
+                                         .arg(reoptimized->getAlgorithmTime(), 0, 'f', 3));
+        }, Qt::QueuedConnection);
+    });
+}
+
+void knapsackWindow::on_pushButton_sweep_clicked()
+{
+    if (m_problemInstance.getPackages().empty()) {
+        QMessageBox::information(this, "Capacity Sweep", "Select an instance first.");
+        return;
+    }
+
+    // "from to step": from > to sweeps downwards (repairing), from < to upwards (adding).
+    const int capacity = m_problemInstance.maxCapacity;
+    bool ok = false;
+    const QString range = QInputDialog::getText(
+        this, "Capacity Sweep", "Capacities (from to step):", QLineEdit::Normal,
+        QString("%1 %2 %3").arg(capacity / 2).arg(capacity * 3 / 2).arg(std::max(1, capacity / 10)), &ok);
+    if (!ok) return;
+
+    const QStringList fields = range.split(' ', Qt::SkipEmptyParts);
+    int from = 0, to = 0, step = 0;
+    if (fields.size() == 3) {
+        from = fields[0].toInt();
+        to = fields[1].toInt();
+        step = std::abs(fields[2].toInt());
+    }
+    if (step == 0 || from < 0 || to < 0) {
+        QMessageBox::critical(this, "Error", "Expected three numbers: from, to and a non-zero step.");
+        return;
+    }
+    std::vector<int> capacities;
+    for (int c = from; from <= to ? c <= to : c >= to; c += from <= to ? step : -step) capacities.push_back(c);
+
+    QTime time = ui->timeEdit_maxExecutionTime->time();
+    const double maxExecutionTime = time.minute() * 60 + time.second();
+    const int seed = ui->spinBox_algorithmSeed->value();
+    const QFileInfo problemInfo(ui->pushButton_problemFile->text());
+    const std::string timestamp = QDateTime::currentDateTime().toString("yyyy:MM:dd HH:mm:ss:ms").toStdString();
+    auto problemCopy = std::make_shared<ProblemInstance>(m_problemInstance);
+
+    ui->pushButton_sweep->setEnabled(false);
+    ui->pushButton_findBag->setEnabled(false);
+
+    m_future = QtConcurrent::run([=, this]() {
+        Algorithm algorithm(maxExecutionTime, seed);
+        auto curve = algorithm.sweepCapacity(*problemCopy, capacities, timestamp);
+        const std::string csvPath = FILE_PROCESSOR::saveCapacityCurve(curve, capacities,
+                                                                      problemInfo.absolutePath().toStdString(),
+                                                                      problemInfo.fileName().toStdString());
+        QString summary = "Capacity -> Benefit\n";
+        for (size_t i = 0; i < curve.size(); ++i)
+            summary += QString("%1 -> %2\n").arg(capacities[i]).arg(curve[i]->getBenefit());
+
+        QMetaObject::invokeMethod(this, [=, this]() {
+            ui->pushButton_sweep->setEnabled(true);
+            ui->pushButton_findBag->setEnabled(true);
+            ui->plainTextEdit_report->setPlainText(summary);
+            QMessageBox::information(this, "Capacity Sweep",
+                                     QString("Solved %1 capacities.\nCurve saved to %2")
+                                         .arg(capacities.size()).arg(QString::fromStdString(csvPath)));
+        }, Qt::QueuedConnection);
+    });
+}
+
+// =============================================================
+// == Job Queue
+// =============================================================
+void knapsackWindow::setQueueControlsEnabled(bool enabled)
+{
+    ui->pushButton_addJobs->setEnabled(enabled);
+    ui->pushButton_runQueue->setEnabled(enabled);
+    ui->pushButton_clearQueue->setEnabled(enabled);
+}
+
+void knapsackWindow::setJobCell(int jobIndex, int column, const QString& text)
+{
+    QTableWidgetItem* item = ui->tableWidget_jobs->item(jobIndex, column);
+    if (!item) {
+        item = new QTableWidgetItem();
+        ui->tableWidget_jobs->setItem(jobIndex, column, item);
+    }
+    item->setText(text);
+}
+
+void knapsackWindow::addJobRow(int jobIndex)
+{
+    const QueuedJob& job = m_jobs[jobIndex];
+    ui->tableWidget_jobs->insertRow(jobIndex);
+    setJobCell(jobIndex, JOB_COLUMN_FILE, QFileInfo(job.problemFile).fileName());
+    setJobCell(jobIndex, JOB_COLUMN_SEED, QString::number(job.seed));
+    setJobCell(jobIndex, JOB_COLUMN_TIME, QString::number(job.maxTime));
+    setJobCell(jobIndex, JOB_COLUMN_EXECUTIONS, QString::number(job.executions));
+    setJobCell(jobIndex, JOB_COLUMN_STATUS, "Pending");
+    setJobCell(jobIndex, JOB_COLUMN_PROGRESS, "0%");
+    setJobCell(jobIndex, JOB_COLUMN_BEST, "-");
+}
+
+void knapsackWindow::on_pushButton_addJobs_clicked()
+{
+    const QStringList problemFiles = QFileDialog::getOpenFileNames(
+        this,
+        tr("Add Instances"),
+        "./../input/",
+        tr("Text Files (*.txt);;Knapsack Files (*.knapsack)")
+    );
+    if (problemFiles.isEmpty()) return;
+
+    // Every selected file is queued once per seed, with the current time budget.
+    QTime time = ui->timeEdit_maxExecutionTime->time();
+    const double maxExecutionTime = time.minute() * 60 + time.second();
+    const int firstSeed = ui->spinBox_algorithmSeed->value();
+    const int seeds = ui->spinBox_jobSeeds->value();
+    const int executions = ui->spinBox_executionTimes->value();
+
+    for (const QString& problemFile : problemFiles) {
+        for (int s = 0; s < seeds; ++s) {
+            QueuedJob job;
+            job.problemFile = problemFile;
+            job.seed = firstSeed + s;
+            job.maxTime = maxExecutionTime;
+            job.executions = executions;
+            if (ui->checkBox_warmStart->isChecked()) job.warmStartPath = QFileInfo(problemFile).absolutePath();
+            job.tunedParametersFile = QString::fromStdString(tunedParametersFile());
+            job.checkpoint = ui->checkBox_checkpoint->isChecked();
+            job.portfolio = ui->checkBox_portfolio->isChecked();
+            job.parallelVND = ui->checkBox_parallelVND->isChecked();
+            job.calibrate = ui->checkBox_calibrate->isChecked();
+            m_jobs.push_back(job);
+            addJobRow(m_jobs.size() - 1);
+        }
+    }
+}
+
+void knapsackWindow::on_pushButton_clearQueue_clicked()
+{
+    m_jobs.clear();
+    ui->tableWidget_jobs->setRowCount(0);
+}
+
+void knapsackWindow::on_pushButton_runQueue_clicked()
+{
+    QVector<int> pendingJobs;
+    for (int i = 0; i < m_jobs.size(); ++i)
+        if (m_jobs[i].pending) pendingJobs.push_back(i);
+    if (pendingJobs.isEmpty()) {
+        QMessageBox::information(this, "Job Queue", "There are no pending jobs.");
+        return;
+    }
+
+    std::string timestamp = QDateTime::currentDateTime()
+                                .toString("yyyy:MM:dd HH:mm:ss:ms")
+                                .toStdString();
+
+    // --- One unique output directory per instance, created up front on the GUI thread ---
+    QMap<QString, std::shared_ptr<JobOutput>> outputs;
+    for (int jobIndex : pendingJobs) {
+        const QString& problemFile = m_jobs[jobIndex].problemFile;
+        if (outputs.contains(problemFile)) continue;
+        QFileInfo fileInfo(problemFile);
+        auto output = std::make_shared<JobOutput>();
+        try {
+            output->directory = FILE_PROCESSOR::createUniqueOutputDir(
+                (fileInfo.absolutePath() + "/output-" + fileInfo.completeBaseName()).toStdString());
+        } catch (const std::exception &e) {
+            QMessageBox::critical(this, "Error", QString("Failed to create output directory for %1:\n%2")
+                                                     .arg(fileInfo.fileName()).arg(e.what()));
+            return;
+        }
+        outputs.insert(problemFile, output);
+    }
+
+    // --- Disable UI elements ---
+    setQueueControlsEnabled(false);
+    ui->pushButton_findBag->setEnabled(false);
+    ui->pushButton_stop->setEnabled(true);
+    m_stopRequested = false;
+
+    // Parallel jobs split the cores instead of each sizing its workers for the whole machine.
+    const int parallelJobs = ui->spinBox_parallelJobs->value();
+    const unsigned int threadsPerJob = static_cast<unsigned int>(
+        std::max(1, std::max(1, QThread::idealThreadCount()) / parallelJobs));
+    m_jobPool.setMaxThreadCount(parallelJobs);
+    acquireProgressStream();
+    m_runningJobs += pendingJobs.size();
+
+    for (int jobIndex : pendingJobs) {
+        QueuedJob& job = m_jobs[jobIndex];
+        job.pending = false;
+        job.finishedResults = 0;
+        job.bestBenefit = 0;
+        setJobCell(jobIndex, JOB_COLUMN_STATUS, "Queued");
+        std::shared_ptr<JobOutput> output = outputs.value(job.problemFile);
+        m_jobPool.start([this, jobIndex, job, output, timestamp, threadsPerJob]() {
+            runJob(jobIndex, job, output, timestamp, threadsPerJob);
+        });
+    }
+}
+
+void knapsackWindow::runJob(int jobIndex, QueuedJob job, std::shared_ptr<JobOutput> output, std::string timestamp,
+                            unsigned int threadBudget)
+{
+    auto postStatus = [this, jobIndex](const QString& status, bool finished) {
+        QMetaObject::invokeMethod(this, [=]() {
+            setJobCell(jobIndex, JOB_COLUMN_STATUS, status);
+            if (finished) jobFinished();
+        }, Qt::QueuedConnection);
+    };
+
+    if (m_stopRequested) {
+        postStatus("Cancelled", true);
+        return;
+    }
+    postStatus("Running", false);
+
+    PROGRESS::ScopedTag progressTag(jobIndex + 1);
+    QString finalStatus = "Done";
+    try {
+        ProblemInstance problemInstance = FILE_PROCESSOR::loadProblem(job.problemFile.toStdString());
+        const std::string fileName = QFileInfo(job.problemFile).fileName().toStdString();
+
+        for (int execution = 0; execution < job.executions; ++execution) {
+            if (m_stopRequested) {
+                finalStatus = "Stopped";
+                break;
+            }
+
+            // Every execution owns its Algorithm and a seed derived from the job's, as in Find Bag
+            const unsigned int executionSeed = deriveExecutionSeed(job.seed, execution);
+            const std::string checkpoint = job.checkpoint
+                ? checkpointFile(job.problemFile, executionSeed, job.maxTime) : std::string();
+            Algorithm algorithm(job.maxTime - 1, executionSeed);
+            algorithm.setCheckpoint(checkpoint, true);
+            algorithm.setThreadBudget(threadBudget);
+            algorithm.setWarmStart(job.warmStartPath.toStdString(), fileName);
+            algorithm.setTunedParameters(job.tunedParametersFile.toStdString());
+            algorithm.setAutoCalibration(job.calibrate);
+            algorithm.setPortfolio(job.portfolio);
+            algorithm.setParallelVND(job.parallelVND);
+            algorithm.setCancelToken(&m_stopRequested);
+
+            // Seed and budget keep report names unique among the instance's jobs.
+            const std::string fileId = "seed" + std::to_string(job.seed) +
+                                       "-t" + std::to_string(static_cast<int>(job.maxTime)) +
+                                       "-" + std::to_string(execution + 1);
+
+            // --- Save each bag as its algorithm finishes, so a stopped job keeps them ---
+            algorithm.setResultCallback([&](const RESULT_STREAM::Result& result) {
+                if (result.bag->getSize() <= 0) return;
+                const auto bag = std::make_unique<Bag>(*result.bag);
+                std::lock_guard<std::mutex> lock(output->mutex);
+                FILE_PROCESSOR::saveReport(bag, problemInstance.getPackages(), problemInstance.getDependencies(),
+                                           timestamp, output->directory, fileName, fileId);
+                FILE_PROCESSOR::saveData(bag, output->directory, fileName, fileId);
+            });
+            algorithm.run(problemInstance, timestamp);
+            if (m_stopRequested) {
+                finalStatus = "Stopped";
+            } else if (!checkpoint.empty()) {
+                QFile::remove(QString::fromStdString(checkpoint));
+            }
+        }
+    } catch (const std::exception &e) {
+        finalStatus = QString("Failed: %1").arg(e.what());
+    } catch (...) {
+        finalStatus = "Failed";
+    }
+    postStatus(finalStatus, true);
+}
+
+void knapsackWindow::jobFinished()
+{
+    if (--m_runningJobs > 0) return;
+
+    releaseProgressStream();
+    setQueueControlsEnabled(true);
+    ui->pushButton_stop->setText("Stop");
+    ui->pushButton_stop->setEnabled(false);
+    ui->pushButton_findBag->setEnabled(true);
+    QMessageBox::information(this, "Job Queue", "All queued jobs finished.");
+}
@@ -5,6 +5,15 @@
 #include <atomic>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QTimer>
+#include <QMap>
+#include <QString>
+#include <QThreadPool>
+#include <QVector>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
 
 #include "data_model.h"
 
@@ -31,8 +40,60 @@ private slots:
 
     void on_pushButton_validateReport_clicked();
 
+    void on_pushButton_reoptimize_clicked();
+
+    void on_pushButton_sweep_clicked();
+
+    void on_pushButton_addJobs_clicked();
+
+    void on_pushButton_runQueue_clicked();
+
+    void on_pushButton_clearQueue_clicked();
+
+    void drainProgress();
+
 private:
     void initializeUi();
+    void startProgressStream(int maxExecutions);
+    void acquireProgressStream();
+    void releaseProgressStream();
+
+    /// One instance file x seed x time budget entry of the job queue.
+    struct QueuedJob {
+        QString problemFile;
+        int seed = 0;
+        double maxTime = 0.0;
+        int executions = 1;
+        QString warmStartPath;   ///< Directory searched for a warm-start report; empty = cold start.
+        QString tunedParametersFile; ///< Parameters from --tune; empty = built-in values.
+        bool checkpoint = false;     ///< Checkpoint every execution and resume a stopped one.
+        bool portfolio = false;      ///< Race VND, VNS and GRASP as one portfolio (Algorithm::setPortfolio).
+        bool parallelVND = false;    ///< Multi-start VND on several cores (Algorithm::setParallelVND).
+        bool calibrate = false;      ///< Size threads and iteration limits to the budget (Algorithm::setAutoCalibration).
+        bool pending = true;
+        int finishedResults = 0;
+        int bestBenefit = 0;
+    };
+
+    /// Output directory shared by all jobs of one instance; saves are serialized.
+    struct JobOutput {
+        std::string directory;
+        std::mutex mutex;
+    };
+
+    void addJobRow(int jobIndex);
+    void setJobCell(int jobIndex, int column, const QString& text);
+    void runJob(int jobIndex, QueuedJob job, std::shared_ptr<JobOutput> output, std::string timestamp,
+                unsigned int threadBudget);
+    void jobFinished();
+    void setQueueControlsEnabled(bool enabled);
+
+    /// Moves/s of one live series, measured over windows of about a second.
+    struct Throughput {
+        long long moves = 0;
+        double windowStart = 0.0;
+        double movesPerSecond = 0.0;
+    };
 
     Ui::knapsackWindow *ui;
     QFuture<void> m_future;
@@ -40,6 +101,22 @@ private:
     QFutureWatcher<void> m_watcher;
 
     ProblemInstance m_problemInstance;
+
+    // --- Live progress (drained from PROGRESS::channel() on the GUI thread) ---
+    QTimer m_progressTimer;
+    std::chrono::steady_clock::time_point m_runStart{};
+    QMap<QString, Throughput> m_throughput;
+    QString m_activeSeries;
+    QString m_bestSeries;
+    int m_bestBenefit = 0;
+    int m_finishedResults = 0;
+    int m_expectedResults = 1;
+    int m_progressStreams = 0;
+
+    // --- Job queue (jobs run on m_jobPool; the table is only touched on the GUI thread) ---
+    QVector<QueuedJob> m_jobs;
+    QThreadPool m_jobPool;
+    int m_runningJobs = 0;
 };
 
 #endif // KNAPSACKWINDOW_H
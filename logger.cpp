@@ -0,0 +1,222 @@
+#include "logger.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace LOGGER {
+
+// =====================================================================================
+// Tuning Constants
+// =====================================================================================
+static constexpr size_t THREAD_BUFFER_FLUSH_BYTES = 4096; // hand buffer to the sink past this size
+static constexpr std::chrono::milliseconds ASYNC_FLUSH_INTERVAL{100}; // async writer drains its queue this often
+
+// =====================================================================================
+// Runtime Level
+// =====================================================================================
+static int initialLevelFromEnvironment()
+{
+    const char* env = std::getenv("KNAPSACK_LOG_LEVEL");
+    if (!env) return static_cast<int>(Level::WARNING);
+
+    const std::string value(env);
+    for (Level level : {Level::TRACE, Level::DEBUG, Level::INFO, Level::WARNING, Level::CRITICAL, Level::OFF}) {
+        if (value == toString(level)) return static_cast<int>(level);
+    }
+    return static_cast<int>(Level::WARNING);
+}
+
+std::atomic<int> g_runtimeLevel{initialLevelFromEnvironment()};
+
+void setLevel(Level level)
+{
+    g_runtimeLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+Level getLevel()
+{
+    return static_cast<Level>(g_runtimeLevel.load(std::memory_order_relaxed));
+}
+
+std::string toString(Level level)
+{
+    switch (level) {
+        case Level::TRACE: return "TRACE";
+        case Level::DEBUG: return "DEBUG";
+        case Level::INFO: return "INFO";
+        case Level::WARNING: return "WARNING";
+        case Level::CRITICAL: return "CRITICAL";
+        default: return "OFF";
+    }
+}
+
+// =====================================================================================
+// Sink
+// =====================================================================================
+
+/**
+ * @brief Process-wide output sink; serializes writes to stdout.
+ *
+ * In asynchronous mode lines are appended to a queue and a writer thread
+ * drains it every ASYNC_FLUSH_INTERVAL, or at once for warnings and flushes.
+ * The mode flag is only read and changed under m_queueMutex, and the writer
+ * drains the queue before it exits, so no line is stranded when the mode is
+ * switched off while other threads are logging.
+ */
+class Sink {
+public:
+    static Sink& instance() {
+        static Sink sink;
+        return sink;
+    }
+
+    ~Sink() { setAsync(false); }
+
+    void write(const std::string& chunk) {
+        std::lock_guard<std::mutex> lock(m_writeMutex);
+        std::cout << chunk;
+        std::cout.flush();
+    }
+
+    /// Queues chunk for the writer thread; returns false (nothing queued) in synchronous mode.
+    bool enqueue(const std::string& chunk, bool urgent) {
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            if (!m_async) return false;
+            m_pending += chunk;
+            if (!urgent && m_pending.size() < THREAD_BUFFER_FLUSH_BYTES) return true;
+            m_urgent = true;
+        }
+        m_wake.notify_one();
+        return true;
+    }
+
+    /// Waits until everything queued so far has been written.
+    void drain() {
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        if (!m_async) return;
+        m_urgent = true;
+        m_wake.notify_one();
+        m_drained.wait(lock, [this] { return m_pending.empty() && !m_writing; });
+    }
+
+    void setAsync(bool enabled) {
+        std::lock_guard<std::mutex> control(m_controlMutex);
+        std::thread writer;
+        {
+            std::lock_guard<std::mutex> lock(m_queueMutex);
+            if (enabled == m_async) return;
+            m_async = enabled;
+            if (enabled) {
+                m_stop = false;
+                m_writer = std::thread(&Sink::writerLoop, this);
+                return;
+            }
+            m_stop = true;
+            writer = std::move(m_writer);
+        }
+        m_wake.notify_one();
+        writer.join();
+    }
+
+private:
+    Sink() {
+        const char* env = std::getenv("KNAPSACK_LOG_ASYNC");
+        if (env && std::strcmp(env, "1") == 0) setAsync(true);
+    }
+
+    void writerLoop() {
+        std::unique_lock<std::mutex> lock(m_queueMutex);
+        while (true) {
+            m_wake.wait_for(lock, ASYNC_FLUSH_INTERVAL, [this] { return m_stop || m_urgent; });
+            m_urgent = false;
+            if (!m_pending.empty()) {
+                std::string batch;
+                batch.swap(m_pending);
+                m_writing = true;
+                lock.unlock();
+                write(batch);
+                lock.lock();
+                m_writing = false;
+            }
+            m_drained.notify_all();
+            if (m_stop && m_pending.empty()) break;
+        }
+    }
+
+    std::mutex m_writeMutex;    ///< Serializes stdout.
+    std::mutex m_controlMutex;  ///< Serializes setAsync.
+    std::mutex m_queueMutex;    ///< Guards the fields below.
+    std::condition_variable m_wake;
+    std::condition_variable m_drained;
+    std::string m_pending;
+    bool m_async = false;
+    bool m_urgent = false;
+    bool m_writing = false;
+    bool m_stop = false;
+    std::thread m_writer;
+};
+
+void setAsyncSink(bool enabled)
+{
+    Sink::instance().setAsync(enabled);
+}
+
+// =====================================================================================
+// Per-thread Buffer
+// =====================================================================================
+
+/**
+ * @brief Accumulates finished lines of one thread; handed to the sink in batches.
+ */
+struct ThreadBuffer {
+    std::string data;
+
+    void flush() {
+        if (data.empty()) return;
+        Sink::instance().write(data);
+        data.clear();
+    }
+
+    ~ThreadBuffer() { flush(); }
+};
+
+static ThreadBuffer& threadBuffer()
+{
+    thread_local ThreadBuffer buffer;
+    return buffer;
+}
+
+void flush()
+{
+    threadBuffer().flush();
+    Sink::instance().drain();
+}
+
+// =====================================================================================
+// LineBuilder
+// =====================================================================================
+LineBuilder::LineBuilder(Level level)
+    : m_level(level)
+{
+    m_stream << '[' << toString(level) << "] ";
+}
+
+LineBuilder::~LineBuilder()
+{
+    m_stream << '\n';
+    // The asynchronous sink takes lines right away, so they are not held in the thread's buffer.
+    if (Sink::instance().enqueue(m_stream.str(), m_level >= Level::WARNING)) return;
+
+    ThreadBuffer& buffer = threadBuffer();
+    buffer.data += m_stream.str();
+    if (m_level >= Level::WARNING || buffer.data.size() >= THREAD_BUFFER_FLUSH_BYTES)
+        buffer.flush();
+}
+
+} // namespace LOGGER
@@ -0,0 +1,130 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+#include <sstream>
+#include <string>
+
+/**
+ * @brief Leveled logging for the solver hot paths.
+ *
+ * Log statements are gated twice:
+ *  - at compile time by KNAPSACK_LOG_COMPILE_LEVEL: statements below it are
+ *    discarded by `if constexpr` and generate no code at all;
+ *  - at run time by LOGGER::setLevel(): the check is a single relaxed atomic
+ *    load, and the message (including its formatting) is only built when the
+ *    level is enabled.
+ *
+ * Enabled lines are collected in a per-thread buffer and handed to the sink
+ * in batches, so worker threads do not fight over the stdout lock for every
+ * line. A thread's buffer reaches stdout when it holds 4096 bytes, when a
+ * WARNING or CRITICAL line is logged, when the thread calls flush() (as
+ * Algorithm::run does after every stage) or when the thread exits; until
+ * then DEBUG and INFO lines are only in memory.
+ *
+ * With the asynchronous sink (setAsyncSink, or KNAPSACK_LOG_ASYNC=1 in the
+ * environment) lines skip the thread buffer: they are queued and a background
+ * thread writes them at least every 100 ms, so output keeps up with a long
+ * solve without blocking the solver threads on stdout.
+ *
+ * Usage:
+ * @code
+ *   LOG_INFO("[REPAIR] size=" << bag.getSize() << " benefit=" << bag.getBenefit());
+ * @endcode
+ */
+namespace LOGGER {
+
+enum class Level : int {
+    TRACE = 0,
+    DEBUG = 1,
+    INFO = 2,
+    WARNING = 3,
+    CRITICAL = 4,
+    OFF = 5
+};
+
+/**
+ * @brief Sets the runtime log level. Messages below it are skipped.
+ *
+ * The initial level is read once from the KNAPSACK_LOG_LEVEL environment
+ * variable (TRACE, DEBUG, INFO, WARNING, CRITICAL or OFF) and defaults to WARNING.
+ */
+void setLevel(Level level);
+
+/**
+ * @brief Gets the current runtime log level.
+ */
+Level getLevel();
+
+/// Runtime level storage; read through isEnabled() so the check stays inline.
+extern std::atomic<int> g_runtimeLevel;
+
+/**
+ * @brief Checks whether messages of the given level are currently emitted.
+ */
+inline bool isEnabled(Level level) {
+    return static_cast<int>(level) >= g_runtimeLevel.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Switches between the synchronous sink and the asynchronous one.
+ *
+ * Switching it off waits until the background thread has written every
+ * queued line.
+ */
+void setAsyncSink(bool enabled);
+
+/**
+ * @brief Writes the calling thread's buffered lines to stdout and waits until
+ * the asynchronous sink, if enabled, has written everything queued so far.
+ */
+void flush();
+
+std::string toString(Level level);
+
+/**
+ * @brief Builds one log line and hands it to the thread's buffer or the asynchronous sink on destruction.
+ *
+ * Each line has its own stream, so a LOG call made while building another
+ * message (e.g. inside a streamed function call) does not clobber it.
+ *
+ * Not meant to be used directly; use the LOG_* macros instead.
+ */
+class LineBuilder {
+public:
+    explicit LineBuilder(Level level);
+    ~LineBuilder();
+
+    LineBuilder(const LineBuilder&) = delete;
+    LineBuilder& operator=(const LineBuilder&) = delete;
+
+    std::ostream& stream() { return m_stream; }
+
+private:
+    Level m_level;
+    std::ostringstream m_stream;
+};
+
+} // namespace LOGGER
+
+#ifndef KNAPSACK_LOG_COMPILE_LEVEL
+#define KNAPSACK_LOG_COMPILE_LEVEL 0
+#endif
+
+#define KNAPSACK_LOG(level, message)                                                  \
+    do {                                                                              \
+        if constexpr (static_cast<int>(level) >= KNAPSACK_LOG_COMPILE_LEVEL) {        \
+            if (LOGGER::isEnabled(level)) {                                           \
+                LOGGER::LineBuilder knapsackLogLine_(level);                          \
+                knapsackLogLine_.stream() << message;                                 \
+            }                                                                         \
+        }                                                                             \
+    } while (0)
+
+#define LOG_TRACE(message) KNAPSACK_LOG(LOGGER::Level::TRACE, message)
+#define LOG_DEBUG(message) KNAPSACK_LOG(LOGGER::Level::DEBUG, message)
+#define LOG_INFO(message) KNAPSACK_LOG(LOGGER::Level::INFO, message)
+#define LOG_WARNING(message) KNAPSACK_LOG(LOGGER::Level::WARNING, message)
+#define LOG_CRITICAL(message) KNAPSACK_LOG(LOGGER::Level::CRITICAL, message)
+
+#endif // LOGGER_H
@@ -1,11 +1,34 @@
 #include "knapsackWindow.h"
+#include "regression.h"
+#include "tuning.h"
 
 #include <QApplication>
 #include <QLocale>
 #include <QTranslator>
 
+#include <filesystem>
+#include <iostream>
+#include <string>
+
 int main(int argc, char *argv[])
 {
+    // Headless performance gate: KnapsackProblem --regression <record|check> [instance directory]
+    if (argc >= 2 && std::string(argv[1]) == "--regression") {
+        REGRESSION::Options options;
+        if (argc >= 4) options.instanceDir = argv[3];
+        return REGRESSION::runGate(argc >= 3 ? argv[2] : "", options, std::cout);
+    }
+
+    // Offline parameter tuning: KnapsackProblem --tune [instance directory] [output file]
+    if (argc >= 2 && std::string(argv[1]) == "--tune") {
+        TUNING::Options options;
+        if (argc >= 3) options.instanceDir = argv[2];
+        options.outputFile = argc >= 4
+            ? std::string(argv[3])
+            : (std::filesystem::absolute(argv[0]).parent_path() / TUNING::DEFAULT_PARAMETERS_FILE).string();
+        return TUNING::runTuning(options, std::cout);
+    }
+
     QApplication a(argc, argv);
 
     QTranslator translator;
@@ -0,0 +1,203 @@
+#include "move_evaluation_cache.h"
+
+#include <algorithm>
+
+#include "bag.h"
+#include "package.h"
+#include "dependency.h"
+
+namespace {
+
+int referenceCount(const Bag& bag, const Dependency* dependency)
+{
+    const auto& refCount = bag.getDependencyRefCount();
+    auto it = refCount.find(dependency);
+    return it == refCount.end() ? 0 : it->second;
+}
+
+} // namespace
+
+// =====================================================================================
+// DependencyUsers
+// =====================================================================================
+DependencyUsers::DependencyUsers(const DependencyGraph& dependencyGraph)
+    : m_dependencyGraph(dependencyGraph), m_graphSize(dependencyGraph.size())
+{
+}
+
+const std::vector<const Package*>& DependencyUsers::of(const Dependency* dependency)
+{
+    static const std::vector<const Package*> none;
+    build();
+    auto it = m_users.find(dependency);
+    return it == m_users.end() ? none : it->second;
+}
+
+bool DependencyUsers::matches(const DependencyGraph& dependencyGraph) const
+{
+    return &dependencyGraph == &m_dependencyGraph && dependencyGraph.size() == m_graphSize;
+}
+
+void DependencyUsers::relink(const Package* package, const Dependency* dependency)
+{
+    if (!m_built) return;
+    auto graphEntry = m_dependencyGraph.find(package);
+    const bool linked = graphEntry != m_dependencyGraph.end() &&
+        std::find(graphEntry->second.begin(), graphEntry->second.end(), dependency) != graphEntry->second.end();
+
+    std::vector<const Package*>& users = m_users[dependency];
+    auto it = std::find(users.begin(), users.end(), package);
+    if (linked && it == users.end()) users.push_back(package);
+    if (!linked && it != users.end()) users.erase(it);
+}
+
+void DependencyUsers::build()
+{
+    if (m_built) return;
+    for (const auto& [package, dependencies] : m_dependencyGraph) {
+        for (const Dependency* dependency : dependencies) m_users[dependency].push_back(package);
+    }
+    m_built = true;
+}
+
+// =====================================================================================
+// MoveEvaluationCache
+// =====================================================================================
+MoveEvaluationCache::MoveEvaluationCache(const DependencyGraph& dependencyGraph, DependencyUsers& users)
+    : m_dependencyGraph(dependencyGraph), m_users(users)
+{
+}
+
+// =====================================================================================
+// 1-1 Swaps
+// =====================================================================================
+int MoveEvaluationCache::swapSizeChange(const Bag& bag, const Package* packageIn, const Package* packageOut) const
+{
+    // Same result as Bag::canSwapReadOnly, without copying the reference counts.
+    const std::vector<const Dependency*>& dependenciesIn = dependenciesOf(packageIn);
+    int sizeChange = 0;
+    for (const Dependency* dependency : dependenciesIn) {
+        if (referenceCount(bag, dependency) == 1) sizeChange -= dependency->getSize();
+    }
+    for (const Dependency* dependency : dependenciesOf(packageOut)) {
+        const int count = referenceCount(bag, dependency);
+        const bool freed = count == 1 &&
+            std::find(dependenciesIn.begin(), dependenciesIn.end(), dependency) != dependenciesIn.end();
+        if (count == 0 || freed) sizeChange += dependency->getSize();
+    }
+    return sizeChange;
+}
+
+int MoveEvaluationCache::moveSizeChange(const Bag& bag, std::initializer_list<const Package*> packagesIn,
+                                        std::initializer_list<const Package*> packagesOut) const
+{
+    auto contains = [](const std::vector<const Dependency*>& dependencies, const Dependency* dependency) {
+        return std::find(dependencies.begin(), dependencies.end(), dependency) != dependencies.end();
+    };
+    // References the removed packages hold on a dependency.
+    auto removedReferences = [&](const Dependency* dependency) {
+        int references = 0;
+        for (const Package* package : packagesIn) references += contains(dependenciesOf(package), dependency);
+        return references;
+    };
+    // True if an earlier package of the list already accounted for the dependency.
+    auto seenBefore = [&](std::initializer_list<const Package*> packages, const Package* current,
+                          const Dependency* dependency) {
+        for (const Package* package : packages) {
+            if (package == current) return false;
+            if (contains(dependenciesOf(package), dependency)) return true;
+        }
+        return false;
+    };
+
+    int sizeChange = 0;
+    for (const Package* package : packagesIn) {
+        for (const Dependency* dependency : dependenciesOf(package)) {
+            if (seenBefore(packagesIn, package, dependency)) continue;
+            if (referenceCount(bag, dependency) == removedReferences(dependency)) sizeChange -= dependency->getSize();
+        }
+    }
+    for (const Package* package : packagesOut) {
+        for (const Dependency* dependency : dependenciesOf(package)) {
+            if (seenBefore(packagesOut, package, dependency)) continue;
+            if (referenceCount(bag, dependency) == removedReferences(dependency)) sizeChange += dependency->getSize();
+        }
+    }
+    return sizeChange;
+}
+
+// =====================================================================================
+// Ejection Chains
+// =====================================================================================
+const MoveEvaluationCache::EjectionChain& MoveEvaluationCache::ejectionChain(const Bag& bag, const Package* trigger)
+{
+    auto it = m_chains.find(trigger);
+    if (it != m_chains.end()) return it->second;
+
+    const auto& packagesInBag = bag.getPackages();
+    EjectionChain chain;
+    std::unordered_map<const Dependency*, int> decrements;
+    std::unordered_set<const Package*> processed = {trigger};
+    std::vector<const Package*> packagesToProcess = {trigger};
+
+    // Cascade: a package leaves when one of its dependencies is no longer referenced.
+    while (!packagesToProcess.empty()) {
+        const Package* packageToRemove = packagesToProcess.back();
+        packagesToProcess.pop_back();
+        chain.packages.push_back(packageToRemove);
+        chain.removedBenefit += packageToRemove->getBenefit();
+
+        for (const Dependency* dependency : dependenciesOf(packageToRemove)) {
+            const int count = referenceCount(bag, dependency);
+            if (count == 0) continue;
+            if (count - ++decrements[dependency] != 0) continue;
+
+            chain.freedDependencies.insert(dependency);
+            chain.freedSize += dependency->getSize();
+            for (const Package* user : m_users.of(dependency)) {
+                if (packagesInBag.count(user) && processed.insert(user).second) packagesToProcess.push_back(user);
+            }
+        }
+    }
+
+    // The chain only reads the counts of its packages' dependencies.
+    for (const auto& pair : decrements) m_chainsReading[pair.first].push_back(trigger);
+    return m_chains.emplace(trigger, std::move(chain)).first->second;
+}
+
+// =====================================================================================
+// Invalidation
+// =====================================================================================
+void MoveEvaluationCache::onMoveApplied(const Bag& bag, const std::vector<const Package*>& removed,
+                                        const std::vector<const Package*>& added)
+{
+    // Only packages whose membership really changed moved their dependencies' counts.
+    const auto& packagesInBag = bag.getPackages();
+    std::unordered_map<const Dependency*, int> countChange;
+    for (const Package* package : removed) {
+        if (packagesInBag.count(package)) continue;
+        for (const Dependency* dependency : dependenciesOf(package)) --countChange[dependency];
+    }
+    for (const Package* package : added) {
+        if (!packagesInBag.count(package)) continue;
+        for (const Dependency* dependency : dependenciesOf(package)) ++countChange[dependency];
+    }
+
+    for (const auto& [dependency, change] : countChange) {
+        if (change == 0) continue;
+        auto reading = m_chainsReading.find(dependency);
+        if (reading == m_chainsReading.end()) continue;
+        for (const Package* trigger : reading->second) m_chains.erase(trigger);
+        m_chainsReading.erase(reading);
+    }
+}
+
+// =====================================================================================
+// Helpers
+// =====================================================================================
+const std::vector<const Dependency*>& MoveEvaluationCache::dependenciesOf(const Package* package) const
+{
+    static const std::vector<const Dependency*> none;
+    auto it = m_dependencyGraph.find(package);
+    return it == m_dependencyGraph.end() ? none : it->second;
+}
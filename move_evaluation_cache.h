@@ -0,0 +1,116 @@
+#ifndef MOVE_EVALUATION_CACHE_H
+#define MOVE_EVALUATION_CACHE_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Bag;
+class Package;
+class Dependency;
+
+/**
+ * @brief Packages of each dependency (the reverse of the dependency graph), built on first use.
+ *
+ * Packages sharing a dependency are each other's overlap candidates: swapping
+ * one for another frees or reuses that dependency.
+ */
+class DependencyUsers {
+public:
+    using DependencyGraph = std::unordered_map<const Package*, std::vector<const Dependency*>>;
+
+    explicit DependencyUsers(const DependencyGraph& dependencyGraph);
+
+    const std::vector<const Package*>& of(const Dependency* dependency);
+
+    /// True if this index was built for dependencyGraph in its current shape.
+    bool matches(const DependencyGraph& dependencyGraph) const;
+
+    /**
+     * @brief Brings one package/dependency pair in line with the graph after a link was added or removed.
+     *
+     * Costs O(packages of dependency), so an edited graph keeps its index
+     * instead of rebuilding it; an index not built yet is left alone.
+     */
+    void relink(const Package* package, const Dependency* dependency);
+
+private:
+    void build();
+
+    const DependencyGraph& m_dependencyGraph;
+    size_t m_graphSize;
+    bool m_built = false;
+    std::unordered_map<const Dependency*, std::vector<const Package*>> m_users;
+};
+
+/**
+ * @brief Remembers move evaluations of one local search between its iterations.
+ *
+ * Evaluating a move only reads the reference counts of the dependencies it
+ * touches, and an applied move only changes the counts of the moved packages'
+ * dependencies:
+ *  - an ejection chain (the packages removed with a trigger and the capacity
+ *    they free) is cached per trigger and dropped when the count of any
+ *    dependency of the chain changes, so after a move only the chains near
+ *    it are simulated again;
+ *  - a 1-1 swap is evaluated from the counts of its two packages' dependencies
+ *    instead of a copy of all counts. That costs about as much as a cache
+ *    lookup, so swaps are not memoized.
+ *
+ * The cache belongs to one bag and one thread, and must see every move
+ * applied to the bag (see onMoveApplied).
+ */
+class MoveEvaluationCache {
+public:
+    using DependencyGraph = DependencyUsers::DependencyGraph;
+
+    /**
+     * @brief Packages removed by an ejection chain and the capacity they free.
+     */
+    struct EjectionChain {
+        std::vector<const Package*> packages;                     ///< Trigger first.
+        std::unordered_set<const Dependency*> freedDependencies;  ///< Dependencies no longer referenced.
+        int removedBenefit = 0;
+        int freedSize = 0;
+    };
+
+    MoveEvaluationCache(const DependencyGraph& dependencyGraph, DependencyUsers& users);
+
+    /**
+     * @brief Gets the bag size change of swapping packageIn (in the bag) for packageOut.
+     */
+    int swapSizeChange(const Bag& bag, const Package* packageIn, const Package* packageOut) const;
+
+    /**
+     * @brief Gets the bag size change of removing packagesIn (in the bag) and adding packagesOut.
+     */
+    int moveSizeChange(const Bag& bag, std::initializer_list<const Package*> packagesIn,
+                       std::initializer_list<const Package*> packagesOut) const;
+
+    /**
+     * @brief Gets the chain of packages invalidated by removing trigger from the bag.
+     *
+     * The reference stays valid until the next onMoveApplied.
+     */
+    const EjectionChain& ejectionChain(const Bag& bag, const Package* trigger);
+
+    /**
+     * @brief Drops the entries invalidated by a move already applied to the bag.
+     */
+    void onMoveApplied(const Bag& bag, const std::vector<const Package*>& removed,
+                       const std::vector<const Package*>& added);
+
+private:
+    const std::vector<const Dependency*>& dependenciesOf(const Package* package) const;
+
+    const DependencyGraph& m_dependencyGraph;
+    DependencyUsers& m_users;
+
+    // Ejection chains, and the triggers whose chain reads each dependency.
+    std::unordered_map<const Package*, EjectionChain> m_chains;
+    std::unordered_map<const Dependency*, std::vector<const Package*>> m_chainsReading;
+};
+
+#endif // MOVE_EVALUATION_CACHE_H
@@ -17,6 +17,10 @@ int Package::getBenefit() const {
     return m_benefit;
 }
 
+void Package::setBenefit(int benefit) {
+    m_benefit = benefit;
+}
+
 int Package::getDependenciesSize() const
 {
     if (m_dependenciesSizeCached) {
@@ -44,6 +48,18 @@ void Package::addDependency(Dependency& dependency) {
     m_dependenciesSizeCached = false; // Invalidate cache
 }
 
+bool Package::removeDependency(const Dependency& dependency) {
+    if (m_dependencies.erase(dependency.getName()) == 0) {
+        return false;
+    }
+    m_dependenciesSizeCached = false; // Invalidate cache
+    return true;
+}
+
+void Package::invalidateDependenciesSize() {
+    m_dependenciesSizeCached = false;
+}
+
 bool Package::hasDependency(const Dependency *dependency) const
 {
     if (!dependency) {
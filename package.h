@@ -33,6 +33,12 @@ public:
      */
     int getBenefit() const;
 
+    /**
+     * @brief Sets the benefit value, e.g. when the catalog is edited.
+     * @param benefit The new benefit value.
+     */
+    void setBenefit(int benefit);
+
     /**
      * @brief Calculates the total size of all package dependencies.
      *
@@ -73,6 +79,18 @@ public:
      */
     void addDependency(Dependency& dependency);
 
+    /**
+     * @brief Removes a dependency requirement from this package.
+     * @param dependency The dependency to unlink.
+     * @return true if the package depended on it.
+     */
+    bool removeDependency(const Dependency& dependency);
+
+    /**
+     * @brief Discards the cached dependency size, e.g. after a dependency is resized.
+     */
+    void invalidateDependenciesSize();
+
     /**
      * @brief Check whether this package depends on a given dependency.
      *
@@ -0,0 +1,334 @@
+#include "perf_counters.h"
+
+#include "logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace PERF_COUNTERS {
+
+static constexpr int ALGORITHM_COUNT = static_cast<int>(ALGORITHM::ALGORITHM_TYPE::GREEDY_PACKAGE_MARGINAL_RATIO) + 1;
+static constexpr int MOVEMENT_COUNT = static_cast<int>(SEARCH_ENGINE::MovementType::NONE) + 1;
+static constexpr int EVENT_COUNT = 4;
+
+// =====================================================================================
+// Counters
+// =====================================================================================
+Counters& Counters::operator+=(const Counters& other)
+{
+    cycles += other.cycles;
+    instructions += other.instructions;
+    cacheMisses += other.cacheMisses;
+    branchMisses += other.branchMisses;
+    samples += other.samples;
+    return *this;
+}
+
+double Counters::instructionsPerCycle() const
+{
+    return cycles > 0 ? static_cast<double>(instructions) / cycles : 0.0;
+}
+
+double Counters::cacheMissesPerKiloInstruction() const
+{
+    return instructions > 0 ? 1000.0 * cacheMisses / instructions : 0.0;
+}
+
+double Counters::branchMissesPerKiloInstruction() const
+{
+    return instructions > 0 ? 1000.0 * branchMisses / instructions : 0.0;
+}
+
+namespace {
+
+Counters difference(const Counters& end, const Counters& start)
+{
+    Counters delta;
+    delta.cycles = end.cycles - start.cycles;
+    delta.instructions = end.instructions - start.instructions;
+    delta.cacheMisses = end.cacheMisses - start.cacheMisses;
+    delta.branchMisses = end.branchMisses - start.branchMisses;
+    return delta;
+}
+
+// =====================================================================================
+// Per-Thread Event Group
+// =====================================================================================
+enum class Availability { UNKNOWN, AVAILABLE, UNAVAILABLE };
+std::atomic<Availability> g_availability{Availability::UNKNOWN};
+std::atomic<bool> g_warned{false};
+
+void reportUnavailable(const std::string& reason)
+{
+    g_availability.store(Availability::UNAVAILABLE, std::memory_order_relaxed);
+    if (!g_warned.exchange(true)) {
+        LOG_WARNING("[PERF] Hardware counters unavailable (" << reason
+                    << "); profiling is disabled. Check /proc/sys/kernel/perf_event_paranoid.");
+    }
+}
+
+/**
+ * @brief The calling thread's cycles/instructions/cache-miss/branch-miss group.
+ *
+ * The counters run from opening until the thread exits; samples are differences
+ * of two group reads.
+ */
+class EventGroup {
+public:
+    ~EventGroup() { close(); }
+
+    bool ready() {
+        if (m_state == State::CLOSED) open();
+        return m_state == State::OPEN;
+    }
+
+    bool read(Counters& counters) {
+#if defined(__linux__)
+        uint64_t buffer[1 + EVENT_COUNT] = {};
+        if (::read(m_fds[m_leader], buffer, sizeof(buffer)) <= 0) return false;
+        uint64_t values[EVENT_COUNT] = {};
+        for (uint64_t i = 0; i < buffer[0] && i < static_cast<uint64_t>(m_opened); ++i)
+            values[m_events[i]] = buffer[1 + i];
+        counters.cycles = values[0];
+        counters.instructions = values[1];
+        counters.cacheMisses = values[2];
+        counters.branchMisses = values[3];
+        return true;
+#else
+        (void)counters;
+        return false;
+#endif
+    }
+
+private:
+    enum class State { CLOSED, OPEN, FAILED };
+
+    void open() {
+        m_state = State::FAILED;
+        if (g_availability.load(std::memory_order_relaxed) == Availability::UNAVAILABLE) return;
+#if defined(__linux__)
+        static constexpr uint64_t CONFIGS[EVENT_COUNT] = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+        };
+        for (int event = 0; event < EVENT_COUNT; ++event) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.size = sizeof(attr);
+            attr.config = CONFIGS[event];
+            attr.disabled = m_opened == 0 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP;
+
+            const int groupFd = m_opened == 0 ? -1 : m_fds[m_leader];
+            const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0);
+            if (fd < 0) {
+                // Without a leader there is nothing to read; a missing member only reads as zero.
+                if (m_opened == 0 && event == 0) {
+                    reportUnavailable(std::strerror(errno));
+                    return;
+                }
+                continue;
+            }
+            m_fds[m_opened] = static_cast<int>(fd);
+            m_events[m_opened] = event;
+            ++m_opened;
+        }
+        if (m_opened == 0 || ioctl(m_fds[m_leader], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) != 0) {
+            close();
+            m_state = State::FAILED;
+            reportUnavailable("cannot enable the event group");
+            return;
+        }
+        g_availability.store(Availability::AVAILABLE, std::memory_order_relaxed);
+        m_state = State::OPEN;
+#else
+        reportUnavailable("perf_event_open is Linux-only");
+#endif
+    }
+
+    void close() {
+#if defined(__linux__)
+        for (int i = 0; i < m_opened; ++i) ::close(m_fds[i]);
+#endif
+        m_opened = 0;
+    }
+
+    State m_state = State::CLOSED;
+    int m_fds[EVENT_COUNT] = {-1, -1, -1, -1};
+    int m_events[EVENT_COUNT] = {};
+    int m_opened = 0;
+    const int m_leader = 0;
+};
+
+// =====================================================================================
+// Thread State
+// =====================================================================================
+struct ThreadState {
+    Profile* profile = nullptr;
+    ALGORITHM::ALGORITHM_TYPE algorithm = ALGORITHM::ALGORITHM_TYPE::NONE;
+    ScopedSample* activeSample = nullptr;
+    Counters pending[ALGORITHM_COUNT][MOVEMENT_COUNT];
+    bool hasPending = false;
+    EventGroup group;
+
+    void charge(SEARCH_ENGINE::MovementType movement, const Counters& delta) {
+        pending[static_cast<int>(algorithm)][static_cast<int>(movement)] += delta;
+        hasPending = true;
+    }
+
+    void flush() {
+        if (!hasPending || !profile) return;
+        for (int a = 0; a < ALGORITHM_COUNT; ++a) {
+            for (int m = 0; m < MOVEMENT_COUNT; ++m) {
+                const Counters& counters = pending[a][m];
+                if (counters.samples == 0 && counters.cycles == 0 && counters.instructions == 0) continue;
+                profile->merge({static_cast<ALGORITHM::ALGORITHM_TYPE>(a),
+                                static_cast<SEARCH_ENGINE::MovementType>(m), counters});
+                pending[a][m] = Counters();
+            }
+        }
+        hasPending = false;
+    }
+};
+
+thread_local ThreadState t_state;
+
+} // namespace
+
+// =====================================================================================
+// Profile
+// =====================================================================================
+void Profile::merge(const Row& row)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (Row& existing : m_rows) {
+        if (existing.algorithm == row.algorithm && existing.movement == row.movement) {
+            existing.counters += row.counters;
+            return;
+        }
+    }
+    m_rows.push_back(row);
+}
+
+std::vector<Row> Profile::rows() const
+{
+    std::vector<Row> sorted;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        sorted = m_rows;
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Row& a, const Row& b) {
+        if (a.algorithm != b.algorithm) return a.algorithm < b.algorithm;
+        return a.movement < b.movement;
+    });
+    return sorted;
+}
+
+std::string Profile::summary() const
+{
+    const std::vector<Row> table = rows();
+    if (table.empty()) return "Hardware counters: no samples";
+
+    std::ostringstream oss;
+    oss << std::left << std::setw(38) << "Algorithm" << std::setw(22) << "Movement"
+        << std::right << std::setw(10) << "Samples" << std::setw(16) << "Cycles"
+        << std::setw(8) << "IPC" << std::setw(14) << "Cache MPKI" << std::setw(14) << "Branch MPKI" << "\n";
+    oss << std::fixed << std::setprecision(2);
+    auto line = [&](const std::string& algorithm, const std::string& movement, const Counters& c) {
+        oss << std::left << std::setw(38) << algorithm << std::setw(22) << movement
+            << std::right << std::setw(10) << c.samples << std::setw(16) << c.cycles
+            << std::setw(8) << c.instructionsPerCycle()
+            << std::setw(14) << c.cacheMissesPerKiloInstruction()
+            << std::setw(14) << c.branchMissesPerKiloInstruction() << "\n";
+    };
+
+    Counters total;
+    for (const Row& row : table) {
+        line(ALGORITHM::toString(row.algorithm), SEARCH_ENGINE::toString(row.movement), row.counters);
+        total += row.counters;
+    }
+    line("TOTAL", "", total);
+    return oss.str();
+}
+
+// =====================================================================================
+// Public API
+// =====================================================================================
+bool isAvailable()
+{
+    if (g_availability.load(std::memory_order_relaxed) == Availability::UNKNOWN) t_state.group.ready();
+    return g_availability.load(std::memory_order_relaxed) == Availability::AVAILABLE;
+}
+
+Profile* currentProfile()
+{
+    return t_state.profile;
+}
+
+ScopedContext::ScopedContext(Profile* profile, ALGORITHM::ALGORITHM_TYPE algorithm)
+    : m_previousProfile(t_state.profile), m_previousAlgorithm(t_state.algorithm)
+{
+    if (profile != t_state.profile) t_state.flush();
+    t_state.profile = profile;
+    t_state.algorithm = algorithm;
+}
+
+ScopedContext::~ScopedContext()
+{
+    t_state.flush();
+    t_state.profile = m_previousProfile;
+    t_state.algorithm = m_previousAlgorithm;
+}
+
+ScopedSample::ScopedSample(SEARCH_ENGINE::MovementType movement)
+    : m_movement(movement)
+{
+    if (!t_state.profile || !t_state.group.ready()) return;
+
+    Counters now;
+    if (!t_state.group.read(now)) return;
+
+    // Pause the enclosing sample: charge what it has spent so far.
+    m_parent = t_state.activeSample;
+    if (m_parent) {
+        t_state.charge(m_parent->m_movement, difference(now, m_parent->m_start));
+        m_parent->m_start = now;
+    }
+    t_state.activeSample = this;
+    m_start = now;
+    m_active = true;
+}
+
+ScopedSample::~ScopedSample()
+{
+    if (!m_active) return;
+
+    Counters now;
+    Counters delta;
+    if (t_state.group.read(now)) delta = difference(now, m_start);
+    else now = m_start;
+    delta.samples = 1;
+    t_state.charge(m_movement, delta);
+
+    // Resume the enclosing sample from here.
+    t_state.activeSample = m_parent;
+    if (m_parent) {
+        m_parent->m_start = now;
+    }
+}
+
+} // namespace PERF_COUNTERS
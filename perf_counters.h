@@ -0,0 +1,126 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "algorithm.h"
+#include "search_engine.h"
+
+/**
+ * @brief Optional hardware performance counters for the solver kernels (Linux perf_event_open).
+ *
+ * Every thread that samples opens one perf event group (cycles, instructions,
+ * cache misses, branch misses) for itself on first use. A ScopedSample reads
+ * the group when it starts and ends and charges the difference to the calling
+ * thread's current algorithm and the sampled MovementType. Samples accumulate
+ * in a thread-local table that is merged into the owning Profile under a lock
+ * only when the thread leaves its ScopedContext, so workers never contend on
+ * the hot path.
+ *
+ * Sampling is active only on threads inside a ScopedContext with a Profile;
+ * everywhere else a ScopedSample is one thread-local load. Where perf events
+ * are not permitted (perf_event_paranoid, containers, non-Linux builds) the
+ * first sample logs a warning and every later one is a no-op; events the CPU
+ * does not expose are reported as zero.
+ */
+namespace PERF_COUNTERS {
+
+struct Counters {
+    uint64_t cycles = 0;
+    uint64_t instructions = 0;
+    uint64_t cacheMisses = 0;
+    uint64_t branchMisses = 0;
+    uint64_t samples = 0;
+
+    Counters& operator+=(const Counters& other);
+
+    [[nodiscard]] double instructionsPerCycle() const;
+    [[nodiscard]] double cacheMissesPerKiloInstruction() const;
+    [[nodiscard]] double branchMissesPerKiloInstruction() const;
+};
+
+/**
+ * @brief Counters of one (algorithm, movement) pair; MovementType::NONE covers work outside the moves.
+ */
+struct Row {
+    ALGORITHM::ALGORITHM_TYPE algorithm;
+    SEARCH_ENGINE::MovementType movement;
+    Counters counters;
+};
+
+/**
+ * @brief Counters collected for one solve, aggregated over all of its threads.
+ */
+class Profile {
+public:
+    /**
+     * @brief Gets the non-empty rows, ordered by algorithm then movement.
+     */
+    std::vector<Row> rows() const;
+
+    /**
+     * @brief Gets a printable table of the rows plus a total line.
+     */
+    std::string summary() const;
+
+    void merge(const Row& row);
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<Row> m_rows;
+};
+
+/**
+ * @brief Tells whether this process can open perf events (probes on first call).
+ */
+bool isAvailable();
+
+/**
+ * @brief Gets the profile sampled into by the calling thread, or nullptr.
+ */
+Profile* currentProfile();
+
+/**
+ * @brief Samples into a profile under an algorithm while in scope.
+ *
+ * Solvers that run worker threads read currentProfile() on the calling thread
+ * and open a ScopedContext inside each worker, like PROGRESS::ScopedTag.
+ * Leaving the scope merges the thread's pending samples into the profile.
+ */
+class ScopedContext {
+public:
+    ScopedContext(Profile* profile, ALGORITHM::ALGORITHM_TYPE algorithm);
+    ~ScopedContext();
+
+    ScopedContext(const ScopedContext&) = delete;
+    ScopedContext& operator=(const ScopedContext&) = delete;
+
+private:
+    Profile* m_previousProfile;
+    ALGORITHM::ALGORITHM_TYPE m_previousAlgorithm;
+};
+
+/**
+ * @brief Charges the counters spent while in scope to the thread's algorithm and a movement.
+ */
+class ScopedSample {
+public:
+    explicit ScopedSample(SEARCH_ENGINE::MovementType movement);
+    ~ScopedSample();
+
+    ScopedSample(const ScopedSample&) = delete;
+    ScopedSample& operator=(const ScopedSample&) = delete;
+
+private:
+    SEARCH_ENGINE::MovementType m_movement;
+    bool m_active = false;
+    Counters m_start;
+    ScopedSample* m_parent = nullptr; ///< Enclosing sample; paused while this one runs, so counts are exclusive.
+};
+
+} // namespace PERF_COUNTERS
+
+#endif // PERF_COUNTERS_H
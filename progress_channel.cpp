@@ -0,0 +1,88 @@
+#include "progress_channel.h"
+
+namespace PROGRESS {
+
+// =====================================================================================
+// Producer Slots
+// =====================================================================================
+
+/**
+ * @brief Per-thread claim on a channel slot; returns it when the thread exits.
+ */
+struct ProducerHandle {
+    ProgressChannel* owner = nullptr;
+    int slot = -1;
+
+    ~ProducerHandle() {
+        if (owner && slot >= 0) owner->releaseSlot(slot);
+    }
+};
+
+ProgressChannel::ProgressChannel()
+    : m_slots(new Slot[MAX_PRODUCERS])
+{
+}
+
+int ProgressChannel::claimSlot() noexcept
+{
+    for (size_t i = 0; i < MAX_PRODUCERS; ++i) {
+        bool expected = false;
+        if (!m_slots[i].claimed.load(std::memory_order_relaxed) &&
+            m_slots[i].claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void ProgressChannel::releaseSlot(int slot) noexcept
+{
+    // Pending events stay in the ring; the consumer still drains them.
+    m_slots[slot].claimed.store(false, std::memory_order_release);
+}
+
+void ProgressChannel::publish(const ProgressEvent& event) noexcept
+{
+    if (!isEnabled()) return;
+
+    thread_local ProducerHandle handle;
+    if (handle.owner != this) {
+        if (handle.owner && handle.slot >= 0) handle.owner->releaseSlot(handle.slot);
+        handle.owner = this;
+        handle.slot = claimSlot();
+    } else if (handle.slot < 0) {
+        handle.slot = claimSlot();
+    }
+
+    if (handle.slot < 0 || !m_slots[handle.slot].queue.tryPush(event))
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+ProgressChannel& channel()
+{
+    static ProgressChannel instance;
+    return instance;
+}
+
+// =====================================================================================
+// Thread Tags
+// =====================================================================================
+static thread_local int t_currentTag = 0;
+
+int currentTag()
+{
+    return t_currentTag;
+}
+
+ScopedTag::ScopedTag(int tag)
+    : m_previous(t_currentTag)
+{
+    t_currentTag = tag;
+}
+
+ScopedTag::~ScopedTag()
+{
+    t_currentTag = m_previous;
+}
+
+} // namespace PROGRESS
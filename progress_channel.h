@@ -0,0 +1,198 @@
+#ifndef PROGRESS_CHANNEL_H
+#define PROGRESS_CHANNEL_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+#include "algorithm.h"
+#include "search_engine.h"
+
+/**
+ * @brief Observer channel that streams solver progress to a consumer (the GUI).
+ *
+ * Every producing thread owns one single-producer/single-consumer ring buffer,
+ * claimed lock-free on its first publish and released when the thread exits.
+ * Publishing is a handful of relaxed/release stores: when the consumer falls
+ * behind, the ring is full and the event is dropped (and counted) instead of
+ * making the solver wait. The consumer drains all rings from a single thread,
+ * typically a Qt timer on the GUI thread.
+ *
+ * The channel is disabled by default, so a solver without an observer pays
+ * one relaxed atomic load per publish site.
+ */
+namespace PROGRESS {
+
+enum class EventKind {
+    INCUMBENT,  ///< A producer found a better solution.
+    HEARTBEAT,  ///< Periodic progress: current best and moves done since the last event.
+    FINISHED    ///< An algorithm returned its final bag.
+};
+
+/**
+ * @brief One progress message; trivially copyable so it can live in the rings.
+ */
+struct ProgressEvent {
+    EventKind kind = EventKind::HEARTBEAT;
+    ALGORITHM::ALGORITHM_TYPE algorithm = ALGORITHM::ALGORITHM_TYPE::NONE;
+    SEARCH_ENGINE::MovementType movement = SEARCH_ENGINE::MovementType::NONE;
+    int benefit = 0;
+    int size = 0;
+    long long moves = 0;  ///< Moves applied by this producer since its previous event.
+    int tag = 0;          ///< Tag of the publishing thread (see ScopedTag); 0 when untagged.
+    std::chrono::steady_clock::time_point time{};
+};
+
+/**
+ * @brief Bounded lock-free ring buffer for exactly one producer and one consumer.
+ */
+template <typename T, size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    /**
+     * @brief Appends an item; returns false without waiting when the ring is full.
+     */
+    bool tryPush(const T& item) noexcept {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_headCache == Capacity) {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail - m_headCache == Capacity) return false;
+        }
+        m_items[tail & (Capacity - 1)] = item;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Removes the oldest item; returns false when the ring is empty.
+     */
+    bool tryPop(T& item) noexcept {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) return false;
+        item = m_items[head & (Capacity - 1)];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+    size_t m_headCache = 0; ///< Producer-side copy of m_head, refreshed only when the ring looks full.
+    std::array<T, Capacity> m_items{};
+};
+
+class ProgressChannel {
+public:
+    static constexpr size_t MAX_PRODUCERS = 64;
+    static constexpr size_t QUEUE_CAPACITY = 256;
+
+    ProgressChannel();
+
+    /**
+     * @brief Publishes an event from the calling thread. Never blocks.
+     *
+     * Dropped when the channel is disabled, the caller's ring is full or all
+     * producer slots are taken.
+     */
+    void publish(const ProgressEvent& event) noexcept;
+
+    /**
+     * @brief Pops every pending event and hands it to the consumer.
+     *
+     * Must only be called from one thread at a time.
+     * @return The number of events delivered.
+     */
+    template <typename Consumer>
+    size_t drain(Consumer&& consumer) {
+        size_t delivered = 0;
+        ProgressEvent event;
+        for (size_t i = 0; i < MAX_PRODUCERS; ++i) {
+            while (m_slots[i].queue.tryPop(event)) {
+                consumer(event);
+                ++delivered;
+            }
+        }
+        return delivered;
+    }
+
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Number of events lost because a ring was full or no slot was free.
+     */
+    long long droppedEvents() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<bool> claimed{false};
+        SpscQueue<ProgressEvent, QUEUE_CAPACITY> queue;
+    };
+
+    int claimSlot() noexcept;
+    void releaseSlot(int slot) noexcept;
+
+    friend struct ProducerHandle;
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<long long> m_dropped{0};
+    std::unique_ptr<Slot[]> m_slots;
+};
+
+/**
+ * @brief Process-wide channel shared by all solvers.
+ */
+ProgressChannel& channel();
+
+/**
+ * @brief Gets the tag stamped on events published by the calling thread.
+ */
+int currentTag();
+
+/**
+ * @brief Tags every event published by the calling thread while in scope.
+ *
+ * Lets one consumer tell concurrent solves apart (e.g. queued GUI jobs).
+ * Solvers that publish from their own worker threads read currentTag() on
+ * the calling thread and open a ScopedTag inside each worker.
+ */
+class ScopedTag {
+public:
+    explicit ScopedTag(int tag);
+    ~ScopedTag();
+
+    ScopedTag(const ScopedTag&) = delete;
+    ScopedTag& operator=(const ScopedTag&) = delete;
+
+private:
+    int m_previous;
+};
+
+/**
+ * @brief Builds and publishes an event; a no-op unless the channel is enabled.
+ */
+inline void report(EventKind kind, ALGORITHM::ALGORITHM_TYPE algorithm, SEARCH_ENGINE::MovementType movement,
+                   int benefit, int size, long long moves = 0) noexcept
+{
+    ProgressChannel& progress = channel();
+    if (!progress.isEnabled()) return;
+
+    ProgressEvent event;
+    event.kind = kind;
+    event.algorithm = algorithm;
+    event.movement = movement;
+    event.benefit = benefit;
+    event.size = size;
+    event.moves = moves;
+    event.tag = currentTag();
+    event.time = std::chrono::steady_clock::now();
+    progress.publish(event);
+}
+
+} // namespace PROGRESS
+
+#endif // PROGRESS_CHANNEL_H
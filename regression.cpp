@@ -0,0 +1,413 @@
+#include "regression.h"
+
+#include "algorithm.h"
+#include "bag.h"
+#include "file_processor.h"
+#include "logger.h"
+#include "progress_channel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace REGRESSION {
+
+// A recorded run's quality target: this fraction of its own final benefit.
+static constexpr double QUALITY_TARGET = 0.99;
+// Time-to-quality may grow by this fraction (plus TTQ_SLACK_SECONDS) before a warning.
+static constexpr double TTQ_TOLERANCE = 0.50;
+static constexpr double TTQ_SLACK_SECONDS = 0.05;
+// How often the progress channel is drained while an instance is solved.
+static constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(5);
+
+static const char* const BASELINE_HEADER =
+    "instance,benefit,seconds,moves,moves_per_second,reference_benefit,target_benefit,time_to_quality,time_budget,seed";
+
+namespace {
+
+std::vector<std::string> splitCsv(const std::string& line)
+{
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, ',')) fields.push_back(field);
+    if (!line.empty() && line.back() == ',') fields.emplace_back();
+    return fields;
+}
+
+bool parseInt(const std::string& text, int& value)
+{
+    try {
+        size_t used = 0;
+        value = std::stoi(text, &used);
+        return used == text.size() || text[used] == '\r';
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+std::vector<fs::path> instanceFiles(const std::string& directory)
+{
+    std::vector<fs::path> files;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".txt") files.push_back(entry.path());
+    }
+    if (ec) throw std::runtime_error("Error: Could not list instance directory " + directory + ": " + ec.message());
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+const char* toString(Verdict verdict)
+{
+    switch (verdict) {
+    case Verdict::PASS: return "PASS";
+    case Verdict::WARN: return "WARN";
+    case Verdict::FAIL: return "FAIL";
+    }
+    return "?";
+}
+
+/**
+ * @brief One solve of an instance with its incumbent benefits over time.
+ */
+struct Run {
+    Measurement measurement;
+    std::vector<std::pair<double, int>> incumbents; ///< (seconds since start, benefit), in time order.
+
+    double timeToReach(int target) const {
+        for (const auto& [seconds, benefit] : incumbents) {
+            if (benefit >= target) return seconds;
+        }
+        return -1.0;
+    }
+};
+
+/**
+ * @brief Median of each metric over repeated solves of one instance.
+ *
+ * The target is fixed first (from the baseline, or from the median benefit
+ * when recording) so time-to-quality is measured against the same benefit.
+ */
+Measurement median(const std::vector<Run>& runs, int targetBenefit)
+{
+    auto pick = [&runs](auto key) {
+        std::vector<double> values;
+        for (const Run& run : runs) values.push_back(key(run));
+        std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+        return values[values.size() / 2];
+    };
+    Measurement m = runs.front().measurement;
+    m.benefit = static_cast<int>(pick([](const Run& r) { return r.measurement.benefit; }));
+    m.seconds = pick([](const Run& r) { return r.measurement.seconds; });
+    m.moves = static_cast<long long>(pick([](const Run& r) { return static_cast<double>(r.measurement.moves); }));
+    m.movesPerSecond = pick([](const Run& r) { return r.measurement.movesPerSecond; });
+
+    m.targetBenefit = targetBenefit > 0 ? targetBenefit : static_cast<int>(QUALITY_TARGET * m.benefit);
+    // A run that never reached the target counts as the slowest.
+    const double ttq = pick([&m](const Run& r) {
+        const double seconds = r.timeToReach(m.targetBenefit);
+        return seconds < 0.0 ? std::numeric_limits<double>::infinity() : seconds;
+    });
+    m.timeToQuality = std::isinf(ttq) ? -1.0 : ttq;
+    return m;
+}
+
+std::string defaultBaseline(const Options& options)
+{
+    if (!options.baselineFile.empty()) return options.baselineFile;
+    return (fs::path(options.instanceDir) / "regression_baseline.csv").string();
+}
+
+/**
+ * @brief Solves one instance while a helper thread drains the progress channel.
+ *
+ */
+Run measureInstance(const fs::path& file, int referenceBenefit, const Options& options)
+{
+    using Clock = std::chrono::steady_clock;
+
+    Run run;
+    Measurement& m = run.measurement;
+    m.instance = file.filename().string();
+    m.referenceBenefit = referenceBenefit;
+
+    ProblemInstance instance = FILE_PROCESSOR::loadProblem(file.string());
+
+    PROGRESS::ProgressChannel& progress = PROGRESS::channel();
+    const bool wasEnabled = progress.isEnabled();
+    const long long droppedBefore = progress.droppedEvents();
+    progress.drain([](const PROGRESS::ProgressEvent&) {});
+    progress.setEnabled(true);
+
+    long long moves = 0;
+    std::vector<std::pair<Clock::time_point, int>> incumbents;
+    auto consume = [&](const PROGRESS::ProgressEvent& event) {
+        moves += event.moves;
+        incumbents.emplace_back(event.time, event.benefit);
+    };
+
+    std::atomic<bool> solving{true};
+    std::thread drainer([&]() {
+        while (solving.load(std::memory_order_relaxed)) {
+            progress.drain(consume);
+            std::this_thread::sleep_for(DRAIN_INTERVAL);
+        }
+    });
+
+    const auto start = Clock::now();
+    int best = 0;
+    try {
+        Algorithm algorithm(options.timeBudget, options.seed);
+        algorithm.setAutoCalibration(false);
+        for (const auto& bag : algorithm.run(instance, "regression")) {
+            if (bag) best = std::max(best, bag->getBenefit());
+        }
+    } catch (...) {
+        solving.store(false);
+        drainer.join();
+        progress.setEnabled(wasEnabled);
+        throw;
+    }
+    const auto end = Clock::now();
+    solving.store(false);
+    drainer.join();
+    progress.drain(consume);
+    progress.setEnabled(wasEnabled);
+
+    if (progress.droppedEvents() != droppedBefore) {
+        LOG_WARNING("[REGRESSION] " << (progress.droppedEvents() - droppedBefore)
+                    << " progress events dropped on " << m.instance << "; moves/s is understated");
+    }
+
+    m.benefit = best;
+    m.seconds = std::chrono::duration<double>(end - start).count();
+    m.moves = moves;
+    m.movesPerSecond = m.seconds > 0.0 ? moves / m.seconds : 0.0;
+
+    // Producers are drained ring by ring, so events arrive out of time order.
+    std::sort(incumbents.begin(), incumbents.end());
+    for (const auto& [time, benefit] : incumbents)
+        run.incumbents.emplace_back(std::max(0.0, std::chrono::duration<double>(time - start).count()), benefit);
+    return run;
+}
+
+} // namespace
+
+// =====================================================================================
+// Measurement
+// =====================================================================================
+std::unordered_map<std::string, int> loadReferenceBenefits(const std::string& directory)
+{
+    std::unordered_map<std::string, int> best;
+    std::error_code ec;
+    for (const auto& entry : fs::recursive_directory_iterator(directory, ec)) {
+        const fs::path& path = entry.path();
+        if (!entry.is_regular_file() || path.extension() != ".csv"
+            || path.filename().string().rfind("results_", 0) != 0) continue;
+
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line)) {
+            const std::vector<std::string> fields = splitCsv(line);
+            int benefit = 0;
+            if (fields.size() < 9 || !parseInt(fields[8], benefit)) continue; // header or other format
+            int& current = best[fields[2]];
+            current = std::max(current, benefit);
+        }
+    }
+    return best;
+}
+
+std::vector<Measurement> measure(const Options& options, const std::vector<Measurement>& baseline)
+{
+    const std::vector<fs::path> files = instanceFiles(options.instanceDir);
+    if (files.empty()) throw std::runtime_error("Error: No instances (*.txt) in " + options.instanceDir);
+
+    const std::unordered_map<std::string, int> references = loadReferenceBenefits(options.instanceDir);
+    std::vector<Measurement> measurements;
+    measurements.reserve(files.size());
+    for (const fs::path& file : files) {
+        const std::string name = file.filename().string();
+        const auto reference = references.find(name);
+        const auto recorded = std::find_if(baseline.begin(), baseline.end(),
+                                           [&](const Measurement& b) { return b.instance == name; });
+        const int referenceBenefit = reference != references.end() ? reference->second : 0;
+
+        std::vector<Run> runs;
+        for (int i = 0; i < std::max(1, options.repetitions); ++i)
+            runs.push_back(measureInstance(file, referenceBenefit, options));
+        measurements.push_back(median(runs, recorded != baseline.end() ? recorded->targetBenefit : 0));
+    }
+    return measurements;
+}
+
+// =====================================================================================
+// Baseline File
+// =====================================================================================
+void saveBaseline(const std::string& filename, const std::vector<Measurement>& measurements, const Options& options)
+{
+    std::ofstream out(filename);
+    if (!out.is_open()) throw std::runtime_error("Error: Could not open baseline file " + filename);
+
+    out << BASELINE_HEADER << "\n" << std::setprecision(10);
+    for (const Measurement& m : measurements) {
+        out << m.instance << "," << m.benefit << "," << m.seconds << "," << m.moves << ","
+            << m.movesPerSecond << "," << m.referenceBenefit << "," << m.targetBenefit << "," << m.timeToQuality << ","
+            << options.timeBudget << "," << options.seed << "\n";
+    }
+}
+
+std::vector<Measurement> loadBaseline(const std::string& filename)
+{
+    std::ifstream in(filename);
+    if (!in.is_open()) throw std::runtime_error("Error: Could not open baseline file " + filename);
+
+    std::string line;
+    if (!std::getline(in, line) || line.rfind("instance,", 0) != 0)
+        throw std::runtime_error("Error: " + filename + " is not a regression baseline");
+
+    std::vector<Measurement> measurements;
+    int lineNumber = 1;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (line.empty() || line == "\r") continue;
+        const std::vector<std::string> fields = splitCsv(line);
+        if (fields.size() < 8)
+            throw std::runtime_error("Error: Malformed baseline line " + std::to_string(lineNumber) + " in " + filename);
+        try {
+            Measurement m;
+            m.instance = fields[0];
+            m.benefit = std::stoi(fields[1]);
+            m.seconds = std::stod(fields[2]);
+            m.moves = std::stoll(fields[3]);
+            m.movesPerSecond = std::stod(fields[4]);
+            m.referenceBenefit = std::stoi(fields[5]);
+            m.targetBenefit = std::stoi(fields[6]);
+            m.timeToQuality = std::stod(fields[7]);
+            measurements.push_back(m);
+        } catch (const std::exception&) {
+            throw std::runtime_error("Error: Malformed baseline line " + std::to_string(lineNumber) + " in " + filename);
+        }
+    }
+    return measurements;
+}
+
+// =====================================================================================
+// Comparison
+// =====================================================================================
+std::vector<Comparison> compare(const std::vector<Measurement>& current,
+                                const std::vector<Measurement>& baseline,
+                                const Options& options)
+{
+    std::vector<Comparison> comparisons;
+    for (const Measurement& m : current) {
+        Comparison c;
+        c.current = m;
+        const auto it = std::find_if(baseline.begin(), baseline.end(),
+                                     [&](const Measurement& b) { return b.instance == m.instance; });
+        if (it == baseline.end()) {
+            c.verdict = Verdict::WARN;
+            c.reason = "not in baseline";
+            comparisons.push_back(c);
+            continue;
+        }
+        c.baseline = *it;
+        const Measurement& b = *it;
+
+        std::ostringstream reasons;
+        auto flag = [&](Verdict verdict, const std::string& reason) {
+            if (verdict > c.verdict) c.verdict = verdict;
+            if (reasons.tellp() > 0) reasons << "; ";
+            reasons << reason;
+        };
+
+        if (m.benefit < b.benefit * (1.0 - options.benefitTolerance))
+            flag(Verdict::FAIL, "benefit " + std::to_string(m.benefit) + " < " + std::to_string(b.benefit));
+        if (b.movesPerSecond > 0.0 && m.movesPerSecond < b.movesPerSecond * (1.0 - options.throughputTolerance)) {
+            std::ostringstream oss;
+            oss << std::fixed << std::setprecision(0) << "moves/s " << m.movesPerSecond << " < " << b.movesPerSecond;
+            flag(Verdict::FAIL, oss.str());
+        }
+        if (b.timeToQuality >= 0.0) {
+            if (m.timeToQuality < 0.0) {
+                flag(Verdict::WARN, "quality target no longer reached");
+            } else if (m.timeToQuality > b.timeToQuality * (1.0 + TTQ_TOLERANCE) + TTQ_SLACK_SECONDS) {
+                std::ostringstream oss;
+                oss << std::fixed << std::setprecision(3) << "time-to-quality " << m.timeToQuality
+                    << "s > " << b.timeToQuality << "s";
+                flag(Verdict::WARN, oss.str());
+            }
+        }
+        c.reason = reasons.str();
+        comparisons.push_back(c);
+    }
+    return comparisons;
+}
+
+// =====================================================================================
+// Gate
+// =====================================================================================
+int runGate(const std::string& mode, const Options& options, std::ostream& out)
+{
+    if (mode != "record" && mode != "check") {
+        out << "Usage: --regression <record|check> [instance directory]\n";
+        return 2;
+    }
+
+    const std::string baselineFile = defaultBaseline(options);
+    try {
+        const bool record = mode == "record" || !fs::exists(baselineFile);
+        const std::vector<Measurement> baseline = record ? std::vector<Measurement>() : loadBaseline(baselineFile);
+        const std::vector<Measurement> current = measure(options, baseline);
+
+        auto printMeasurement = [&](const Measurement& m) {
+            out << std::left << std::setw(44) << m.instance << std::right
+                << std::setw(8) << m.benefit << std::setw(8) << m.referenceBenefit
+                << std::fixed << std::setprecision(0) << std::setw(14) << m.movesPerSecond
+                << std::setprecision(3) << std::setw(10);
+            if (m.timeToQuality >= 0.0) out << m.timeToQuality;
+            else out << "-";
+        };
+        out << std::left << std::setw(44) << "Instance" << std::right << std::setw(8) << "Benefit"
+            << std::setw(8) << "Ref" << std::setw(14) << "Moves/s" << std::setw(10) << "TTQ (s)" << "\n";
+
+        if (record) {
+            for (const Measurement& m : current) {
+                printMeasurement(m);
+                out << "\n";
+            }
+            saveBaseline(baselineFile, current, options);
+            out << "Baseline recorded to " << baselineFile << "\n";
+            return 0;
+        }
+
+        const std::vector<Comparison> comparisons = compare(current, baseline, options);
+        Verdict overall = Verdict::PASS;
+        for (const Comparison& c : comparisons) {
+            printMeasurement(c.current);
+            out << "  " << toString(c.verdict);
+            if (!c.reason.empty()) out << " (" << c.reason << ")";
+            out << "\n";
+            overall = std::max(overall, c.verdict);
+        }
+        out << "Regression gate: " << toString(overall) << " against " << baselineFile << "\n";
+        return overall == Verdict::FAIL ? 1 : 0;
+    } catch (const std::exception& e) {
+        out << e.what() << "\n";
+        return 2;
+    }
+}
+
+} // namespace REGRESSION
@@ -0,0 +1,97 @@
+#ifndef REGRESSION_H
+#define REGRESSION_H
+
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Local performance regression gate over the bundled instances.
+ *
+ * Every instance (*.txt) of a directory is solved by Algorithm::run with a
+ * fixed seed and time budget and without auto-calibration, so runs are
+ * comparable across commits on the same machine. Worker threads still race,
+ * so each instance is solved several times and the median of every metric is
+ * kept. For each instance the gate measures:
+ *  - the final benefit,
+ *  - moves per second, summed from the solvers' progress events,
+ *  - time-to-quality: when an incumbent first reached the target benefit,
+ *    fixed at record time just below the recorded final benefit,
+ *  - the gap to the best benefit of earlier experiments on the instance
+ *    (results CSVs under the instance directory), for information only.
+ *
+ * "record" writes the measurements to a baseline CSV; "check" measures again
+ * against the recorded targets and compares: a drop in benefit or throughput
+ * beyond the noise tolerance fails the gate, a slower time-to-quality only warns.
+ */
+namespace REGRESSION {
+
+struct Options {
+    std::string instanceDir = "input";
+    std::string baselineFile;            ///< Empty = <instanceDir>/regression_baseline.csv.
+    double timeBudget = 1.0;             ///< Algorithm time budget per instance.
+    unsigned int seed = 75;
+    int repetitions = 3;                 ///< Solves per instance; the median of each metric is kept.
+    double benefitTolerance = 0.02;      ///< Allowed relative benefit drop.
+    double throughputTolerance = 0.20;   ///< Allowed relative drop in moves per second.
+};
+
+struct Measurement {
+    std::string instance;
+    int benefit = 0;
+    double seconds = 0.0;
+    long long moves = 0;
+    double movesPerSecond = 0.0;
+    int referenceBenefit = 0;            ///< Best benefit of earlier experiments; 0 when unknown.
+    int targetBenefit = 0;               ///< Benefit that defines time-to-quality.
+    double timeToQuality = -1.0;         ///< Seconds to reach targetBenefit; negative when never reached.
+};
+
+enum class Verdict { PASS, WARN, FAIL };
+
+struct Comparison {
+    Measurement current;
+    Measurement baseline;
+    Verdict verdict = Verdict::PASS;
+    std::string reason;
+};
+
+/**
+ * @brief Reads the best benefit per instance from earlier results CSVs under a directory.
+ *
+ * Understands the older nine-column format (algorithm, movement, file name,
+ * timestamp, time, packages, dependencies, weight, benefit) with any header.
+ */
+std::unordered_map<std::string, int> loadReferenceBenefits(const std::string& directory);
+
+/**
+ * @brief Solves every instance of options.instanceDir and measures it.
+ *
+ * @param baseline Recorded measurements whose target benefits are reused; instances
+ *                 missing from it get a target from their own final benefit.
+ */
+std::vector<Measurement> measure(const Options& options, const std::vector<Measurement>& baseline = {});
+
+void saveBaseline(const std::string& filename, const std::vector<Measurement>& measurements, const Options& options);
+
+/**
+ * @throws std::runtime_error if the file cannot be read or is malformed.
+ */
+std::vector<Measurement> loadBaseline(const std::string& filename);
+
+std::vector<Comparison> compare(const std::vector<Measurement>& current,
+                                const std::vector<Measurement>& baseline,
+                                const Options& options);
+
+/**
+ * @brief Runs the gate and prints a table to out.
+ *
+ * @param mode "record" or "check"; "check" without a baseline records one.
+ * @return 0 when the gate passes (warnings included), 1 on a regression, 2 on a usage error.
+ */
+int runGate(const std::string& mode, const Options& options, std::ostream& out);
+
+} // namespace REGRESSION
+
+#endif // REGRESSION_H
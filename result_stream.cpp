@@ -0,0 +1,62 @@
+#include "result_stream.h"
+
+#include "logger.h"
+
+namespace RESULT_STREAM {
+
+Dispatcher::Dispatcher(Callback callback)
+    : m_callback(std::move(callback)), m_thread(&Dispatcher::deliveryLoop, this)
+{
+}
+
+Dispatcher::~Dispatcher()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void Dispatcher::publish(Result result)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.push_back(std::move(result));
+    }
+    m_cv.notify_all();
+}
+
+void Dispatcher::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_pending.empty() && !m_delivering; });
+}
+
+void Dispatcher::deliveryLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_cv.wait(lock, [this] { return m_stop || !m_pending.empty(); });
+        if (m_pending.empty() && m_stop) break;
+
+        Result result = std::move(m_pending.front());
+        m_pending.pop_front();
+        m_delivering = true;
+        lock.unlock();
+
+        // A failing consumer loses this result, not the run.
+        try {
+            m_callback(result);
+        } catch (const std::exception& e) {
+            LOG_WARNING("[RESULTS] Result callback failed: " << e.what());
+        }
+
+        lock.lock();
+        m_delivering = false;
+        m_cv.notify_all();
+    }
+}
+
+} // namespace RESULT_STREAM
@@ -0,0 +1,69 @@
+#ifndef RESULT_STREAM_H
+#define RESULT_STREAM_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class Bag;
+
+/**
+ * @brief Delivers the bags of a running Algorithm::run as they are found.
+ *
+ * Results are handed to a callback on a thread of their own, so a slow
+ * consumer (report writing, validation, GUI updates) overlaps with the
+ * remaining stages instead of delaying them.
+ */
+namespace RESULT_STREAM {
+
+enum class ResultKind {
+    FINISHED,  ///< An algorithm returned its final bag.
+    INCUMBENT  ///< A finished bag beat every bag of the run so far (follows its FINISHED result).
+};
+
+struct Result {
+    ResultKind kind = ResultKind::FINISHED;
+    std::shared_ptr<const Bag> bag;  ///< A copy; the consumer may keep it.
+};
+
+using Callback = std::function<void(const Result&)>;
+
+/**
+ * @brief Calls a callback with published results, in order, on a background thread.
+ *
+ * publish() never waits for the callback. The destructor delivers the
+ * results still queued before returning.
+ */
+class Dispatcher {
+public:
+    explicit Dispatcher(Callback callback);
+    ~Dispatcher();
+
+    Dispatcher(const Dispatcher&) = delete;
+    Dispatcher& operator=(const Dispatcher&) = delete;
+
+    void publish(Result result);
+
+    /**
+     * @brief Waits until every published result has been delivered.
+     */
+    void flush();
+
+private:
+    void deliveryLoop();
+
+    Callback m_callback;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Result> m_pending;
+    bool m_delivering = false;
+    bool m_stop = false;
+    std::thread m_thread;
+};
+
+} // namespace RESULT_STREAM
+
+#endif // RESULT_STREAM_H
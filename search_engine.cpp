@@ -6,6 +6,18 @@
 #include "bag.h"
 #include "package.h"
 #include "dependency.h"
+#include "move_evaluation_cache.h"
+#include "perf_counters.h"
+#include "trace.h"
+
+static constexpr size_t LARGE_INSTANCE_PACKAGES = 20000;        // sample neighborhoods from this many packages
+static constexpr double SAMPLED_ITERATION_SECONDS = 0.002;      // target duration of a sampled iteration
+static constexpr double MAX_SAMPLED_ITERATION_SECONDS = 0.004;  // hard bound, checked every CLOCK_CHECK_INTERVAL
+static constexpr int CLOCK_CHECK_INTERVAL = 64;                 // evaluations between clock reads
+static constexpr int MIN_SAMPLE_SIZE = 32;                      // evaluations per sampled iteration, at least
+static constexpr double OVERLAP_SHARE = 0.5;                    // share of candidates drawn from overlap lists
+static constexpr double RATE_SMOOTHING = 0.3;                   // weight of the latest measured evaluation rate
+static constexpr int SAMPLE_RETRIES = 8;                        // draws before giving up on a candidate
 
 namespace SEARCH_ENGINE {
 std::string toString(MovementType movement)
@@ -32,7 +44,12 @@ std::string toString(MovementType movement)
 // Public Methods
 // =====================================================================================
 
-SearchEngine::SearchEngine(unsigned int seed) : m_rng(seed), m_seed(seed) {}
+SearchEngine::SearchEngine(unsigned int seed)
+    : m_rng(seed), m_seed(seed), m_largeInstanceThreshold(LARGE_INSTANCE_PACKAGES) {}
+
+SearchEngine::~SearchEngine() = default;
+SearchEngine::SearchEngine(SearchEngine&&) noexcept = default;
+SearchEngine& SearchEngine::operator=(SearchEngine&&) noexcept = default;
 
 // =====================================================================================
 // Local Search (single movement type)
@@ -42,38 +59,75 @@ void SearchEngine::localSearch(
     const SEARCH_ENGINE::MovementType& moveType,
     ALGORITHM::LOCAL_SEARCH localSearchMethod,
     const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
-    int maxIterationsWithoutImprovement, int maxIterations, const std::chrono::time_point<std::chrono::steady_clock>& deadline)
+    int maxIterationsWithoutImprovement, int maxIterations, const std::chrono::time_point<std::chrono::steady_clock>& deadline,
+    const std::atomic<bool>* cancelToken)
+{
+    localSearchSteps(currentBag, bagSize, allPackages, moveType, localSearchMethod, dependencyGraph,
+                     maxIterationsWithoutImprovement, maxIterations, deadline, cancelToken).finish();
+}
+
+STEPPER::Stepper SearchEngine::localSearchSteps(
+    Bag& currentBag, int bagSize, const std::vector<Package*>& allPackages,
+    SEARCH_ENGINE::MovementType moveType,
+    ALGORITHM::LOCAL_SEARCH localSearchMethod,
+    const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+    int maxIterationsWithoutImprovement, int maxIterations, std::chrono::steady_clock::time_point deadline,
+    const std::atomic<bool>* cancelToken)
 {
     int iterationsWithoutImprovement = 0;
     currentBag.setLocalSearch(localSearchMethod);
 
-    std::vector<Package*> sortedAll = allPackages;
-    std::sort(sortedAll.begin(), sortedAll.end(),
-              [](const Package* a, const Package* b) {
-                  return a->getBenefit() > b->getBenefit();
-              });
+    // Large instances sample each neighborhood instead of scanning the outside packages.
+    const bool sampled = allPackages.size() >= m_largeInstanceThreshold;
 
+    std::vector<Package*> sortedAll;
     std::vector<Package*> packagesOutsideBag;
-    packagesOutsideBag.reserve(allPackages.size());
+    if (!sampled) {
+        sortedAll = allPackages;
+        std::sort(sortedAll.begin(), sortedAll.end(),
+                  [](const Package* a, const Package* b) {
+                      return a->getBenefit() > b->getBenefit();
+                  });
+        packagesOutsideBag.reserve(allPackages.size());
+    }
+
+    // Evaluations stay valid across iterations until a move touches their dependencies.
+    MoveEvaluationCache moveCache(dependencyGraph, dependencyUsers(dependencyGraph));
+    SampledBagIndex bagIndex;
+    if (sampled) bagIndex.rebuild(currentBag);
 
     while (iterationsWithoutImprovement < maxIterationsWithoutImprovement &&
            std::chrono::steady_clock::now() < deadline) {
-        bool improvementFound = false;
-        const int benefitBefore = currentBag.getBenefit();
-
-        buildOutsidePackages(currentBag.getPackages(), sortedAll, packagesOutsideBag);
+        if (cancelToken && cancelToken->load(std::memory_order_relaxed)) break;
 
-        if (applyMovement(moveType, currentBag, bagSize, packagesOutsideBag,
-                          localSearchMethod, dependencyGraph, maxIterations))
+        // One span per iteration: a span left open across co_yield would also cover
+        // whatever the caller runs between two steps, possibly on another thread.
         {
-            if (currentBag.getBenefit() > benefitBefore) {
-                improvementFound = true;
-                iterationsWithoutImprovement = 0;
+            TRACE::ScopedEvent trace("search", "localSearch", moveType);
+            bool improvementFound = false;
+            const int benefitBefore = currentBag.getBenefit();
+
+            bool applied;
+            if (sampled) {
+                applied = exploreSampledNeighborhood(moveType, currentBag, bagSize, allPackages,
+                                                     dependencyGraph, maxIterations, moveCache, bagIndex);
+            } else {
+                buildOutsidePackages(currentBag.getPackages(), sortedAll, packagesOutsideBag);
+                applied = applyMovement(moveType, currentBag, bagSize, packagesOutsideBag,
+                                        localSearchMethod, dependencyGraph, maxIterations, moveCache);
+            }
+            if (applied) {
+                ++m_movesApplied;
+                if (currentBag.getBenefit() > benefitBefore) {
+                    improvementFound = true;
+                    iterationsWithoutImprovement = 0;
+                }
             }
-        }
 
-        if (!improvementFound)
-            ++iterationsWithoutImprovement;
+            if (!improvementFound)
+                ++iterationsWithoutImprovement;
+        }
+        co_yield currentBag.getBenefit();
     }
 }
 
@@ -82,11 +136,21 @@ int SearchEngine::getSeed() const
     return m_seed;
 }
 
+long long SearchEngine::getMovesApplied() const
+{
+    return m_movesApplied;
+}
+
 std::mt19937 & SearchEngine::getRandomGenerator()
 {
     return m_rng;
 }
 
+void SearchEngine::setLargeInstanceThreshold(size_t packages)
+{
+    m_largeInstanceThreshold = packages;
+}
+
 // =====================================================================================
 // Core Private Logic
 // =====================================================================================
@@ -95,8 +159,10 @@ bool SearchEngine::applyMovement(const SEARCH_ENGINE::MovementType& move, Bag& c
     const std::vector<Package*>& packagesOutsideBag,
     ALGORITHM::LOCAL_SEARCH localSearchMethod,
     const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
-    int maxIterations)
+    int maxIterations, MoveEvaluationCache& moveCache)
 {
+    PERF_COUNTERS::ScopedSample perfSample(move);
+
     // Route the movement type to its corresponding neighborhood exploration function
     switch (move) {
         case SEARCH_ENGINE::MovementType::ADD:
@@ -105,11 +171,11 @@ bool SearchEngine::applyMovement(const SEARCH_ENGINE::MovementType& move, Bag& c
         case SEARCH_ENGINE::MovementType::SWAP_REMOVE_1_ADD_1:
             switch (localSearchMethod) {
                 case ALGORITHM::LOCAL_SEARCH::BEST_IMPROVEMENT:
-                    return exploreSwap11NeighborhoodBestImprovement(currentBag, bagSize, packagesOutsideBag, dependencyGraph, maxIterations);
+                    return exploreSwap11NeighborhoodBestImprovement(currentBag, bagSize, packagesOutsideBag, dependencyGraph, maxIterations, moveCache);
                 case ALGORITHM::LOCAL_SEARCH::RANDOM_IMPROVEMENT:
-                    return exploreSwap11NeighborhoodRandomImprovement(currentBag, bagSize, packagesOutsideBag, dependencyGraph, maxIterations);
+                    return exploreSwap11NeighborhoodRandomImprovement(currentBag, bagSize, packagesOutsideBag, dependencyGraph, maxIterations, moveCache);
                 default: // FIRST_IMPROVEMENT
-                    return exploreSwap11NeighborhoodFirstImprovement(currentBag, bagSize, packagesOutsideBag, dependencyGraph);
+                    return exploreSwap11NeighborhoodFirstImprovement(currentBag, bagSize, packagesOutsideBag, dependencyGraph, moveCache);
             }
         case SEARCH_ENGINE::MovementType::SWAP_REMOVE_1_ADD_2:
             return exploreSwap12NeighborhoodBestImprovement(currentBag, bagSize, packagesOutsideBag, dependencyGraph, maxIterations);
@@ -124,7 +190,7 @@ bool SearchEngine::applyMovement(const SEARCH_ENGINE::MovementType& move, Bag& c
                 return exploreEjectionChainNeighborhoodFirstImprovement(currentBag, bagSize, packagesOutsideBag, dependencyGraph);
                 break;
             default:
-                return exploreEjectionChainNeighborhoodBestImprovement(currentBag, bagSize, packagesOutsideBag, dependencyGraph, maxIterations);
+                return exploreEjectionChainNeighborhoodBestImprovement(currentBag, bagSize, packagesOutsideBag, dependencyGraph, maxIterations, moveCache);
             }
     }
     return false;
@@ -185,7 +251,8 @@ bool SearchEngine::tryAddPackage(
 
 bool SearchEngine::exploreSwap11NeighborhoodFirstImprovement(
     Bag& currentBag, int bagSize, const std::vector<Package*>& packagesOutsideBag,
-    const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph)
+    const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+    MoveEvaluationCache& moveCache)
 {
     std::vector<const Package*> packagesInVec(currentBag.getPackages().begin(), currentBag.getPackages().end());
     if (packagesInVec.empty() || packagesOutsideBag.empty()) return false;
@@ -193,11 +260,10 @@ bool SearchEngine::exploreSwap11NeighborhoodFirstImprovement(
     for (const Package* packageIn : packagesInVec) {
         for (Package* packageOut : packagesOutsideBag) {
             if (packageOut->getBenefit() <= packageIn->getBenefit()) continue;
-            // <-- FIX: Pass vectors {packageIn} and {packageOut} and the dependencyGraph
-            if (currentBag.canSwapReadOnly({packageIn}, {packageOut}, bagSize, dependencyGraph)) {
+            if (currentBag.getSize() + moveCache.swapSizeChange(currentBag, packageIn, packageOut) <= bagSize) {
                 currentBag.removePackage(*packageIn, dependencyGraph.at(packageIn));
-                // <-- FIX: Call addPackageIfPossible and pass bagSize
                 currentBag.addPackageIfPossible(*packageOut, bagSize, dependencyGraph.at(packageOut));
+                moveCache.onMoveApplied(currentBag, {packageIn}, {packageOut});
                 return true;
             }
         }
@@ -208,7 +274,7 @@ bool SearchEngine::exploreSwap11NeighborhoodFirstImprovement(
 bool SearchEngine::exploreSwap11NeighborhoodRandomImprovement(
     Bag& currentBag, int bagSize, const std::vector<Package*>& packagesOutsideBag,
     const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
-    int maxIterations)
+    int maxIterations, MoveEvaluationCache& moveCache)
 {
     const auto& packagesInBag = currentBag.getPackages();
     if (packagesInBag.size() < 2 || packagesOutsideBag.empty()) return false;
@@ -222,11 +288,10 @@ bool SearchEngine::exploreSwap11NeighborhoodRandomImprovement(
         Package* packageOut = packagesOutsideBag[disOut(m_rng)];
 
         if (packageOut->getBenefit() <= packageIn->getBenefit()) continue;
-        // <-- FIX: Pass vectors {packageIn} and {packageOut} and the dependencyGraph
-        if (currentBag.canSwapReadOnly({packageIn}, {packageOut}, bagSize, dependencyGraph)) {
+        if (currentBag.getSize() + moveCache.swapSizeChange(currentBag, packageIn, packageOut) <= bagSize) {
             currentBag.removePackage(*packageIn, dependencyGraph.at(packageIn));
-            // <-- FIX: Call addPackageIfPossible and pass bagSize
             currentBag.addPackageIfPossible(*packageOut, bagSize, dependencyGraph.at(packageOut));
+            moveCache.onMoveApplied(currentBag, {packageIn}, {packageOut});
             return true;
         }
     }
@@ -236,7 +301,7 @@ bool SearchEngine::exploreSwap11NeighborhoodRandomImprovement(
 bool SearchEngine::exploreSwap11NeighborhoodBestImprovement(
     Bag& currentBag, int bagSize, const std::vector<Package*>& packagesOutsideBag,
     const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
-    int maxIterations)
+    int maxIterations, MoveEvaluationCache& moveCache)
 {
     // Create sorted copies to avoid modifying original collections
     std::vector<const Package*> sortedPackagesIn(currentBag.getPackages().begin(), currentBag.getPackages().end());
@@ -278,8 +343,7 @@ bool SearchEngine::exploreSwap11NeighborhoodBestImprovement(
             }
             // --- END PRUNING LOGIC ---
             
-            // <-- FIX: Pass vectors {p_in} and {p_out} and the dependencyGraph
-            if (currentBag.canSwapReadOnly({p_in}, {p_out}, bagSize, dependencyGraph)) {
+            if (currentBag.getSize() + moveCache.swapSizeChange(currentBag, p_in, p_out) <= bagSize) {
                 bestSwap = {potential_delta, p_in, p_out};
             }
         }
@@ -288,8 +352,8 @@ bool SearchEngine::exploreSwap11NeighborhoodBestImprovement(
 
     if (bestSwap.p_in) {
         currentBag.removePackage(*bestSwap.p_in, dependencyGraph.at(bestSwap.p_in));
-        // <-- FIX: Call addPackageIfPossible and pass bagSize
         currentBag.addPackageIfPossible(*bestSwap.p_out, bagSize, dependencyGraph.at(bestSwap.p_out));
+        moveCache.onMoveApplied(currentBag, {bestSwap.p_in}, {bestSwap.p_out});
         return true;
     }
     return false;
@@ -470,7 +534,7 @@ bool SearchEngine::exploreEjectionChainNeighborhoodFirstImprovement(
 bool SearchEngine::exploreEjectionChainNeighborhoodBestImprovement(
     Bag& currentBag, int bagSize, const std::vector<Package*>& packagesOutsideBag,
     const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
-    int maxIterations)
+    int maxIterations, MoveEvaluationCache& moveCache)
 {
     // Initial checks for empty collections
     if (currentBag.getPackages().empty() || packagesOutsideBag.empty()) {
@@ -479,13 +543,12 @@ bool SearchEngine::exploreEjectionChainNeighborhoodBestImprovement(
 
     struct BestMove {
         int delta = 0;
-        std::vector<const Package*> ejectionSet;
+        const MoveEvaluationCache::EjectionChain* chain = nullptr;
         Package* packageToAdd = nullptr;
     };
     BestMove bestMove;
 
-    // We need the original reference counts to revert to for each trigger package
-    const auto& originalRefCount = currentBag.getDependencyRefCount();
+    const auto& refCount = currentBag.getDependencyRefCount();
     std::vector<const Package*> packagesInVec(currentBag.getPackages().begin(), currentBag.getPackages().end());
     int iterations = 0;
 
@@ -493,94 +556,261 @@ bool SearchEngine::exploreEjectionChainNeighborhoodBestImprovement(
     for (const Package* triggerPackage : packagesInVec) {
         if (++iterations > maxIterations) break;
 
-        // --- Simulation Setup ---
-        std::unordered_map<const Dependency*, int> tempRefCount = originalRefCount;
-        std::vector<const Package*> currentEjectionSet;
-        std::unordered_set<const Package*> processedForEjection; // Prevents reprocessing
-        std::vector<const Package*> packagesToProcess = {triggerPackage}; // Start the cascade
-        processedForEjection.insert(triggerPackage);
-
-        // 2. Simulate the cascading removal of packages
-        while (!packagesToProcess.empty()) {
-            const Package* packageToRemove = packagesToProcess.back();
-            packagesToProcess.pop_back();
-            currentEjectionSet.push_back(packageToRemove);
-
-            // Decrement dependency counts for the removed package
-            for (const auto* dep : dependencyGraph.at(packageToRemove)) {
-                if (tempRefCount.count(dep)) {
-                    tempRefCount[dep]--;
-                }
-            }
-
-            // Check if this removal invalidates any other packages still in the bag
-            for (const Package* otherPackage : packagesInVec) {
-                if (processedForEjection.count(otherPackage)) continue; // Already slated for removal
-
-                // Check dependencies of the other package
-                for (const auto* dep : dependencyGraph.at(otherPackage)) {
-                    // If a required dependency now has zero references, this package is also invalid
-                    if (tempRefCount.count(dep) && tempRefCount.at(dep) == 0) {
-                        packagesToProcess.push_back(otherPackage);
-                        processedForEjection.insert(otherPackage);
-                        break; // Move to the next package
-                    }
-                }
-            }
-        }
+        // 2. The cascading removal is cached until a move changes one of its dependencies
+        const MoveEvaluationCache::EjectionChain& chain = moveCache.ejectionChain(currentBag, triggerPackage);
 
         // If removing the trigger didn't invalidate anything else, it's not a chain. Skip it.
-        if (currentEjectionSet.size() <= 1) {
+        if (chain.packages.size() <= 1) {
             continue;
         }
 
-        // --- Calculate Post-Removal State ---
-        int removedBenefit = 0;
-        int sizeAfterRemoval = currentBag.getSize();
-
-        // Calculate benefit removed and size reduction
-        for (const auto* p_removed : currentEjectionSet) {
-            removedBenefit += p_removed->getBenefit();
-        }
-        for (const auto& pair : tempRefCount) {
-            if (pair.second == 0 && originalRefCount.at(pair.first) > 0) {
-                sizeAfterRemoval -= pair.first->getSize();
-            }
-        }
+        const int sizeAfterRemoval = currentBag.getSize() - chain.freedSize;
 
         // 3. Find the best package to add into the newly created space
         for (Package* p_out : packagesOutsideBag) {
-            int delta = p_out->getBenefit() - removedBenefit;
+            int delta = p_out->getBenefit() - chain.removedBenefit;
             if (delta <= bestMove.delta) continue;
 
             // Check feasibility by calculating size increase
             int sizeIncrease = 0;
             for (const auto* dep : dependencyGraph.at(p_out)) {
-                // If the dependency is not present in our simulated state, its size is added
-                if (tempRefCount.count(dep) == 0 || tempRefCount.at(dep) == 0) {
+                // A dependency outside the bag, or freed by the chain, adds its size
+                if (refCount.count(dep) == 0 || chain.freedDependencies.count(dep)) {
                     sizeIncrease += dep->getSize();
                 }
             }
 
             if ((sizeAfterRemoval + sizeIncrease) <= bagSize) {
-                bestMove = {delta, currentEjectionSet, p_out};
+                bestMove = {delta, &chain, p_out};
             }
         }
     }
 
     // 4. If a valid, improving move was found, apply it to the actual bag
     if (bestMove.packageToAdd) {
-        for (const auto* p_to_remove : bestMove.ejectionSet) {
+        const std::vector<const Package*> ejectionSet = bestMove.chain->packages;
+        for (const auto* p_to_remove : ejectionSet) {
             currentBag.removePackage(*p_to_remove, dependencyGraph.at(p_to_remove));
         }
-        // <-- FIX: Call addPackageIfPossible and pass bagSize
         currentBag.addPackageIfPossible(*bestMove.packageToAdd, bagSize, dependencyGraph.at(bestMove.packageToAdd));
+        moveCache.onMoveApplied(currentBag, ejectionSet, {bestMove.packageToAdd});
         return true;
     }
 
     return false;
 }
 
+// =====================================================================================
+// Sampled Neighborhoods (large instances)
+// =====================================================================================
+
+/**
+ * @brief Applies the best improving move of a sampled neighborhood.
+ *
+ * Packages to remove are drawn from the bag. Packages to add are drawn for
+ * OVERLAP_SHARE of the sample from the overlap list of a package being
+ * removed (packages sharing one of its dependencies, which reuse or free
+ * that dependency), and uniformly otherwise. The sample is sized to the
+ * evaluation rate measured by earlier iterations so that an iteration takes
+ * about SAMPLED_ITERATION_SECONDS, and is cut at MAX_SAMPLED_ITERATION_SECONDS.
+ */
+bool SearchEngine::exploreSampledNeighborhood(
+    const SEARCH_ENGINE::MovementType& move, Bag& currentBag, int bagSize,
+    const std::vector<Package*>& allPackages,
+    const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+    int maxIterations, MoveEvaluationCache& moveCache, SampledBagIndex& bagIndex)
+{
+    PERF_COUNTERS::ScopedSample perfSample(move);
+    if (allPackages.empty() || move == SEARCH_ENGINE::MovementType::NONE) return false;
+
+    // The index follows the moves applied here; it is only rebuilt if the bag changed elsewhere.
+    const auto& packagesInBag = currentBag.getPackages();
+    if (bagIndex.packages.size() != packagesInBag.size()) bagIndex.rebuild(currentBag);
+    const std::vector<const Package*>& packagesInVec = bagIndex.packages;
+    const bool needsPackageIn = move != SEARCH_ENGINE::MovementType::ADD;
+    if (needsPackageIn && packagesInVec.empty()) return false;
+    if (move == SEARCH_ENGINE::MovementType::SWAP_REMOVE_2_ADD_1 && packagesInVec.size() < 2) return false;
+
+    DependencyUsers& users = dependencyUsers(dependencyGraph);
+    auto randomIndex = [this](size_t size) {
+        return std::uniform_int_distribution<size_t>(0, size - 1)(m_rng);
+    };
+    auto randomOutside = [&]() -> const Package* {
+        for (int retry = 0; retry < SAMPLE_RETRIES; ++retry) {
+            const Package* candidate = allPackages[randomIndex(allPackages.size())];
+            if (!packagesInBag.count(candidate)) return candidate;
+        }
+        return nullptr;
+    };
+    // A package outside the bag sharing a random dependency of anchor.
+    auto overlapping = [&](const Package* anchor) -> const Package* {
+        const auto& dependencies = dependencyGraph.at(anchor);
+        if (dependencies.empty()) return nullptr;
+        for (int retry = 0; retry < SAMPLE_RETRIES; ++retry) {
+            const auto& candidates = users.of(dependencies[randomIndex(dependencies.size())]);
+            const Package* candidate = candidates[randomIndex(candidates.size())];
+            if (!packagesInBag.count(candidate)) return candidate;
+        }
+        return nullptr;
+    };
+
+    const int sampleCap = std::max(1, maxIterations);
+    const int sampleSize = std::clamp(static_cast<int>(m_sampledEvaluationsPerSecond * SAMPLED_ITERATION_SECONDS),
+                                      std::min(MIN_SAMPLE_SIZE, sampleCap), sampleCap);
+    const int overlapQuota = static_cast<int>(sampleSize * OVERLAP_SHARE);
+
+    struct BestMove {
+        int delta = 0;
+        const Package* in[2] = {nullptr, nullptr};
+        const Package* out[2] = {nullptr, nullptr};
+        const MoveEvaluationCache::EjectionChain* chain = nullptr;
+    };
+    BestMove bestMove;
+    const auto& refCount = currentBag.getDependencyRefCount();
+    const int currentSize = currentBag.getSize();
+
+    const auto start = std::chrono::steady_clock::now();
+    int evaluations = 0;
+    for (; evaluations < sampleSize; ++evaluations) {
+        if (evaluations % CLOCK_CHECK_INTERVAL == CLOCK_CHECK_INTERVAL - 1 &&
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > MAX_SAMPLED_ITERATION_SECONDS)
+            break;
+
+        const Package* packageIn = needsPackageIn ? packagesInVec[randomIndex(packagesInVec.size())] : nullptr;
+        // ADD has no removed package; anchor its overlap draws on any package of the bag.
+        const Package* anchor = packageIn ? packageIn
+                              : packagesInVec.empty() ? nullptr : packagesInVec[randomIndex(packagesInVec.size())];
+        auto candidateOut = [&]() -> const Package* {
+            const Package* candidate = (anchor && evaluations < overlapQuota) ? overlapping(anchor) : nullptr;
+            return candidate ? candidate : randomOutside();
+        };
+
+        switch (move) {
+            case SEARCH_ENGINE::MovementType::ADD: {
+                const Package* packageOut = candidateOut();
+                if (!packageOut || packageOut->getBenefit() <= bestMove.delta) break;
+                if (currentSize + moveCache.moveSizeChange(currentBag, {}, {packageOut}) <= bagSize)
+                    bestMove = {packageOut->getBenefit(), {}, {packageOut}};
+                break;
+            }
+            case SEARCH_ENGINE::MovementType::SWAP_REMOVE_1_ADD_1: {
+                const Package* packageOut = candidateOut();
+                if (!packageOut) break;
+                const int delta = packageOut->getBenefit() - packageIn->getBenefit();
+                if (delta <= bestMove.delta) break;
+                if (currentSize + moveCache.swapSizeChange(currentBag, packageIn, packageOut) <= bagSize)
+                    bestMove = {delta, {packageIn}, {packageOut}};
+                break;
+            }
+            case SEARCH_ENGINE::MovementType::SWAP_REMOVE_1_ADD_2: {
+                const Package* packageOut1 = candidateOut();
+                const Package* packageOut2 = candidateOut();
+                if (!packageOut1 || !packageOut2 || packageOut1 == packageOut2) break;
+                const int delta = packageOut1->getBenefit() + packageOut2->getBenefit() - packageIn->getBenefit();
+                if (delta <= bestMove.delta) break;
+                if (currentSize + moveCache.moveSizeChange(currentBag, {packageIn}, {packageOut1, packageOut2}) <= bagSize)
+                    bestMove = {delta, {packageIn}, {packageOut1, packageOut2}};
+                break;
+            }
+            case SEARCH_ENGINE::MovementType::SWAP_REMOVE_2_ADD_1: {
+                const Package* packageIn2 = packagesInVec[randomIndex(packagesInVec.size())];
+                const Package* packageOut = candidateOut();
+                if (!packageOut || packageIn2 == packageIn) break;
+                const int delta = packageOut->getBenefit() - packageIn->getBenefit() - packageIn2->getBenefit();
+                if (delta <= bestMove.delta) break;
+                if (currentSize + moveCache.moveSizeChange(currentBag, {packageIn, packageIn2}, {packageOut}) <= bagSize)
+                    bestMove = {delta, {packageIn, packageIn2}, {packageOut}};
+                break;
+            }
+            case SEARCH_ENGINE::MovementType::EJECTION_CHAIN: {
+                const MoveEvaluationCache::EjectionChain& chain = moveCache.ejectionChain(currentBag, packageIn);
+                if (chain.packages.size() <= 1) break;
+                const Package* packageOut = candidateOut();
+                if (!packageOut) break;
+                const int delta = packageOut->getBenefit() - chain.removedBenefit;
+                if (delta <= bestMove.delta) break;
+                int sizeIncrease = 0;
+                for (const auto* dep : dependencyGraph.at(packageOut)) {
+                    if (refCount.count(dep) == 0 || chain.freedDependencies.count(dep)) sizeIncrease += dep->getSize();
+                }
+                if (currentSize - chain.freedSize + sizeIncrease <= bagSize) {
+                    bestMove = {delta, {}, {packageOut}};
+                    bestMove.chain = &chain;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    // Smooth the measured rate; the next sample is sized from it.
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (evaluations > 0 && elapsed > 0.0) {
+        const double rate = evaluations / elapsed;
+        m_sampledEvaluationsPerSecond = m_sampledEvaluationsPerSecond == 0.0
+            ? rate : (1.0 - RATE_SMOOTHING) * m_sampledEvaluationsPerSecond + RATE_SMOOTHING * rate;
+    }
+
+    if (!bestMove.out[0]) return false;
+
+    std::vector<const Package*> removed;
+    if (bestMove.chain) removed = bestMove.chain->packages;
+    for (const Package* packageIn : bestMove.in) if (packageIn) removed.push_back(packageIn);
+    std::vector<const Package*> added;
+    for (const Package* packageOut : bestMove.out) if (packageOut) added.push_back(packageOut);
+
+    for (const Package* packageIn : removed) {
+        currentBag.removePackage(*packageIn, dependencyGraph.at(packageIn));
+        bagIndex.remove(packageIn);
+    }
+    for (const Package* packageOut : added) {
+        if (currentBag.addPackageIfPossible(*packageOut, bagSize, dependencyGraph.at(packageOut)))
+            bagIndex.add(packageOut);
+    }
+    moveCache.onMoveApplied(currentBag, removed, added);
+    return true;
+}
+
+void SearchEngine::SampledBagIndex::rebuild(const Bag& bag)
+{
+    packages.assign(bag.getPackages().begin(), bag.getPackages().end());
+    positions.clear();
+    positions.reserve(packages.size());
+    for (size_t i = 0; i < packages.size(); ++i) positions.emplace(packages[i], i);
+}
+
+void SearchEngine::SampledBagIndex::add(const Package* package)
+{
+    if (positions.emplace(package, packages.size()).second) packages.push_back(package);
+}
+
+void SearchEngine::SampledBagIndex::remove(const Package* package)
+{
+    auto it = positions.find(package);
+    if (it == positions.end()) return;
+    const size_t position = it->second;
+    positions.erase(it);
+    if (position + 1 != packages.size()) {
+        packages[position] = packages.back();
+        positions[packages[position]] = position;
+    }
+    packages.pop_back();
+}
+
+void SearchEngine::onDependencyLinkChanged(const Package* package, const Dependency* dependency)
+{
+    if (m_dependencyUsers) m_dependencyUsers->relink(package, dependency);
+}
+
+DependencyUsers& SearchEngine::dependencyUsers(
+    const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph)
+{
+    if (!m_dependencyUsers || !m_dependencyUsers->matches(dependencyGraph))
+        m_dependencyUsers = std::make_unique<DependencyUsers>(dependencyGraph);
+    return *m_dependencyUsers;
+}
+
 // =====================================================================================
 // Utility Functions
 // =====================================================================================
@@ -6,13 +6,18 @@
 #include <unordered_set>
 #include <random>
 #include <chrono>
+#include <atomic>
+#include <memory>
 
 #include "algorithm.h"
+#include "stepper.h"
 
 // Forward declarations
 class Bag;
 class Package;
 class Dependency;
+class MoveEvaluationCache;
+class DependencyUsers;
 
 namespace SEARCH_ENGINE {
     /**
@@ -36,23 +41,62 @@ namespace SEARCH_ENGINE {
 class SearchEngine {
 public:
     explicit SearchEngine(unsigned int seed = 0);
+    ~SearchEngine();
+    SearchEngine(SearchEngine&&) noexcept;
+    SearchEngine& operator=(SearchEngine&&) noexcept;
 
     // --- Public Metaheuristic Methods ---
     void localSearch(Bag& currentBag, int bagSize, const std::vector<Package*>& allPackages,
                      const SEARCH_ENGINE::MovementType& moveType,
                      ALGORITHM::LOCAL_SEARCH localSearchMethod,
                      const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
-                     int maxIterationsWithoutImprovement, int maxIterations, const std::chrono::time_point<std::chrono::steady_clock>& deadline);
+                     int maxIterationsWithoutImprovement, int maxIterations, const std::chrono::time_point<std::chrono::steady_clock>& deadline,
+                     const std::atomic<bool>* cancelToken = nullptr);
+
+    /**
+     * @brief localSearch as a stepper yielding the bag's benefit after every iteration.
+     *
+     * The bag, packages, dependency graph and this engine must outlive the stepper.
+     */
+    STEPPER::Stepper localSearchSteps(Bag& currentBag, int bagSize, const std::vector<Package*>& allPackages,
+                                      SEARCH_ENGINE::MovementType moveType,
+                                      ALGORITHM::LOCAL_SEARCH localSearchMethod,
+                                      const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+                                      int maxIterationsWithoutImprovement, int maxIterations,
+                                      std::chrono::steady_clock::time_point deadline,
+                                      const std::atomic<bool>* cancelToken = nullptr);
     int getSeed() const;
     std::mt19937& getRandomGenerator();
 
+    /**
+     * @brief Gets the number of moves applied by localSearch since construction.
+     */
+    long long getMovesApplied() const;
+
+    /**
+     * @brief Sets the number of packages from which localSearch samples its neighborhoods.
+     *
+     * From this size on, each iteration evaluates a sample of moves sized to
+     * the measured evaluation rate instead of scanning the outside packages,
+     * so iterations stay short on instances with 10^5 packages.
+     */
+    void setLargeInstanceThreshold(size_t packages);
+
+    /**
+     * @brief Updates the dependency index kept across local searches after the
+     * link between package and dependency changed in the dependency graph.
+     *
+     * Lets an engine outlive small edits of its graph (see Algorithm::reoptimize).
+     */
+    void onDependencyLinkChanged(const Package* package, const Dependency* dependency);
+
 private:
     // --- Core Private Logic ---
     bool applyMovement(const SEARCH_ENGINE::MovementType& move, Bag& currentBag, int bagSize,
         const std::vector<Package*>& packagesOutsideBag,
         ALGORITHM::LOCAL_SEARCH localSearchMethod,
         const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
-        int maxIterations);
+        int maxIterations, MoveEvaluationCache& moveCache);
 
     void perturbation(Bag& currentBag, int bagSize, const std::vector<Package*>& allPackages,
                       const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
@@ -63,16 +107,33 @@ private:
                        const std::vector<Package*>& packagesOutsideBag,
                        const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph);
 
-    // 1-1 Swap Operators
-    bool exploreSwap11NeighborhoodFirstImprovement(Bag&, int, const std::vector<Package*>&, const std::unordered_map<const Package*, std::vector<const Dependency*>>&);
-    bool exploreSwap11NeighborhoodRandomImprovement(Bag&, int, const std::vector<Package*>&, const std::unordered_map<const Package*, std::vector<const Dependency*>>&, int);
-    bool exploreSwap11NeighborhoodBestImprovement(Bag&, int, const std::vector<Package*>&, const std::unordered_map<const Package*, std::vector<const Dependency*>>&, int);
+    // 1-1 Swap Operators (evaluations cached in the MoveEvaluationCache)
+    bool exploreSwap11NeighborhoodFirstImprovement(Bag&, int, const std::vector<Package*>&, const std::unordered_map<const Package*, std::vector<const Dependency*>>&, MoveEvaluationCache&);
+    bool exploreSwap11NeighborhoodRandomImprovement(Bag&, int, const std::vector<Package*>&, const std::unordered_map<const Package*, std::vector<const Dependency*>>&, int, MoveEvaluationCache&);
+    bool exploreSwap11NeighborhoodBestImprovement(Bag&, int, const std::vector<Package*>&, const std::unordered_map<const Package*, std::vector<const Dependency*>>&, int, MoveEvaluationCache&);
 
     // 1-2, 2-1, and Ejection Chain Operators (Best Improvement & First Improvement)
     bool exploreSwap12NeighborhoodBestImprovement(Bag&, int, const std::vector<Package*>&, const std::unordered_map<const Package*, std::vector<const Dependency*>>&, int);
     bool exploreSwap21NeighborhoodBestImprovement(Bag&, int, const std::vector<Package*>&, const std::unordered_map<const Package*, std::vector<const Dependency*>>&, int);
     bool exploreEjectionChainNeighborhoodFirstImprovement(Bag &currentBag, int bagSize, const std::vector<Package *> &packagesOutsideBag, const std::unordered_map<const Package *, std::vector<const Dependency *>> &dependencyGraph);
-    bool exploreEjectionChainNeighborhoodBestImprovement(Bag &, int, const std::vector<Package *> &, const std::unordered_map<const Package *, std::vector<const Dependency *>> &, int);
+    bool exploreEjectionChainNeighborhoodBestImprovement(Bag &, int, const std::vector<Package *> &, const std::unordered_map<const Package *, std::vector<const Dependency *>> &, int, MoveEvaluationCache&);
+
+    // Large-instance mode: the bag's packages, indexable for sampling and updated per applied move
+    struct SampledBagIndex {
+        std::vector<const Package*> packages;
+        std::unordered_map<const Package*, size_t> positions;
+
+        void rebuild(const Bag& bag);
+        void add(const Package* package);
+        void remove(const Package* package);  ///< Swap-remove: O(1), order not kept.
+    };
+
+    // Large-instance mode: best of a sampled neighborhood, every movement type
+    bool exploreSampledNeighborhood(const SEARCH_ENGINE::MovementType& move, Bag& currentBag, int bagSize,
+        const std::vector<Package*>& allPackages,
+        const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+        int maxIterations, MoveEvaluationCache& moveCache, SampledBagIndex& bagIndex);
+    DependencyUsers& dependencyUsers(const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph);
 
     // --- Utility Function ---
     void buildOutsidePackages(const std::unordered_set<const Package*>& packagesInBag,
@@ -81,6 +142,11 @@ private:
     
     std::mt19937 m_rng;
     int m_seed;
+    long long m_movesApplied = 0;
+
+    size_t m_largeInstanceThreshold;
+    double m_sampledEvaluationsPerSecond = 0.0;  ///< Smoothed rate measured by sampled iterations.
+    std::unique_ptr<DependencyUsers> m_dependencyUsers;  ///< Overlap lists, kept across local searches.
 };
 
 #endif // SEARCH_ENGINE_H
\ No newline at end of file
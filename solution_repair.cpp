@@ -2,14 +2,15 @@
 #include "bag.h"
 #include "package.h"
 #include "dependency.h"
+#include "logger.h"
+#include "trace.h"
 
 #include <algorithm>
-#include <unordered_set>
+#include <atomic>
+#include <future>
+#include <queue>
 #include <limits>
 #include <cmath>
-#include <iostream>
-#include <sstream>
-#include <iomanip>
 #include <random>
 
 namespace SOLUTION_REPAIR {
@@ -26,167 +27,313 @@ std::string toString(FEASIBILITY_STRATEGY strategy)
     }
 }
 
+// =====================================================================================
+// Tuning Constants
+// =====================================================================================
+static constexpr size_t PARALLEL_REPAIR_MIN_PACKAGES = 256; // below this, strategies run sequentially
+
 // =====================================================================================
 // Private Helper Functions
 // =====================================================================================
 
-static int computeBagSize(const Bag& bag,
-    const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph)
+/**
+ * @brief Cheap validity check based on the Bag's own incremental counters.
+ *
+ * Bag keeps m_size and the dependency refcounts up to date on every add/remove,
+ * so there is no need to rebuild them from the dependency graph here.
+ */
+static bool isValid(const Bag& bag, int maxCapacity)
 {
-    std::unordered_set<const Dependency*> deps;
-    for (const auto* pkg : bag.getPackages()) {
-        auto it = dependencyGraph.find(pkg);
-        if (it != dependencyGraph.end()) {
-            for (auto* dep : it->second)
-                deps.insert(dep);
-        }
-    }
-    int total = 0;
-    for (auto* d : deps)
-        total += d->getSize();
-    return total;
+    if (bag.getSize() > maxCapacity) return false;
+    return bag.getDependencyRefCount().size() == bag.getDependencies().size();
 }
 
-static bool isValid(const Bag& bag, int maxCapacity,
+/**
+ * @brief Compact, index-based snapshot of the bag shared (read-only) by all strategies.
+ *
+ * Packages and dependencies are renumbered 0..n-1 so that every strategy can
+ * work on flat vectors instead of copying the Bag's hash containers.
+ */
+struct RepairIndex {
+    std::vector<const Package*> packages;   ///< Bagged packages, by local index.
+    std::vector<int> benefit;               ///< Benefit per local package.
+    std::vector<std::vector<int>> deps;     ///< Local dependency indices per package.
+    std::vector<std::vector<int>> holders;  ///< Local package indices per dependency.
+    std::vector<int> depSize;               ///< Size per local dependency.
+    std::vector<int> refCount;              ///< Initial refcount per local dependency.
+    int size = 0;
+    int totalBenefit = 0;
+};
+
+static RepairIndex buildRepairIndex(const Bag& bag,
     const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph)
 {
-    std::unordered_map<const Dependency*, int> ref;
-    int benefit = 0;
-
-    for (const auto* pkg : bag.getPackages()) {
-        if (!pkg) continue;
-        benefit += pkg->getBenefit();
-        auto it = dependencyGraph.find(pkg);
-        if (it == dependencyGraph.end()) return false;
-        for (auto* dep : it->second) ref[dep]++;
+    RepairIndex index;
+    const auto& refCounts = bag.getDependencyRefCount();
+    std::unordered_map<const Dependency*, int> depIndex;
+    depIndex.reserve(refCounts.size());
+    index.depSize.reserve(refCounts.size());
+    index.refCount.reserve(refCounts.size());
+    for (const auto& [dep, count] : refCounts) {
+        depIndex.emplace(dep, static_cast<int>(index.depSize.size()));
+        index.depSize.push_back(dep->getSize());
+        index.refCount.push_back(count);
     }
+    index.holders.resize(index.depSize.size());
 
-    int size = 0;
-    for (auto& kv : ref)
-        if (kv.second > 0)
-            size += kv.first->getSize();
-
-    if (benefit != bag.getBenefit()) return false;
-    if (size != bag.getSize()) return false;
-    if (size > maxCapacity) return false;
-    return true;
+    const size_t n = bag.getPackages().size();
+    index.packages.reserve(n);
+    index.benefit.reserve(n);
+    index.deps.reserve(n);
+    for (const Package* pkg : bag.getPackages()) {
+        const int p = static_cast<int>(index.packages.size());
+        index.packages.push_back(pkg);
+        index.benefit.push_back(pkg->getBenefit());
+        std::vector<int> local;
+        for (const auto* dep : dependencyGraph.at(pkg)) {
+            auto it = depIndex.find(dep);
+            if (it == depIndex.end()) continue;
+            local.push_back(it->second);
+            index.holders[it->second].push_back(p);
+        }
+        index.deps.push_back(std::move(local));
+    }
+    index.size = bag.getSize();
+    index.totalBenefit = bag.getBenefit();
+    return index;
 }
 
 struct PackageScore {
-    const Package* pkg = nullptr;
-    int benefit = 0;
     int uniqueSize = 0;
     double efficiency = 0.0;
     double inefficiency = 0.0;
     double smartScore = 0.0;
 };
 
-static std::vector<PackageScore> scorePackages(
-    const Bag& bag,
-    const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph)
+static PackageScore scorePackage(int benefit, int uniqueSize)
 {
-    std::vector<PackageScore> scores;
-    scores.reserve(bag.getPackages().size());
-    const auto& refCounts = bag.getDependencyRefCount();
-
-    for (const Package* pkg : bag.getPackages()) {
-        PackageScore s;
-        s.pkg = pkg;
-        s.benefit = pkg->getBenefit();
-        s.uniqueSize = 0;
-
-        const auto& deps = dependencyGraph.at(pkg);
-        for (const auto* dep : deps) {
-            if (refCounts.at(dep) == 1) s.uniqueSize += dep->getSize();
-        }
-
-        s.efficiency = (s.uniqueSize > 0) ? static_cast<double>(s.benefit) / s.uniqueSize
-                                          : ((s.benefit > 0) ? std::numeric_limits<double>::max() : 0.0);
-        s.inefficiency = (s.benefit > 0) ? static_cast<double>(s.uniqueSize) / s.benefit
-                                         : ((s.uniqueSize > 0) ? std::numeric_limits<double>::max() : 0.0);
-        s.smartScore = (s.efficiency * 0.7) + (static_cast<double>(s.benefit) * 0.3);
-
-        scores.push_back(s);
-    }
-    return scores;
+    PackageScore s;
+    s.uniqueSize = uniqueSize;
+    s.efficiency = (uniqueSize > 0) ? static_cast<double>(benefit) / uniqueSize
+                                    : ((benefit > 0) ? std::numeric_limits<double>::max() : 0.0);
+    s.inefficiency = (benefit > 0) ? static_cast<double>(uniqueSize) / benefit
+                                   : ((uniqueSize > 0) ? std::numeric_limits<double>::max() : 0.0);
+    s.smartScore = (s.efficiency * 0.7) + (static_cast<double>(benefit) * 0.3);
+    return s;
 }
 
-static const Package* selectProbabilistic(const std::vector<PackageScore>& scores, std::mt19937& rng) {
-    double totalInefficiency = 0.0;
-    for (const auto& s : scores) totalInefficiency += s.inefficiency;
-
-    if (totalInefficiency == 0.0) {
-        std::uniform_int_distribution<int> dist_idx(0, scores.size() - 1);
-        return scores[dist_idx(rng)].pkg;
+/**
+ * @brief Fenwick tree over package inefficiencies for O(log n) roulette selection.
+ */
+class InefficiencyTree {
+public:
+    explicit InefficiencyTree(size_t n) : m_tree(n + 1, 0.0), m_values(n, 0.0) {}
+
+    void set(int i, double value) {
+        const double delta = value - m_values[i];
+        m_values[i] = value;
+        for (size_t k = static_cast<size_t>(i) + 1; k < m_tree.size(); k += k & (~k + 1))
+            m_tree[k] += delta;
     }
 
-    std::uniform_real_distribution<double> dist_roll(0.0, totalInefficiency);
-    double roll = dist_roll(rng);
-    double currentSum = 0.0;
-    for (const auto& s : scores) {
-        currentSum += s.inefficiency;
-        if (roll <= currentSum) return s.pkg;
+    double total() const {
+        double sum = 0.0;
+        for (size_t k = m_tree.size() - 1; k > 0; k -= k & (~k + 1)) sum += m_tree[k];
+        return sum;
     }
-    return scores.back().pkg;
-}
-
-static const Package* selectTemperatureBiased(const std::vector<PackageScore>& scores, double temperature, std::mt19937& rng) {
-    const Package* worstPkg = nullptr;
-    double worstScore = std::numeric_limits<double>::max();
 
-    for (const auto& s : scores) {
-        std::uniform_real_distribution<double> dist_noise(1.0 - temperature, 1.0 + temperature);
-        double noisyScore = s.smartScore * dist_noise(rng);
-        if (noisyScore < worstScore) {
-            worstScore = noisyScore;
-            worstPkg = s.pkg;
+    /// Smallest index whose prefix sum reaches 'roll'.
+    int find(double roll) const {
+        size_t pos = 0;
+        size_t step = 1;
+        while (step * 2 < m_tree.size()) step *= 2;
+        for (; step > 0; step /= 2) {
+            if (pos + step < m_tree.size() && m_tree[pos + step] < roll) {
+                pos += step;
+                roll -= m_tree[pos];
+            }
         }
+        return static_cast<int>(std::min(pos, m_values.size() - 1));
     }
-    return worstPkg;
-}
 
-static bool fixWithStrategy(Bag& bag, int maxCapacity,
-    const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+private:
+    std::vector<double> m_tree;
+    std::vector<double> m_values;
+};
+
+/**
+ * @brief Result of one repair strategy: which local packages to drop and the benefit left.
+ */
+struct RepairOutcome {
+    FEASIBILITY_STRATEGY strategy = FEASIBILITY_STRATEGY::NONE;
+    std::vector<int> removed;
+    int benefit = 0;
+    bool feasible = false;
+    bool aborted = false;
+};
+
+/**
+ * @brief Runs one removal strategy on the index with incrementally maintained scores.
+ *
+ * A package's removal gain only changes when one of its dependencies drops to a
+ * refcount of 1, so each removal re-scores just the affected holders. SMART and
+ * TEMPERATURE_BIASED read a lazy min-heap of smart scores, PROBABILISTIC_GREEDY
+ * samples a Fenwick tree of inefficiencies.
+ *
+ * Benefit only decreases while removing, so the run aborts as soon as it falls
+ * below the best benefit another strategy has already reached feasibly.
+ */
+static RepairOutcome fixWithStrategy(const RepairIndex& index, int maxCapacity,
     FEASIBILITY_STRATEGY strategy,
-    unsigned int seed)
+    unsigned int seed,
+    std::atomic<int>& bestFeasibleBenefit)
 {
     std::mt19937 rng(seed);
+    RepairOutcome outcome;
+    outcome.strategy = strategy;
+
+    const int n = static_cast<int>(index.packages.size());
+    std::vector<int> refCount = index.refCount;
+    std::vector<char> alive(n, 1);
+    std::vector<unsigned int> version(n, 0);
+    std::vector<PackageScore> scores(n);
+    int aliveCount = n;
+    int currentSize = index.size;
+    int currentBenefit = index.totalBenefit;
+    const double initialOver = static_cast<double>(currentSize - maxCapacity);
+
+    for (int p = 0; p < n; ++p) {
+        int uniqueSize = 0;
+        for (int d : index.deps[p])
+            if (refCount[d] == 1) uniqueSize += index.depSize[d];
+        scores[p] = scorePackage(index.benefit[p], uniqueSize);
+    }
 
-    int currentSize = computeBagSize(bag, dependencyGraph);
-    double initialOver = static_cast<double>(currentSize - maxCapacity);
+    // Lazy min-heap on smartScore: stale entries are skipped by version check.
+    struct HeapEntry { double score; int pkg; unsigned int version; };
+    auto heapCmp = [](const HeapEntry& a, const HeapEntry& b) { return a.score > b.score; };
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, decltype(heapCmp)> heap(heapCmp);
+    std::unique_ptr<InefficiencyTree> tree;
+
+    const bool useHeap = (strategy != FEASIBILITY_STRATEGY::PROBABILISTIC_GREEDY);
+    if (useHeap) {
+        for (int p = 0; p < n; ++p) heap.push({scores[p].smartScore, p, 0});
+    } else {
+        tree = std::make_unique<InefficiencyTree>(n);
+        for (int p = 0; p < n; ++p) tree->set(p, scores[p].inefficiency);
+    }
+
+    auto rescore = [&](int p) {
+        int uniqueSize = 0;
+        for (int d : index.deps[p])
+            if (refCount[d] == 1) uniqueSize += index.depSize[d];
+        scores[p] = scorePackage(index.benefit[p], uniqueSize);
+        ++version[p];
+        if (useHeap) heap.push({scores[p].smartScore, p, version[p]});
+        else tree->set(p, scores[p].inefficiency);
+    };
+
+    auto popValid = [&](HeapEntry& out) {
+        while (!heap.empty()) {
+            out = heap.top();
+            heap.pop();
+            if (alive[out.pkg] && version[out.pkg] == out.version) return true;
+        }
+        return false;
+    };
 
-    while (currentSize > maxCapacity && !bag.getPackages().empty()) {
-        auto scores = scorePackages(bag, dependencyGraph);
-        if (scores.empty()) break;
+    std::vector<HeapEntry> scratch;
+    std::vector<int> touched;
 
-        const Package* pkgToRemove = nullptr;
+    while (currentSize > maxCapacity && aliveCount > 0) {
+        int pkgToRemove = -1;
         switch (strategy) {
             case FEASIBILITY_STRATEGY::SMART: {
-                bag.setFeasibilityStrategy(FEASIBILITY_STRATEGY::SMART);
-                pkgToRemove = std::min_element(scores.begin(), scores.end(),
-                                               [](const PackageScore& a, const PackageScore& b) {
-                                                   return a.smartScore < b.smartScore;
-                                               })->pkg;
+                HeapEntry top{};
+                if (popValid(top)) pkgToRemove = top.pkg;
                 break;
             }
             case FEASIBILITY_STRATEGY::TEMPERATURE_BIASED: {
-                bag.setFeasibilityStrategy(FEASIBILITY_STRATEGY::TEMPERATURE_BIASED);
                 double temperature = std::max(0.0, (currentSize - maxCapacity) / initialOver);
-                pkgToRemove = selectTemperatureBiased(scores, temperature, rng);
+                std::uniform_real_distribution<double> dist_noise(1.0 - temperature, 1.0 + temperature);
+
+                // Only packages whose best-case noisy score can beat the worst-case
+                // noisy score of the minimum are worth drawing noise for.
+                scratch.clear();
+                HeapEntry entry{};
+                double bound = std::numeric_limits<double>::infinity();
+                double worstScore = std::numeric_limits<double>::max();
+                while (popValid(entry)) {
+                    scratch.push_back(entry);
+                    if (scratch.size() == 1 && temperature < 1.0)
+                        bound = entry.score * (1.0 + temperature) / (1.0 - temperature);
+                    if (entry.score > bound) break;
+                    double noisyScore = entry.score * dist_noise(rng);
+                    if (noisyScore < worstScore) {
+                        worstScore = noisyScore;
+                        pkgToRemove = entry.pkg;
+                    }
+                }
+                for (const auto& e : scratch)
+                    if (e.pkg != pkgToRemove) heap.push(e);
                 break;
             }
-            default:{
-                bag.setFeasibilityStrategy(FEASIBILITY_STRATEGY::PROBABILISTIC_GREEDY);
-                pkgToRemove = selectProbabilistic(scores, rng);
+            default: {
+                double totalInefficiency = tree->total();
+                if (totalInefficiency <= 0.0 || !std::isfinite(totalInefficiency)) {
+                    std::uniform_int_distribution<int> dist_idx(0, aliveCount - 1);
+                    int target = dist_idx(rng);
+                    for (int p = 0; p < n; ++p)
+                        if (alive[p] && target-- == 0) { pkgToRemove = p; break; }
+                } else {
+                    std::uniform_real_distribution<double> dist_roll(0.0, totalInefficiency);
+                    pkgToRemove = tree->find(dist_roll(rng));
+                    // Rounding drift can land on a removed slot; fall back to the first alive one.
+                    if (!alive[pkgToRemove])
+                        pkgToRemove = static_cast<int>(std::find(alive.begin(), alive.end(), 1) - alive.begin());
+                }
                 break;
             }
         }
+        if (pkgToRemove < 0) break;
+
+        // --- Remove the package and update only the affected holders ---
+        alive[pkgToRemove] = 0;
+        --aliveCount;
+        ++version[pkgToRemove];
+        if (tree) tree->set(pkgToRemove, 0.0);
+        outcome.removed.push_back(pkgToRemove);
+        currentBenefit -= index.benefit[pkgToRemove];
+
+        touched.clear();
+        for (int d : index.deps[pkgToRemove]) {
+            int& ref = refCount[d];
+            if (--ref == 0) {
+                currentSize -= index.depSize[d];
+            } else if (ref == 1) {
+                for (int h : index.holders[d]) {
+                    if (alive[h]) { touched.push_back(h); break; }
+                }
+            }
+        }
+        std::sort(touched.begin(), touched.end());
+        touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+        for (int h : touched) rescore(h);
 
-        if (pkgToRemove) bag.removePackage(*pkgToRemove, dependencyGraph.at(pkgToRemove));
-        currentSize = computeBagSize(bag, dependencyGraph);
+        if (currentBenefit < bestFeasibleBenefit.load(std::memory_order_relaxed)) {
+            outcome.aborted = true;
+            break;
+        }
     }
-    bag.setFeasibilityStrategy(FEASIBILITY_STRATEGY::NONE);
-    return (currentSize <= maxCapacity);
+
+    outcome.benefit = currentBenefit;
+    outcome.feasible = !outcome.aborted && currentSize <= maxCapacity;
+    if (outcome.feasible) {
+        int expected = bestFeasibleBenefit.load(std::memory_order_relaxed);
+        while (currentBenefit > expected &&
+               !bestFeasibleBenefit.compare_exchange_weak(expected, currentBenefit, std::memory_order_relaxed)) {}
+    }
+    return outcome;
 }
 
 // =====================================================================================
@@ -196,46 +343,57 @@ bool repair(Bag& bag, int maxCapacity,
             const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
             unsigned int seed)
 {
-    std::ostringstream log;
-    if (isValid(bag, maxCapacity, dependencyGraph)) {
-        log << "\n[REPAIR] Bag is valid. Skip auto-repair.\n";
-        std::cout << log.str();
+    if (isValid(bag, maxCapacity)) {
+        LOG_TRACE("[REPAIR] Bag is valid. Skip auto-repair.");
         return true;
     }
-
-    log << "\n[REPAIR] Bag invalid. Starting sequential auto-repair...\n";
-    log << "Initial state: size=" << bag.getSize() << ", benefit=" << bag.getBenefit()
-        << " (Capacity: " << maxCapacity << ")\n";
-
-    Bag bagSmart = bag;
-    Bag bagProb = bag;
-    Bag bagTemp = bag;
-
-    // Sequential repairs
-    fixWithStrategy(bagSmart, maxCapacity, dependencyGraph, FEASIBILITY_STRATEGY::SMART, seed);
-    fixWithStrategy(bagProb, maxCapacity, dependencyGraph, FEASIBILITY_STRATEGY::PROBABILISTIC_GREEDY, seed);
-    fixWithStrategy(bagTemp, maxCapacity, dependencyGraph, FEASIBILITY_STRATEGY::TEMPERATURE_BIASED, seed);
-
-    Bag* bestBag = &bagSmart;
-    std::string bestStrategy = "SMART";
-    if (bagProb.getBenefit() > bestBag->getBenefit()) {
-        bestBag = &bagProb;
-        bestStrategy = "PROBABILISTIC_GREEDY";
-    }
-    if (bagTemp.getBenefit() > bestBag->getBenefit()) {
-        bestBag = &bagTemp;
-        bestStrategy = "TEMPERATURE_BIASED";
+    TRACE::ScopedEvent trace("repair", "repair");
+
+    LOG_DEBUG("[REPAIR] Bag invalid. Starting auto-repair. Initial state: size=" << bag.getSize()
+              << ", benefit=" << bag.getBenefit() << " (Capacity: " << maxCapacity << ")");
+
+    const RepairIndex index = buildRepairIndex(bag, dependencyGraph);
+    std::atomic<int> bestFeasibleBenefit{std::numeric_limits<int>::min()};
+
+    // SMART is deterministic and usually the strongest, so it runs on the calling
+    // thread and sets the bar the randomized strategies must beat.
+    RepairOutcome outcomes[3];
+    if (index.packages.size() >= PARALLEL_REPAIR_MIN_PACKAGES) {
+        auto probFuture = std::async(std::launch::async, fixWithStrategy, std::cref(index), maxCapacity,
+                                     FEASIBILITY_STRATEGY::PROBABILISTIC_GREEDY, seed, std::ref(bestFeasibleBenefit));
+        auto tempFuture = std::async(std::launch::async, fixWithStrategy, std::cref(index), maxCapacity,
+                                     FEASIBILITY_STRATEGY::TEMPERATURE_BIASED, seed, std::ref(bestFeasibleBenefit));
+        outcomes[0] = fixWithStrategy(index, maxCapacity, FEASIBILITY_STRATEGY::SMART, seed, bestFeasibleBenefit);
+        outcomes[1] = probFuture.get();
+        outcomes[2] = tempFuture.get();
+    } else {
+        outcomes[0] = fixWithStrategy(index, maxCapacity, FEASIBILITY_STRATEGY::SMART, seed, bestFeasibleBenefit);
+        outcomes[1] = fixWithStrategy(index, maxCapacity, FEASIBILITY_STRATEGY::PROBABILISTIC_GREEDY, seed, bestFeasibleBenefit);
+        outcomes[2] = fixWithStrategy(index, maxCapacity, FEASIBILITY_STRATEGY::TEMPERATURE_BIASED, seed, bestFeasibleBenefit);
     }
 
-    bag = std::move(*bestBag);
+    // Ties keep the SMART > PROBABILISTIC_GREEDY > TEMPERATURE_BIASED order.
+    const RepairOutcome* best = nullptr;
+    for (const auto& outcome : outcomes) {
+        if (outcome.aborted) continue;
+        if (!best || (outcome.feasible && !best->feasible) ||
+            (outcome.feasible == best->feasible && outcome.benefit > best->benefit))
+            best = &outcome;
+    }
 
-    log << "Best strategy chosen: " << bestStrategy << "\n";
-    log << "After repair: size=" << bag.getSize() << " / " << maxCapacity
-        << ", benefit=" << bag.getBenefit() << "\n";
+    if (best) {
+        for (int p : best->removed) {
+            const Package* pkg = index.packages[p];
+            bag.removePackage(*pkg, dependencyGraph.at(pkg));
+        }
+        bag.setFeasibilityStrategy(best->strategy);
+    }
+    LOG_DEBUG("[REPAIR] Best strategy chosen: " << (best ? toString(best->strategy) : "none")
+              << ". After repair: size=" << bag.getSize() << " / " << maxCapacity
+              << ", benefit=" << bag.getBenefit());
 
-    bool isValidAfterRepair = isValid(bag, maxCapacity, dependencyGraph);
-    if (!isValidAfterRepair) log << "[WARNING] Bag remains invalid after repair!\n";
-    std::cout << log.str();
+    bool isValidAfterRepair = isValid(bag, maxCapacity);
+    if (!isValidAfterRepair) LOG_WARNING("[REPAIR] Bag remains invalid after repair!");
 
     return isValidAfterRepair;
 }
@@ -23,10 +23,12 @@ enum class FEASIBILITY_STRATEGY {
 /**
  * @brief Validates and, if necessary, repairs a Bag.
  *
- * This function first validates the Bag's internal state. If invalid,
- * it tests three parallel repair strategies (SMART, PROBABILISTIC_GREEDY,
- * TEMPERATURE_BIASED) on copies of the Bag. The original Bag is then
- * replaced with the best (highest benefit) feasible result.
+ * Validity is checked against the Bag's own size and refcount counters. If
+ * invalid, three repair strategies (SMART, PROBABILISTIC_GREEDY,
+ * TEMPERATURE_BIASED) run concurrently on a compact index of the Bag, each
+ * keeping its removal scores up to date incrementally and giving up as soon
+ * as it falls behind a feasible result. Only the removals of the best
+ * (highest benefit) strategy are applied to the original Bag.
  *
  * @param bag The Bag to validate and repair.
  * @param maxCapacity The maximum allowed capacity.
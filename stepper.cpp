@@ -0,0 +1,212 @@
+#include "stepper.h"
+
+#include "logger.h"
+#include "trace.h"
+
+#include <thread>
+#include <utility>
+
+static constexpr double SLICE_SECONDS = 0.005;     // stepping time per slice
+static constexpr int WARMUP_SLICES = 3;            // slices each stepper gets before rates are compared
+static constexpr int EXPLORE_INTERVAL = 8;         // every Nth slice goes to the longest-waiting stepper
+static constexpr double RATE_SMOOTHING = 0.5;      // weight of the latest slice in the improvement rate
+
+namespace STEPPER {
+
+// =====================================================================================
+// Stepper
+// =====================================================================================
+Stepper::~Stepper()
+{
+    if (m_handle) m_handle.destroy();
+}
+
+Stepper::Stepper(Stepper&& other) noexcept
+    : m_handle(std::exchange(other.m_handle, nullptr))
+{
+}
+
+Stepper& Stepper::operator=(Stepper&& other) noexcept
+{
+    if (this != &other) {
+        if (m_handle) m_handle.destroy();
+        m_handle = std::exchange(other.m_handle, nullptr);
+    }
+    return *this;
+}
+
+bool Stepper::step()
+{
+    if (done()) return false;
+    m_handle.resume();
+    if (m_handle.promise().exception) std::rethrow_exception(std::exchange(m_handle.promise().exception, nullptr));
+    return !m_handle.done();
+}
+
+void Stepper::finish()
+{
+    while (step()) {}
+}
+
+bool Stepper::done() const
+{
+    return !m_handle || m_handle.done();
+}
+
+int Stepper::benefit() const
+{
+    return m_handle ? m_handle.promise().benefit : 0;
+}
+
+// =====================================================================================
+// Portfolio
+// =====================================================================================
+size_t Portfolio::add(std::string name, Stepper stepper)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Slot slot;
+    slot.entry.name = std::move(name);
+    slot.entry.done = stepper.done();
+    slot.stepper = std::move(stepper);
+    m_slots.push_back(std::move(slot));
+    return m_slots.size() - 1;
+}
+
+void Portfolio::pause(size_t id)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (id < m_slots.size()) m_slots[id].entry.paused = true;
+}
+
+void Portfolio::resume(size_t id)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (id < m_slots.size()) m_slots[id].entry.paused = false;
+    }
+    m_cv.notify_all();
+}
+
+void Portfolio::setCancelToken(const std::atomic<bool>* cancelToken)
+{
+    m_cancelToken = cancelToken;
+}
+
+std::vector<Portfolio::Entry> Portfolio::entries() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<Entry> entries;
+    entries.reserve(m_slots.size());
+    for (const Slot& slot : m_slots) entries.push_back(slot.entry);
+    return entries;
+}
+
+int Portfolio::best() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    int best = -1;
+    for (size_t id = 0; id < m_slots.size(); ++id) {
+        if (best < 0 || m_slots[id].entry.benefit > m_slots[best].entry.benefit) best = static_cast<int>(id);
+    }
+    return best;
+}
+
+void Portfolio::run(unsigned int threads, const std::chrono::steady_clock::time_point& deadline)
+{
+    threads = std::max(1u, threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+    for (unsigned int t = 1; t < threads; ++t) workers.emplace_back(&Portfolio::worker, this, deadline);
+    worker(deadline);
+    for (auto& w : workers) w.join();
+}
+
+int Portfolio::pickLocked()
+{
+    int pick = -1;
+    auto ready = [&](const Slot& slot) { return !slot.running && !slot.entry.done && !slot.entry.paused; };
+
+    // Measure every stepper first.
+    for (size_t id = 0; id < m_slots.size(); ++id) {
+        const Slot& slot = m_slots[id];
+        if (ready(slot) && slot.entry.slices < WARMUP_SLICES &&
+            (pick < 0 || slot.entry.slices < m_slots[pick].entry.slices)) pick = static_cast<int>(id);
+    }
+    if (pick >= 0) return pick;
+
+    const bool explore = m_slicesHandedOut % EXPLORE_INTERVAL == EXPLORE_INTERVAL - 1;
+    for (size_t id = 0; id < m_slots.size(); ++id) {
+        const Slot& slot = m_slots[id];
+        if (!ready(slot)) continue;
+        if (pick < 0) {
+            pick = static_cast<int>(id);
+            continue;
+        }
+        const Slot& current = m_slots[pick];
+        const bool better = explore ? slot.lastSlice < current.lastSlice
+                                    : slot.entry.rate > current.entry.rate ||
+                                      (slot.entry.rate == current.entry.rate && slot.lastSlice < current.lastSlice);
+        if (better) pick = static_cast<int>(id);
+    }
+    return pick;
+}
+
+void Portfolio::worker(const std::chrono::steady_clock::time_point& deadline)
+{
+    TRACE::setThreadName("Portfolio worker");
+    auto cancelled = [this] { return m_cancelToken && m_cancelToken->load(std::memory_order_relaxed); };
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (std::chrono::steady_clock::now() < deadline && !cancelled()) {
+        const int id = pickLocked();
+        if (id < 0) {
+            // Nothing runnable: finished unless another thread still holds a stepper.
+            bool anyRunning = false;
+            for (const Slot& slot : m_slots) anyRunning |= slot.running;
+            if (!anyRunning) break;
+            m_cv.wait_until(lock, deadline);
+            continue;
+        }
+
+        Slot& slot = m_slots[id];
+        slot.running = true;
+        slot.lastSlice = m_slicesHandedOut++;
+        const bool firstSlice = slot.entry.slices == 0;
+        int benefitBefore = slot.entry.benefit;
+        lock.unlock();
+
+        // One slice: step until it has used its time or the search ends.
+        long long steps = 0;
+        bool finished = false;
+        const auto start = std::chrono::steady_clock::now();
+        auto elapsed = std::chrono::duration<double>::zero();
+        {
+            TRACE::ScopedEvent trace("portfolio", "slice");
+            try {
+                do {
+                    finished = !slot.stepper.step();
+                    // A search's first unit yields its starting point, which is not progress.
+                    if (firstSlice && steps == 0) benefitBefore = slot.stepper.benefit();
+                    ++steps;
+                    elapsed = std::chrono::steady_clock::now() - start;
+                } while (!finished && elapsed.count() < SLICE_SECONDS && start + elapsed < deadline && !cancelled());
+            } catch (const std::exception& e) {
+                LOG_WARNING("[PORTFOLIO] " << slot.entry.name << " failed: " << e.what());
+                finished = true;
+            }
+        }
+
+        lock.lock();
+        slot.running = false;
+        slot.entry.done = finished;
+        slot.entry.benefit = slot.stepper.benefit();
+        slot.entry.steps += steps;
+        ++slot.entry.slices;
+        slot.entry.seconds += elapsed.count();
+        const double rate = elapsed.count() > 0.0 ? (slot.entry.benefit - benefitBefore) / elapsed.count() : 0.0;
+        slot.entry.rate = slot.entry.slices == 1 ? rate
+                                                 : (1.0 - RATE_SMOOTHING) * slot.entry.rate + RATE_SMOOTHING * rate;
+        m_cv.notify_all();
+    }
+}
+
+} // namespace STEPPER
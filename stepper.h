@@ -0,0 +1,159 @@
+#ifndef STEPPER_H
+#define STEPPER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Metaheuristics as C++20 coroutines that run in bounded work units.
+ *
+ * A Stepper is a suspended search: step() runs it until its next co_yield
+ * (one local search iteration, one shake, one construction...) and returns.
+ * The blocking entry points (SearchEngine::localSearch, VND::run,
+ * VNS_HELPER::vnsLoop, the GRASP workers) drive the same steppers to
+ * completion, so both modes share one implementation.
+ *
+ * A Portfolio interleaves many steppers on a few threads and gives the time
+ * slices to whichever improves fastest (see Algorithm::setPortfolio).
+ */
+namespace STEPPER {
+
+/**
+ * @brief A coroutine yielding the benefit of its best bag after each work unit.
+ *
+ * The stepper only holds references to what it was started with (bags,
+ * packages, dependency graph, search engine); they must outlive it. It can
+ * be stepped from any thread, but from one thread at a time.
+ */
+class Stepper {
+public:
+    struct promise_type {
+        int benefit = 0;
+        std::exception_ptr exception;
+
+        Stepper get_return_object() {
+            return Stepper(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(int yieldedBenefit) noexcept {
+            benefit = yieldedBenefit;
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+    };
+
+    Stepper() = default;
+    ~Stepper();
+    Stepper(Stepper&& other) noexcept;
+    Stepper& operator=(Stepper&& other) noexcept;
+    Stepper(const Stepper&) = delete;
+    Stepper& operator=(const Stepper&) = delete;
+
+    /**
+     * @brief Runs the next work unit.
+     *
+     * @return false once the search has finished (then step() does nothing).
+     * @throws Whatever the search threw, once.
+     */
+    bool step();
+
+    /**
+     * @brief Steps until the search finishes.
+     */
+    void finish();
+
+    bool done() const;
+
+    /// Benefit yielded by the last work unit.
+    int benefit() const;
+
+private:
+    explicit Stepper(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+/**
+ * @brief Cooperative scheduler racing steppers on a few threads.
+ *
+ * run() hands out time slices: every stepper first gets a few slices to
+ * measure it, then the slice goes to the stepper with the highest recent
+ * improvement rate (benefit gained per second), except every
+ * EXPLORE_INTERVAL-th slice, which goes to the stepper that waited longest
+ * so a slow starter can still overtake. A stepper never runs on two
+ * threads at once, so the portfolio does not oversubscribe the threads it
+ * is given however many steppers it holds.
+ */
+class Portfolio {
+public:
+    struct Entry {
+        std::string name;
+        int benefit = 0;        ///< Last yielded benefit.
+        long long steps = 0;
+        long long slices = 0;
+        double seconds = 0.0;   ///< Time spent stepping.
+        double rate = 0.0;      ///< Smoothed benefit gain per second.
+        bool paused = false;
+        bool done = false;
+    };
+
+    /**
+     * @brief Adds a stepper; not allowed while run() is executing.
+     *
+     * @return Id for pause() and resume().
+     */
+    size_t add(std::string name, Stepper stepper);
+
+    /// Stops giving slices to a stepper (a slice in progress completes). Thread-safe.
+    void pause(size_t id);
+
+    /// Gives slices to a paused stepper again. Thread-safe.
+    void resume(size_t id);
+
+    /// Makes run() return after the slices in progress once *cancelToken is true (nullptr = never).
+    void setCancelToken(const std::atomic<bool>* cancelToken);
+
+    /**
+     * @brief Steps the portfolio on threads threads until deadline.
+     *
+     * Returns early once every stepper has finished or is paused, or the run is
+     * cancelled; run() may be called again to continue.
+     */
+    void run(unsigned int threads, const std::chrono::steady_clock::time_point& deadline);
+
+    /// Snapshot of every stepper, in the order they were added. Thread-safe.
+    std::vector<Entry> entries() const;
+
+    /// Id of the stepper with the highest benefit, or -1 without steppers.
+    int best() const;
+
+private:
+    // Next stepper to give a slice, or -1; m_mutex must be held.
+    int pickLocked();
+    void worker(const std::chrono::steady_clock::time_point& deadline);
+
+    struct Slot {
+        Entry entry;
+        Stepper stepper;
+        bool running = false;
+        long long lastSlice = -1;  ///< Slice number when it last ran.
+    };
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;  ///< Signalled when a slice ends or a stepper is resumed.
+    std::vector<Slot> m_slots;
+    long long m_slicesHandedOut = 0;
+    const std::atomic<bool>* m_cancelToken = nullptr;
+};
+
+} // namespace STEPPER
+
+#endif // STEPPER_H
@@ -0,0 +1,230 @@
+#include "topology.h"
+
+#include "logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace TOPOLOGY {
+
+namespace {
+
+std::string readLine(const std::filesystem::path& path)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+// CPUs the process may run on (taskset, cgroup cpusets); empty if unknown.
+std::vector<int> allowedCpus()
+{
+    std::vector<int> cpus;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+    }
+#endif
+    return cpus;
+}
+
+// Reservations of all runs of the process: CPU -> pinned workers.
+std::mutex g_reservationMutex;
+std::unordered_map<int, int> g_cpuWorkers;
+
+} // namespace
+
+size_t Topology::cpuCount() const
+{
+    size_t count = 0;
+    for (const Node& node : nodes) count += node.cpus.size();
+    return count;
+}
+
+// =====================================================================================
+// Discovery
+// =====================================================================================
+std::vector<int> parseCpuList(const std::string& list)
+{
+    std::vector<int> cpus;
+    size_t position = 0;
+    while (position < list.size()) {
+        size_t end = list.find(',', position);
+        if (end == std::string::npos) end = list.size();
+        const std::string range = list.substr(position, end - position);
+        position = end + 1;
+        if (range.find_first_not_of(" \t\r\n") == std::string::npos) continue;
+
+        try {
+            const size_t dash = range.find('-');
+            const int first = std::stoi(range.substr(0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            if (first < 0 || last < first) throw std::invalid_argument(range);
+            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+        } catch (const std::exception&) {
+            throw std::invalid_argument("Error: Invalid CPU list '" + list + "'");
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+Topology discover(const std::string& sysRoot)
+{
+    namespace fs = std::filesystem;
+    Topology topology;
+    std::error_code error;
+
+    // NUMA nodes: <sysRoot>/node/node<N>/cpulist
+    const fs::path nodeRoot = fs::path(sysRoot) / "node";
+    for (fs::directory_iterator it(nodeRoot, error), end; !error && it != end; it.increment(error)) {
+        const std::string name = it->path().filename().string();
+        if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+            name.find_first_not_of("0123456789", 4) != std::string::npos) continue;
+        try {
+            Node node;
+            node.id = std::stoi(name.substr(4));
+            node.cpus = parseCpuList(readLine(it->path() / "cpulist"));
+            // Memory-only nodes have no CPUs to run workers on.
+            if (!node.cpus.empty()) topology.nodes.push_back(std::move(node));
+        } catch (const std::exception& e) {
+            LOG_WARNING("[TOPOLOGY] Ignoring " << it->path().string() << ": " << e.what());
+        }
+    }
+    std::sort(topology.nodes.begin(), topology.nodes.end(),
+              [](const Node& a, const Node& b) { return a.id < b.id; });
+    if (!topology.nodes.empty()) return topology;
+
+    // No NUMA information: one node with the online CPUs.
+    Node node;
+    try {
+        node.cpus = parseCpuList(readLine(fs::path(sysRoot) / "cpu" / "online"));
+    } catch (const std::exception&) {
+        node.cpus.clear();
+    }
+    if (node.cpus.empty()) {
+        const int count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        for (int cpu = 0; cpu < count; ++cpu) node.cpus.push_back(cpu);
+    }
+    topology.nodes.push_back(std::move(node));
+    return topology;
+}
+
+const Topology& machine()
+{
+    static const Topology topology = [] {
+        Topology discovered = discover();
+        // Keep the CPUs this process may use; a node left without any is dropped.
+        const std::vector<int> allowed = allowedCpus();
+        if (allowed.empty()) return discovered;
+        Topology usable;
+        for (Node& node : discovered.nodes) {
+            std::erase_if(node.cpus, [&](int cpu) {
+                return !std::binary_search(allowed.begin(), allowed.end(), cpu);
+            });
+            if (!node.cpus.empty()) usable.nodes.push_back(std::move(node));
+        }
+        return usable.nodes.empty() ? discovered : usable;
+    }();
+    return topology;
+}
+
+// =====================================================================================
+// Placement
+// =====================================================================================
+CpuReservation::CpuReservation(const Topology& topology, unsigned int workers)
+{
+    std::lock_guard<std::mutex> lock(g_reservationMutex);
+    m_placements.reserve(workers);
+    size_t nextNode = 0;
+    for (unsigned int worker = 0; worker < workers; ++worker) {
+        // Least used CPU; ties go to the node after the previous worker's.
+        Placement best;
+        int bestWorkers = 0;
+        for (size_t offset = 0; offset < topology.nodes.size(); ++offset) {
+            const size_t index = (nextNode + offset) % topology.nodes.size();
+            const Node& node = topology.nodes[index];
+            for (int cpu : node.cpus) {
+                const int pinned = g_cpuWorkers[cpu];
+                if (best.cpu < 0 || pinned < bestWorkers) {
+                    best = {node.id, cpu};
+                    bestWorkers = pinned;
+                }
+            }
+        }
+        if (best.cpu >= 0) {
+            ++g_cpuWorkers[best.cpu];
+            const auto node = std::find_if(topology.nodes.begin(), topology.nodes.end(),
+                                           [&](const Node& n) { return n.id == best.node; });
+            nextNode = static_cast<size_t>(node - topology.nodes.begin()) + 1;
+        }
+        m_placements.push_back(best);
+    }
+}
+
+CpuReservation::~CpuReservation()
+{
+    std::lock_guard<std::mutex> lock(g_reservationMutex);
+    for (const Placement& placement : m_placements) {
+        if (placement.cpu >= 0 && --g_cpuWorkers[placement.cpu] == 0) g_cpuWorkers.erase(placement.cpu);
+    }
+}
+
+bool pinCurrentThread(int cpu)
+{
+    if (cpu < 0) return false;
+    bool pinned = false;
+#if defined(__linux__)
+    if (cpu < CPU_SETSIZE) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pinned = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+#endif
+    static std::atomic<bool> warned{false};
+    if (!pinned && !warned.exchange(true))
+        LOG_WARNING("[TOPOLOGY] Could not pin a worker to CPU " << cpu << "; workers run unpinned");
+    return pinned;
+}
+
+// =====================================================================================
+// Instance Replicas
+// =====================================================================================
+InstanceReplicas::InstanceReplicas(const std::vector<Package*>& allPackages,
+                                   const DependencyGraph& dependencyGraph, const Topology& topology)
+    : m_allPackages(allPackages), m_dependencyGraph(dependencyGraph)
+{
+    if (topology.nodes.size() < 2) return;
+    for (const Node& node : topology.nodes) m_copies.emplace(node.id, std::make_unique<Copy>());
+}
+
+InstanceReplicas::Replica InstanceReplicas::forNode(int node)
+{
+    auto it = m_copies.find(node);
+    if (it == m_copies.end()) return {&m_allPackages, &m_dependencyGraph};
+
+    // The copying thread runs on the node, so the copy's pages are allocated there.
+    Copy& copy = *it->second;
+    std::call_once(copy.made, [&] {
+        copy.allPackages = m_allPackages;
+        copy.dependencyGraph = m_dependencyGraph;
+    });
+    return {&copy.allPackages, &copy.dependencyGraph};
+}
+
+} // namespace TOPOLOGY
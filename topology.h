@@ -0,0 +1,135 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class Package;
+class Dependency;
+
+/**
+ * @brief CPU/NUMA topology and placement of worker threads.
+ *
+ * Workers pinned to a CPU allocate their state (bags, buffers, search engine)
+ * after pinning, so Linux's first-touch policy places it on the worker's own
+ * node. The read-only instance containers the hot loops walk are copied once
+ * per node by a worker of that node (see InstanceReplicas).
+ */
+namespace TOPOLOGY {
+
+/**
+ * @brief A NUMA node and its online CPUs.
+ */
+struct Node {
+    int id = 0;
+    std::vector<int> cpus;
+};
+
+struct Topology {
+    std::vector<Node> nodes;
+
+    size_t cpuCount() const;
+};
+
+/**
+ * @brief Parses a sysfs CPU list such as "0-3,8,10-11".
+ *
+ * @throws std::invalid_argument if the list is malformed.
+ */
+std::vector<int> parseCpuList(const std::string& list);
+
+/**
+ * @brief Reads the topology from sysRoot (normally /sys/devices/system).
+ *
+ * Without NUMA information (no node directories), all online CPUs form node 0;
+ * without any sysfs information, node 0 holds std::thread::hardware_concurrency() CPUs.
+ */
+Topology discover(const std::string& sysRoot = "/sys/devices/system");
+
+/**
+ * @brief Gets the topology of this machine, discovered on first use.
+ */
+const Topology& machine();
+
+/**
+ * @brief Where a worker runs.
+ */
+struct Placement {
+    int node = 0;
+    int cpu = -1;  ///< -1 when the worker is not pinned.
+};
+
+/**
+ * @brief CPUs reserved for the workers of one run, released on destruction.
+ *
+ * Reservations are process-wide, so concurrent runs (e.g. several executions
+ * sharing the machine) spread over the least used CPUs instead of all pinning
+ * their first worker to CPU 0. Workers are spread round robin over the nodes,
+ * so a run of n workers uses the memory bandwidth of every node.
+ */
+class CpuReservation {
+public:
+    CpuReservation(const Topology& topology, unsigned int workers);
+    ~CpuReservation();
+
+    CpuReservation(const CpuReservation&) = delete;
+    CpuReservation& operator=(const CpuReservation&) = delete;
+
+    const Placement& operator[](size_t worker) const { return m_placements[worker]; }
+    size_t size() const { return m_placements.size(); }
+
+private:
+    std::vector<Placement> m_placements;
+};
+
+/**
+ * @brief Pins the calling thread to cpu.
+ *
+ * @return false where affinity is not supported or was refused.
+ */
+bool pinCurrentThread(int cpu);
+
+/**
+ * @brief Per-node copies of the read-only instance containers.
+ *
+ * Packages and dependencies keep their identity (bags of different workers
+ * are compared and merged by pointer); only the package list and the
+ * dependency graph, which every move evaluation reads, are copied.
+ */
+class InstanceReplicas {
+public:
+    using DependencyGraph = std::unordered_map<const Package*, std::vector<const Dependency*>>;
+
+    struct Replica {
+        const std::vector<Package*>* allPackages;
+        const DependencyGraph* dependencyGraph;
+    };
+
+    InstanceReplicas(const std::vector<Package*>& allPackages, const DependencyGraph& dependencyGraph,
+                     const Topology& topology);
+
+    /**
+     * @brief Gets the copy of node, made by the first caller running on it.
+     *
+     * On a single-node machine this is the original data.
+     */
+    Replica forNode(int node);
+
+private:
+    struct Copy {
+        std::once_flag made;
+        std::vector<Package*> allPackages;
+        DependencyGraph dependencyGraph;
+    };
+
+    const std::vector<Package*>& m_allPackages;
+    const DependencyGraph& m_dependencyGraph;
+    std::unordered_map<int, std::unique_ptr<Copy>> m_copies;  ///< Node id -> copy (multi-node only).
+};
+
+} // namespace TOPOLOGY
+
+#endif // TOPOLOGY_H
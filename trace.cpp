@@ -0,0 +1,195 @@
+#include "trace.h"
+
+#include "logger.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace TRACE {
+
+// A runaway trace stops growing here instead of exhausting memory (~40 MB per thread).
+static constexpr size_t MAX_EVENTS_PER_THREAD = 1u << 20;
+
+namespace {
+
+struct Event {
+    const char* category;
+    const char* name;
+    SEARCH_ENGINE::MovementType movement;
+    long long startMicros;
+    long long durationMicros;
+};
+
+struct ThreadBuffer {
+    int tid = 0;
+    unsigned int generation = 0;
+    const char* name = nullptr;
+    std::vector<Event> events;
+    size_t dropped = 0;
+};
+
+// =====================================================================================
+// Registry
+// =====================================================================================
+struct Registry {
+    std::mutex mutex;
+    std::atomic<std::chrono::steady_clock::rep> epoch{0};  ///< Ticks of the last start().
+    std::atomic<unsigned int> generation{0};              ///< Bumped by start(); stale buffers clear themselves.
+    int nextTid = 1;
+    std::vector<ThreadBuffer*> live;                      ///< Buffers of running threads.
+    std::vector<std::unique_ptr<ThreadBuffer>> retired;   ///< Buffers of threads that exited.
+};
+
+Registry& registry()
+{
+    static Registry instance;
+    return instance;
+}
+
+/**
+ * @brief Owns the calling thread's buffer; hands it to the registry when the thread exits.
+ */
+struct ThreadHandle {
+    std::unique_ptr<ThreadBuffer> buffer;
+
+    ThreadBuffer& get() {
+        Registry& r = registry();
+        const unsigned int generation = r.generation.load(std::memory_order_relaxed);
+        if (!buffer) {
+            buffer = std::make_unique<ThreadBuffer>();
+            buffer->generation = generation;
+            std::lock_guard<std::mutex> lock(r.mutex);
+            buffer->tid = r.nextTid++;
+            r.live.push_back(buffer.get());
+        } else if (buffer->generation != generation) {
+            std::lock_guard<std::mutex> lock(r.mutex);
+            buffer->events.clear();
+            buffer->dropped = 0;
+            buffer->generation = generation;
+        }
+        return *buffer;
+    }
+
+    ~ThreadHandle() {
+        if (!buffer) return;
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.live.erase(std::remove(r.live.begin(), r.live.end(), buffer.get()), r.live.end());
+        if (buffer->generation == r.generation.load() && !buffer->events.empty())
+            r.retired.push_back(std::move(buffer));
+    }
+};
+
+thread_local ThreadHandle t_handle;
+
+void writeEscaped(std::ostream& out, const char* text)
+{
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') out << '\\';
+        out << *c;
+    }
+}
+
+} // namespace
+
+// =====================================================================================
+// Recording
+// =====================================================================================
+void start()
+{
+    Registry& r = registry();
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.generation.fetch_add(1);
+        r.retired.clear();
+        r.epoch.store(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+    g_enabled.store(true, std::memory_order_relaxed);
+}
+
+void stop()
+{
+    g_enabled.store(false, std::memory_order_relaxed);
+}
+
+void setThreadName(const char* name)
+{
+    if (isEnabled()) t_handle.get().name = name;
+}
+
+void ScopedEvent::record()
+{
+    ThreadBuffer& buffer = t_handle.get();
+    if (buffer.events.size() >= MAX_EVENTS_PER_THREAD) {
+        ++buffer.dropped;
+        return;
+    }
+    const std::chrono::steady_clock::time_point epoch(
+        std::chrono::steady_clock::duration(registry().epoch.load(std::memory_order_relaxed)));
+    const auto end = std::chrono::steady_clock::now();
+    buffer.events.push_back({m_category, m_name, m_movement,
+                             std::chrono::duration_cast<std::chrono::microseconds>(m_start - epoch).count(),
+                             std::chrono::duration_cast<std::chrono::microseconds>(end - m_start).count()});
+}
+
+// =====================================================================================
+// Export
+// =====================================================================================
+size_t writeChromeJson(const std::string& filename)
+{
+    std::ofstream out(filename);
+    if (!out.is_open())
+        throw std::runtime_error("Error: Could not open trace file " + filename);
+
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+
+    std::vector<const ThreadBuffer*> buffers;
+    for (const auto& buffer : r.retired) buffers.push_back(buffer.get());
+    for (const ThreadBuffer* buffer : r.live) {
+        if (buffer->generation == r.generation.load()) buffers.push_back(buffer);
+    }
+
+    size_t written = 0;
+    size_t dropped = 0;
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) out << ",\n";
+        first = false;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (const ThreadBuffer* buffer : buffers) {
+        dropped += buffer->dropped;
+        if (buffer->events.empty()) continue;
+
+        separator();
+        out << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->tid << ",\"args\":{\"name\":\"";
+        if (buffer->name) writeEscaped(out, buffer->name);
+        else out << "thread " << buffer->tid;
+        out << "\"}}";
+
+        for (const Event& event : buffer->events) {
+            separator();
+            out << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"ts\":" << event.startMicros << ",\"dur\":" << event.durationMicros << ",\"cat\":\"";
+            writeEscaped(out, event.category);
+            out << "\",\"name\":\"";
+            writeEscaped(out, event.name);
+            out << "\"";
+            if (event.movement != SEARCH_ENGINE::MovementType::NONE)
+                out << ",\"args\":{\"movement\":\"" << SEARCH_ENGINE::toString(event.movement) << "\"}";
+            out << "}";
+            ++written;
+        }
+    }
+    out << "\n]}\n";
+
+    if (dropped > 0) LOG_WARNING("[TRACE] " << dropped << " events dropped (per-thread limit reached)");
+    return written;
+}
+
+} // namespace TRACE
@@ -0,0 +1,102 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+
+#include "search_engine.h"
+
+/**
+ * @brief Timeline recording of solver threads, exported as Chrome trace-event JSON.
+ *
+ * ScopedEvent marks a span (a stage of Algorithm::run, a construction, a local
+ * search iteration, a repair, a shake, a best-bag synchronization). Spans are
+ * appended to a buffer owned by the recording thread, so recording takes no
+ * lock; a thread's buffer is handed to the global list when the thread exits.
+ * The JSON opens in chrome://tracing or https://ui.perfetto.dev, one track per
+ * thread, which makes idle gaps, waits on shared mutexes and the sequential
+ * stages visible.
+ *
+ * Recording is off by default: a ScopedEvent then costs one relaxed atomic load.
+ */
+namespace TRACE {
+
+/**
+ * @brief Clears previous events and starts recording; timestamps count from this call.
+ */
+void start();
+
+/**
+ * @brief Stops recording; recorded events are kept until the next start().
+ */
+void stop();
+
+inline std::atomic<bool> g_enabled{false};
+
+inline bool isEnabled()
+{
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Writes the recorded events as Chrome trace-event JSON.
+ *
+ * Call after the traced solve has returned: buffers of threads that are still
+ * alive are read without synchronization.
+ *
+ * @return The number of events written.
+ * @throws std::runtime_error if the file cannot be written.
+ */
+size_t writeChromeJson(const std::string& filename);
+
+/**
+ * @brief Names the calling thread's track in the exported timeline.
+ */
+void setThreadName(const char* name);
+
+/**
+ * @brief Records one complete span from construction to destruction.
+ *
+ * category and name must be string literals (they are stored as pointers).
+ */
+class ScopedEvent {
+public:
+    ScopedEvent(const char* category, const char* name,
+                SEARCH_ENGINE::MovementType movement = SEARCH_ENGINE::MovementType::NONE)
+        : m_category(category), m_name(name), m_movement(movement), m_active(isEnabled())
+    {
+        if (m_active) m_start = std::chrono::steady_clock::now();
+    }
+
+    ~ScopedEvent() {
+        if (m_active) record();
+    }
+
+    ScopedEvent(const ScopedEvent&) = delete;
+    ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+private:
+    void record();
+
+    const char* m_category;
+    const char* m_name;
+    SEARCH_ENGINE::MovementType m_movement;
+    bool m_active;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief Locks a mutex, recording the time spent waiting for it as a "lock" span.
+ */
+template <typename Mutex>
+std::unique_lock<Mutex> lock(Mutex& mutex, const char* name)
+{
+    ScopedEvent wait("lock", name);
+    return std::unique_lock<Mutex>(mutex);
+}
+
+} // namespace TRACE
+
+#endif // TRACE_H
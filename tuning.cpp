@@ -0,0 +1,426 @@
+#include "tuning.h"
+
+#include "data_model.h"
+#include "file_processor.h"
+#include "grasp.h"
+#include "grasp_vns.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace TUNING {
+
+// =====================================================================================
+// Tuning Constants
+// =====================================================================================
+static constexpr int MIN_ROUNDS_BEFORE_ELIMINATION = 3;  // tasks every configuration sees before a cut
+static constexpr int MAX_ROUNDS_PER_RACE = 10;
+static constexpr double RACE_MARGIN = 0.10;              // eliminate below best mean - RACE_MARGIN / sqrt(rounds)
+static constexpr int ELITE_COUNT = 3;                    // configurations carried into the next race
+static constexpr double INITIAL_SPREAD = 0.25;           // perturbation of the elites, in unit coordinates
+static constexpr double SPREAD_DECAY = 0.6;              // spread shrinks by this factor per race
+static constexpr int EVALUATION_MAX_ITERATIONS = 1000000; // the evaluation deadline binds, not the iteration cap
+
+static constexpr SEARCH_ENGINE::MovementType TRAINING_MOVES[] = {
+    SEARCH_ENGINE::MovementType::ADD,
+    SEARCH_ENGINE::MovementType::SWAP_REMOVE_1_ADD_1,
+    SEARCH_ENGINE::MovementType::SWAP_REMOVE_1_ADD_2,
+    SEARCH_ENGINE::MovementType::SWAP_REMOVE_2_ADD_1,
+    SEARCH_ENGINE::MovementType::EJECTION_CHAIN
+};
+
+// =====================================================================================
+// Parameters
+// =====================================================================================
+int Parameters::rclSize(size_t packageCount) const
+{
+    // The epsilon keeps exact fractions (the default third) from rounding down.
+    return std::max(1, static_cast<int>(packageCount * rclFraction + 1e-9));
+}
+
+std::string Parameters::toString() const
+{
+    std::ostringstream oss;
+    oss << "RCL fraction: " << rclFraction
+        << " | Alpha: " << alpha
+        << " | VNS frequency: " << vnsFrequency
+        << " | LS patience: " << lsIterationsWithoutImprovement
+        << " | LS max iterations: " << lsMaxIterations
+        << " | Fill threshold: " << fillThreshold;
+    return oss.str();
+}
+
+namespace {
+
+std::string trim(const std::string& text)
+{
+    const size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return "";
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+void validate(const Parameters& p)
+{
+    if (!(p.rclFraction > 0.0 && p.rclFraction <= 1.0))
+        throw std::runtime_error("Error: rcl_fraction must be in (0, 1]");
+    if (p.alpha > 1.0)
+        throw std::runtime_error("Error: alpha must be at most 1 (negative = randomized)");
+    if (p.vnsFrequency < 1)
+        throw std::runtime_error("Error: vns_frequency must be at least 1");
+    if (p.lsIterationsWithoutImprovement < 1 || p.lsMaxIterations < 1)
+        throw std::runtime_error("Error: local search limits must be at least 1");
+    if (!(p.fillThreshold > 0.0 && p.fillThreshold <= 1.0))
+        throw std::runtime_error("Error: fill_threshold must be in (0, 1]");
+}
+
+// -------------------------------------------------------------------------------------
+// Search space: every parameter maps to a unit coordinate, so sampling and
+// perturbation treat all dimensions alike. Wide ranges use a log scale.
+// -------------------------------------------------------------------------------------
+constexpr int DIMENSIONS = 6;
+using Point = std::array<double, DIMENSIONS>;
+
+constexpr double RCL_MIN = 0.02, RCL_MAX = 0.6;
+constexpr double ALPHA_RANDOMIZED_SHARE = 0.2;  // unit coordinates below this mean "randomized alpha"
+constexpr double VNS_FREQUENCY_MAX = 8.0;
+constexpr double PATIENCE_MIN = 20.0, PATIENCE_MAX = 1000.0;
+constexpr double LS_MAX_MIN = 200.0, LS_MAX_MAX = 20000.0;
+constexpr double FILL_MIN = 0.80, FILL_MAX = 1.0;
+
+double toLogUnit(double value, double low, double high)
+{
+    return std::clamp(std::log(value / low) / std::log(high / low), 0.0, 1.0);
+}
+
+double fromLogUnit(double unit, double low, double high)
+{
+    return low * std::pow(high / low, unit);
+}
+
+Point encode(const Parameters& p)
+{
+    return {
+        toLogUnit(p.rclFraction, RCL_MIN, RCL_MAX),
+        p.alpha < 0.0 ? ALPHA_RANDOMIZED_SHARE / 2 : ALPHA_RANDOMIZED_SHARE + (1.0 - ALPHA_RANDOMIZED_SHARE) * p.alpha,
+        std::clamp((p.vnsFrequency - 1.0) / (VNS_FREQUENCY_MAX - 1.0), 0.0, 1.0),
+        toLogUnit(p.lsIterationsWithoutImprovement, PATIENCE_MIN, PATIENCE_MAX),
+        toLogUnit(p.lsMaxIterations, LS_MAX_MIN, LS_MAX_MAX),
+        std::clamp((p.fillThreshold - FILL_MIN) / (FILL_MAX - FILL_MIN), 0.0, 1.0)
+    };
+}
+
+Parameters decode(const Point& x)
+{
+    Parameters p;
+    p.rclFraction = fromLogUnit(x[0], RCL_MIN, RCL_MAX);
+    p.alpha = x[1] < ALPHA_RANDOMIZED_SHARE ? -1.0 : (x[1] - ALPHA_RANDOMIZED_SHARE) / (1.0 - ALPHA_RANDOMIZED_SHARE);
+    p.vnsFrequency = 1 + static_cast<int>(std::lround(x[2] * (VNS_FREQUENCY_MAX - 1.0)));
+    p.lsIterationsWithoutImprovement = static_cast<int>(std::lround(fromLogUnit(x[3], PATIENCE_MIN, PATIENCE_MAX)));
+    p.lsMaxIterations = static_cast<int>(std::lround(fromLogUnit(x[4], LS_MAX_MIN, LS_MAX_MAX)));
+    p.fillThreshold = FILL_MIN + x[5] * (FILL_MAX - FILL_MIN);
+    return p;
+}
+
+Parameters sampleUniform(std::mt19937& rng)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    Point x;
+    for (double& coordinate : x) coordinate = unit(rng);
+    return decode(x);
+}
+
+Parameters perturb(const Parameters& elite, double spread, std::mt19937& rng)
+{
+    std::normal_distribution<double> noise(0.0, spread);
+    Point x = encode(elite);
+    for (double& coordinate : x) coordinate = std::clamp(coordinate + noise(rng), 0.0, 1.0);
+    return decode(x);
+}
+
+// =====================================================================================
+// Training Set
+// =====================================================================================
+struct TrainingInstance {
+    std::string name;
+    ProblemInstance problem;
+    std::unordered_map<const Package*, std::vector<const Dependency*>> dependencyGraph;
+};
+
+std::vector<std::unique_ptr<TrainingInstance>> loadTrainingSet(const std::string& directory)
+{
+    std::vector<fs::path> files;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == ".txt") files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<std::unique_ptr<TrainingInstance>> instances;
+    for (const fs::path& file : files) {
+        auto instance = std::make_unique<TrainingInstance>();
+        instance->name = file.filename().string();
+        try {
+            instance->problem = FILE_PROCESSOR::loadProblem(file.string());
+        } catch (const std::exception& e) {
+            LOG_WARNING("[TUNING] Skipping " << instance->name << ": " << e.what());
+            continue;
+        }
+        for (const Package* package : instance->problem.packages) {
+            std::vector<const Dependency*>& dependencies = instance->dependencyGraph[package];
+            for (const auto& pair : package->getDependencies()) dependencies.push_back(pair.second);
+            package->getDependenciesSize(); // fill the lazy cache before evaluations read it concurrently
+        }
+        instances.push_back(std::move(instance));
+    }
+    if (instances.empty()) throw std::runtime_error("Error: No training instances (*.txt) in " + directory);
+    return instances;
+}
+
+struct Task {
+    const TrainingInstance* instance;
+    SEARCH_ENGINE::MovementType movement;
+    unsigned int seed;
+};
+
+/**
+ * @brief Runs GRASP then GRASP_VNS with the parameters; returns the sum of their benefits.
+ */
+long long evaluate(const Parameters& p, const Task& task, double evaluationTime)
+{
+    const ProblemInstance& problem = task.instance->problem;
+    const int rclSize = p.rclSize(problem.packages.size());
+
+    GRASP grasp(evaluationTime / 2, task.seed, rclSize, p.alpha);
+    grasp.setNumThreads(1);
+    grasp.setLocalSearchIterations(p.lsMaxIterations);
+    grasp.setFillThreshold(p.fillThreshold);
+    auto graspBag = grasp.run(problem.maxCapacity, problem.packages, task.movement, task.instance->dependencyGraph,
+                              p.lsIterationsWithoutImprovement, EVALUATION_MAX_ITERATIONS);
+
+    GRASP_VNS graspVNS(evaluationTime / 2, task.seed, rclSize, p.alpha);
+    graspVNS.setNumThreads(1);
+    graspVNS.setLocalSearchIterations(p.lsMaxIterations);
+    graspVNS.setVnsFrequency(p.vnsFrequency);
+    auto graspVNSBag = graspVNS.run(problem.maxCapacity, problem.packages, task.movement, task.instance->dependencyGraph,
+                                    p.lsIterationsWithoutImprovement, EVALUATION_MAX_ITERATIONS);
+
+    return static_cast<long long>(graspBag->getBenefit()) + graspVNSBag->getBenefit();
+}
+
+// =====================================================================================
+// Race
+// =====================================================================================
+struct Candidate {
+    Parameters parameters;
+    double scoreSum = 0.0;
+    int rounds = 0;
+    bool alive = true;
+
+    double mean() const { return rounds > 0 ? scoreSum / rounds : 0.0; }
+};
+
+/**
+ * @brief Evaluates every live candidate on one task, spreading the evaluations over threads.
+ */
+void runRound(std::vector<Candidate>& candidates, const Task& task, const Options& options,
+              unsigned int threads, long long& evaluations)
+{
+    std::vector<size_t> alive;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        if (candidates[i].alive) alive.push_back(i);
+    }
+    std::vector<long long> benefits(alive.size(), 0);
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i; (i = next.fetch_add(1)) < alive.size();) {
+            try {
+                benefits[i] = evaluate(candidates[alive[i]].parameters, task, options.evaluationTime);
+            } catch (const std::exception& e) {
+                LOG_WARNING("[TUNING] Evaluation failed: " << e.what());
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    const size_t helpers = std::min<size_t>(threads, alive.size()) - 1;
+    for (size_t t = 0; t < helpers; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+    evaluations += static_cast<long long>(alive.size());
+
+    const long long best = *std::max_element(benefits.begin(), benefits.end());
+    for (size_t i = 0; i < alive.size(); ++i) {
+        Candidate& candidate = candidates[alive[i]];
+        candidate.scoreSum += best > 0 ? static_cast<double>(benefits[i]) / best : 1.0;
+        ++candidate.rounds;
+    }
+}
+
+/**
+ * @brief Eliminates candidates whose mean falls behind the leader by more than the shrinking margin.
+ */
+void eliminate(std::vector<Candidate>& candidates, int rounds)
+{
+    if (rounds < MIN_ROUNDS_BEFORE_ELIMINATION) return;
+    double bestMean = 0.0;
+    for (const Candidate& c : candidates) {
+        if (c.alive) bestMean = std::max(bestMean, c.mean());
+    }
+    const double cutoff = bestMean - RACE_MARGIN / std::sqrt(static_cast<double>(rounds));
+    for (Candidate& c : candidates) {
+        if (c.alive && c.mean() < cutoff) c.alive = false;
+    }
+}
+
+} // namespace
+
+// =====================================================================================
+// Parameter File
+// =====================================================================================
+Parameters loadParameters(const std::string& filename)
+{
+    std::ifstream in(filename);
+    if (!in.is_open()) throw std::runtime_error("Error: Could not open parameter file " + filename);
+
+    Parameters p;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) continue;
+
+        const size_t equals = line.find('=');
+        const std::string where = filename + ":" + std::to_string(lineNumber);
+        if (equals == std::string::npos) throw std::runtime_error("Error: Expected key = value at " + where);
+        const std::string key = trim(line.substr(0, equals));
+        const std::string value = trim(line.substr(equals + 1));
+        try {
+            if (key == "rcl_fraction") p.rclFraction = std::stod(value);
+            else if (key == "alpha") p.alpha = std::stod(value);
+            else if (key == "vns_frequency") p.vnsFrequency = std::stoi(value);
+            else if (key == "ls_iterations_without_improvement") p.lsIterationsWithoutImprovement = std::stoi(value);
+            else if (key == "ls_max_iterations") p.lsMaxIterations = std::stoi(value);
+            else if (key == "fill_threshold") p.fillThreshold = std::stod(value);
+            else throw std::runtime_error("Error: Unknown parameter '" + key + "' at " + where);
+        } catch (const std::invalid_argument&) {
+            throw std::runtime_error("Error: Invalid value '" + value + "' at " + where);
+        } catch (const std::out_of_range&) {
+            throw std::runtime_error("Error: Invalid value '" + value + "' at " + where);
+        }
+    }
+    validate(p);
+    return p;
+}
+
+void saveParameters(const std::string& filename, const Parameters& p, const std::string& comment)
+{
+    std::ofstream out(filename);
+    if (!out.is_open()) throw std::runtime_error("Error: Could not open parameter file " + filename);
+
+    out << "# Tuned search parameters (KnapsackProblem --tune)\n";
+    if (!comment.empty()) out << "# " << comment << "\n";
+    out << std::setprecision(6)
+        << "rcl_fraction = " << p.rclFraction << "\n"
+        << "alpha = " << p.alpha << "\n"
+        << "vns_frequency = " << p.vnsFrequency << "\n"
+        << "ls_iterations_without_improvement = " << p.lsIterationsWithoutImprovement << "\n"
+        << "ls_max_iterations = " << p.lsMaxIterations << "\n"
+        << "fill_threshold = " << p.fillThreshold << "\n";
+}
+
+// =====================================================================================
+// Tuner
+// =====================================================================================
+Result tune(const Options& options, std::ostream& log)
+{
+    const auto instances = loadTrainingSet(options.instanceDir);
+    std::mt19937 rng(options.seed);
+
+    std::vector<Task> tasks;
+    for (const auto& instance : instances) {
+        for (SEARCH_ENGINE::MovementType movement : TRAINING_MOVES)
+            tasks.push_back({instance.get(), movement, static_cast<unsigned int>(rng())});
+    }
+    std::shuffle(tasks.begin(), tasks.end(), rng);
+
+    unsigned int threads = options.threads;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    const int populationSize = std::max(2, options.candidates);
+
+    // The first race pits the built-in values against uniform samples.
+    std::vector<Candidate> candidates;
+    candidates.push_back({Parameters()});
+    while (static_cast<int>(candidates.size()) < populationSize) candidates.push_back({sampleUniform(rng)});
+
+    Result result;
+    size_t nextTask = 0;
+    double spread = INITIAL_SPREAD;
+    for (int race = 0; race < std::max(1, options.races); ++race) {
+        int rounds = 0;
+        int survivors = populationSize;
+        while (rounds < MAX_ROUNDS_PER_RACE && survivors > 1) {
+            runRound(candidates, tasks[nextTask++ % tasks.size()], options, threads, result.evaluations);
+            eliminate(candidates, ++rounds);
+            survivors = static_cast<int>(std::count_if(candidates.begin(), candidates.end(),
+                                                       [](const Candidate& c) { return c.alive; }));
+        }
+
+        std::vector<Candidate> ranked;
+        for (const Candidate& c : candidates) {
+            if (c.alive) ranked.push_back(c);
+        }
+        std::sort(ranked.begin(), ranked.end(),
+                  [](const Candidate& a, const Candidate& b) { return a.mean() > b.mean(); });
+        result.best = ranked.front().parameters;
+        result.score = ranked.front().mean();
+        log << "Race " << (race + 1) << ": " << rounds << " rounds, " << survivors << " survivors, best score "
+            << std::fixed << std::setprecision(4) << result.score << std::defaultfloat
+            << " (" << result.best.toString() << ")\n";
+
+        // Next race: the elites plus samples around them, better elites drawn more often.
+        candidates.clear();
+        const size_t elites = std::min<size_t>(ELITE_COUNT, ranked.size());
+        for (size_t i = 0; i < elites; ++i) candidates.push_back({ranked[i].parameters});
+        std::vector<double> weights;
+        for (size_t i = 0; i < elites; ++i) weights.push_back(static_cast<double>(elites - i));
+        std::discrete_distribution<size_t> elite(weights.begin(), weights.end());
+        while (static_cast<int>(candidates.size()) < populationSize)
+            candidates.push_back({perturb(ranked[elite(rng)].parameters, spread, rng)});
+        spread *= SPREAD_DECAY;
+    }
+    return result;
+}
+
+int runTuning(const Options& options, std::ostream& out)
+{
+    try {
+        const Result result = tune(options, out);
+        std::ostringstream comment;
+        comment << "Score " << std::fixed << std::setprecision(4) << result.score << " after "
+                << result.evaluations << " evaluations of " << std::defaultfloat << options.evaluationTime << " s on " << options.instanceDir;
+        saveParameters(options.outputFile, result.best, comment.str());
+        out << "Tuned parameters written to " << options.outputFile << "\n";
+        return 0;
+    } catch (const std::exception& e) {
+        out << e.what() << "\n";
+        return 2;
+    }
+}
+
+} // namespace TUNING
@@ -0,0 +1,93 @@
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <iosfwd>
+#include <string>
+
+/**
+ * @brief Offline tuning of the hand-picked search parameters on a training set.
+ *
+ * The tuner runs an iterated race over the parameter space:
+ *  - a race evaluates a population of configurations on training tasks
+ *    (instance, movement, seed) one round at a time, every configuration of a
+ *    round in parallel and with the same seed (common random numbers);
+ *  - a configuration's score on a task is its benefit divided by the best
+ *    benefit of the round, and configurations whose mean score falls clearly
+ *    behind the leader are eliminated, so the budget goes to the contenders;
+ *  - the next race keeps the elites and samples new configurations around
+ *    them with a shrinking spread.
+ * An evaluation runs GRASP and GRASP_VNS (the metaheuristics these parameters
+ * steer) for a fixed time on one thread, so a higher score is more quality
+ * per second of search. The winner is written to a parameter file that
+ * Algorithm::setTunedParameters loads.
+ */
+namespace TUNING {
+
+/**
+ * @brief Search parameters; the defaults are the built-in values.
+ */
+struct Parameters {
+    double rclFraction = 1.0 / 3.0;            ///< GRASP RCL size as a fraction of the package count.
+    double alpha = -1.0;                       ///< GRASP alpha (0 = greedy, 1 = random, < 0 = drawn per construction).
+    int vnsFrequency = 2;                      ///< GRASP_VNS runs VNS every N iterations.
+    int lsIterationsWithoutImprovement = 200;  ///< Local search patience.
+    int lsMaxIterations = 2000;                ///< Move evaluations per local search step.
+    double fillThreshold = 0.95;               ///< GRASP skips local search on bags filled above this share.
+
+    /**
+     * @brief Gets the RCL size for an instance with packageCount packages.
+     */
+    int rclSize(size_t packageCount) const;
+
+    std::string toString() const;
+};
+
+/// File name of the tuned parameters, next to the executable.
+inline constexpr const char* DEFAULT_PARAMETERS_FILE = "tuned_parameters.cfg";
+
+/**
+ * @brief Loads "key = value" lines; missing keys keep their defaults, '#' starts a comment.
+ *
+ * @throws std::runtime_error if the file cannot be read, or a key or value is invalid.
+ */
+Parameters loadParameters(const std::string& filename);
+
+/**
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void saveParameters(const std::string& filename, const Parameters& parameters, const std::string& comment = "");
+
+struct Options {
+    std::string instanceDir = "input";    ///< Training set: every *.txt instance of the directory.
+    std::string outputFile = DEFAULT_PARAMETERS_FILE;
+    double evaluationTime = 0.4;          ///< Seconds of search per evaluation (GRASP + GRASP_VNS).
+    int candidates = 24;                  ///< Configurations per race.
+    int races = 3;
+    unsigned int seed = 75;
+    unsigned int threads = 0;             ///< Parallel evaluations (0 = hardware concurrency).
+};
+
+struct Result {
+    Parameters best;
+    double score = 0.0;        ///< Mean normalized score of the best configuration in the last race.
+    long long evaluations = 0;
+};
+
+/**
+ * @brief Races configurations on the training set and returns the best one.
+ *
+ * @param log Receives one summary line per race.
+ * @throws std::runtime_error if no instance can be loaded.
+ */
+Result tune(const Options& options, std::ostream& log);
+
+/**
+ * @brief Runs tune() and writes the winner to options.outputFile.
+ *
+ * @return 0 on success, 2 on an error.
+ */
+int runTuning(const Options& options, std::ostream& out);
+
+} // namespace TUNING
+
+#endif // TUNING_H
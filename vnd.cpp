@@ -3,12 +3,59 @@
 #include "package.h"
 #include "dependency.h"
 #include "solution_repair.h"
+#include "progress_channel.h"
+#include "perf_counters.h"
 #include <chrono>
 #include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <thread>
+
+static const std::vector<SEARCH_ENGINE::MovementType>& vndMovements()
+{
+    static const std::vector<SEARCH_ENGINE::MovementType> movements = {
+        SEARCH_ENGINE::MovementType::ADD,
+        SEARCH_ENGINE::MovementType::SWAP_REMOVE_1_ADD_1,
+        SEARCH_ENGINE::MovementType::SWAP_REMOVE_1_ADD_2,
+        SEARCH_ENGINE::MovementType::SWAP_REMOVE_2_ADD_1,
+        SEARCH_ENGINE::MovementType::EJECTION_CHAIN
+    };
+    return movements;
+}
+
+static unsigned int workerCount(size_t jobs, unsigned int maxThreads)
+{
+    unsigned int hw = std::thread::hardware_concurrency();
+    unsigned int threads = hw == 0 ? 1u : hw;
+    if (maxThreads > 0) threads = std::min(threads, maxThreads);
+    return std::max(1u, std::min<unsigned int>(threads, static_cast<unsigned int>(jobs)));
+}
 
 VND::VND(double maxTime, unsigned int seed)
     : m_maxTime(maxTime), m_searchEngine(seed) {}
 
+SearchEngine& VND::getSearchEngine()
+{
+    return m_searchEngine;
+}
+
+void VND::setLocalSearchLimits(int maxLS_IterationsWithoutImprovement, int maxLS_Iterations)
+{
+    m_maxLS_IterationsWithoutImprovement = maxLS_IterationsWithoutImprovement;
+    m_maxLS_Iterations = maxLS_Iterations;
+}
+
+void VND::setMaxThreads(unsigned int maxThreads)
+{
+    m_maxThreads = maxThreads;
+}
+
+std::chrono::steady_clock::time_point VND::makeDeadline(const std::chrono::steady_clock::time_point& start) const
+{
+    return start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(m_maxTime));
+}
+
 std::unique_ptr<Bag> VND::run(int bagSize, const Bag* initialBag,
                               const std::vector<Package*>& allPackages,
                               const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph)
@@ -17,58 +64,313 @@ std::unique_ptr<Bag> VND::run(int bagSize, const Bag* initialBag,
         return std::make_unique<Bag>(ALGORITHM::ALGORITHM_TYPE::NONE, "0");
     }
 
-    std::vector<SEARCH_ENGINE::MovementType> movements = {
-        SEARCH_ENGINE::MovementType::ADD,
-        SEARCH_ENGINE::MovementType::SWAP_REMOVE_1_ADD_1,
-        SEARCH_ENGINE::MovementType::SWAP_REMOVE_1_ADD_2,
-        SEARCH_ENGINE::MovementType::SWAP_REMOVE_2_ADD_1,
-        SEARCH_ENGINE::MovementType::EJECTION_CHAIN
-    };
+    const int k_max = static_cast<int>(vndMovements().size());
 
-    const int k_max = static_cast<int>(movements.size());
-    ALGORITHM::LOCAL_SEARCH localSearchMethod = ALGORITHM::LOCAL_SEARCH::BEST_IMPROVEMENT;
+    PERF_COUNTERS::ScopedContext perfContext(PERF_COUNTERS::currentProfile(), ALGORITHM::ALGORITHM_TYPE::VND);
+    PERF_COUNTERS::ScopedSample perfSample(SEARCH_ENGINE::MovementType::NONE);
 
     auto bestBag = std::make_unique<Bag>(*initialBag);
     bestBag->setMetaheuristicParameters("k_max=" + std::to_string(k_max));
 
     auto start_time = std::chrono::steady_clock::now();
-    auto deadline = start_time +
-        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
-            std::chrono::duration<double>(m_maxTime)
-    );
+    descend(*bestBag, bagSize, allPackages, dependencyGraph, m_searchEngine, makeDeadline(start_time));
+
+    auto end_time = std::chrono::steady_clock::now();
+    bestBag->setAlgorithmTime(std::chrono::duration<double>(end_time - start_time).count());
+    bestBag->setBagAlgorithm(ALGORITHM::ALGORITHM_TYPE::VND);
+
+    return bestBag;
+}
+
+// =====================================================================================
+// Sequential descent (shared by run and runMultiStart)
+// =====================================================================================
+void VND::descend(Bag& bestBag, int bagSize,
+                  const std::vector<Package*>& allPackages,
+                  const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+                  SearchEngine& searchEngine,
+                  const std::chrono::steady_clock::time_point& deadline)
+{
+    descendSteps(bestBag, bagSize, allPackages, dependencyGraph, searchEngine, deadline).finish();
+}
+
+STEPPER::Stepper VND::steps(Bag& bag, int bagSize,
+                            const std::vector<Package*>& allPackages,
+                            const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+                            std::chrono::steady_clock::time_point deadline)
+{
+    bag.setMetaheuristicParameters("k_max=" + std::to_string(vndMovements().size()));
+    bag.setBagAlgorithm(ALGORITHM::ALGORITHM_TYPE::VND);
+    auto descent = descendSteps(bag, bagSize, allPackages, dependencyGraph, m_searchEngine, deadline);
+    while (descent.step()) co_yield descent.benefit();
+}
+
+STEPPER::Stepper VND::descendSteps(Bag& bestBag, int bagSize,
+                                   const std::vector<Package*>& allPackages,
+                                   const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+                                   SearchEngine& searchEngine,
+                                   std::chrono::steady_clock::time_point deadline)
+{
+    const auto& movements = vndMovements();
+    const int k_max = static_cast<int>(movements.size());
+    ALGORITHM::LOCAL_SEARCH localSearchMethod = ALGORITHM::LOCAL_SEARCH::BEST_IMPROVEMENT;
 
     int k = 0;
     while (k < k_max) {
         if (std::chrono::steady_clock::now() > deadline) break;
 
         // --- Sequential neighborhood evaluation ---
-        auto candidateBag = std::make_unique<Bag>(*bestBag);
-        m_searchEngine.localSearch(
+        auto candidateBag = std::make_unique<Bag>(bestBag);
+        auto search = searchEngine.localSearchSteps(
             *candidateBag,
             bagSize,
             allPackages,
             movements[k],
             localSearchMethod,
             dependencyGraph,
-            200,
-            2000,
+            m_maxLS_IterationsWithoutImprovement,
+            m_maxLS_Iterations,
             deadline
         );
+        while (search.step()) co_yield bestBag.getBenefit();
 
         candidateBag->setMovementType(movements[k]);
-        SOLUTION_REPAIR::repair(*candidateBag, bagSize, dependencyGraph, m_searchEngine.getSeed());
+        SOLUTION_REPAIR::repair(*candidateBag, bagSize, dependencyGraph, searchEngine.getSeed());
 
-        if (candidateBag->getBenefit() > bestBag->getBenefit()) {
-            bestBag = std::move(candidateBag);
+        if (candidateBag->getBenefit() > bestBag.getBenefit()) {
+            bestBag = std::move(*candidateBag);
             k = 0; // restart from first neighborhood
         } else {
             ++k; // move to next neighborhood
         }
+        co_yield bestBag.getBenefit();
+    }
+}
+
+// =====================================================================================
+// Parallel VND: all neighborhoods at once from the same incumbent
+// =====================================================================================
+std::unique_ptr<Bag> VND::runParallel(int bagSize, const Bag* initialBag,
+                                      const std::vector<Package*>& allPackages,
+                                      const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+                                      COMMIT_POLICY policy)
+{
+    if (!initialBag) {
+        return std::make_unique<Bag>(ALGORITHM::ALGORITHM_TYPE::NONE, "0");
     }
 
+    const auto& movements = vndMovements();
+    const int k_max = static_cast<int>(movements.size());
+    const unsigned int numThreads = workerCount(movements.size(), m_maxThreads);
+
+    PERF_COUNTERS::Profile* perfProfile = PERF_COUNTERS::currentProfile();
+    PERF_COUNTERS::ScopedContext perfContext(perfProfile, ALGORITHM::ALGORITHM_TYPE::VND);
+    PERF_COUNTERS::ScopedSample perfSample(SEARCH_ENGINE::MovementType::NONE);
+
+    auto start_time = std::chrono::steady_clock::now();
+    const auto deadline = makeDeadline(start_time);
+
+    // One persistent candidate per neighborhood, kept equal to the incumbent
+    // between rounds through its undo journal.
+    std::vector<std::unique_ptr<Bag>> candidates;
+    std::vector<SearchEngine> engines;
+    candidates.reserve(k_max);
+    engines.reserve(k_max);
+    for (int k = 0; k < k_max; ++k) {
+        candidates.push_back(std::make_unique<Bag>(*initialBag));
+        engines.emplace_back(m_searchEngine.getRandomGenerator()());
+    }
+    std::unique_ptr<std::atomic<bool>[]> cancelTokens(new std::atomic<bool>[k_max]);
+
+    int incumbentBenefit = initialBag->getBenefit();
+    int bestK = -1;
+    int rounds = 0;
+    int cancelled = 0;
+
+    // Live progress for observers; after a commit or rollback every candidate mirrors the incumbent.
+    long long movesReported = 0;
+    auto reportProgress = [&](PROGRESS::EventKind kind, SEARCH_ENGINE::MovementType movement) {
+        long long moves = 0;
+        for (const auto& engine : engines) moves += engine.getMovesApplied();
+        PROGRESS::report(kind, ALGORITHM::ALGORITHM_TYPE::VND, movement,
+                         candidates[0]->getBenefit(), candidates[0]->getSize(), moves - movesReported);
+        movesReported = moves;
+    };
+
+    // Round state shared with the pool; written by this thread only between the barriers.
+    std::atomic<int> nextNeighborhood{0};
+    std::atomic<int> cancelledThisRound{0};
+    bool poolDone = false;
+    std::barrier roundStart(numThreads);
+    std::barrier roundEnd(numThreads);
+
+    auto searchRound = [&]() {
+        for (int k = nextNeighborhood.fetch_add(1); k < k_max; k = nextNeighborhood.fetch_add(1)) {
+            Bag& candidate = *candidates[k];
+            candidate.beginJournal();
+            if (cancelTokens[k].load(std::memory_order_relaxed)) {
+                cancelledThisRound.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            engines[k].localSearch(candidate, bagSize, allPackages, movements[k],
+                                   ALGORITHM::LOCAL_SEARCH::BEST_IMPROVEMENT, dependencyGraph,
+                                   m_maxLS_IterationsWithoutImprovement, m_maxLS_Iterations,
+                                   deadline, &cancelTokens[k]);
+            SOLUTION_REPAIR::repair(candidate, bagSize, dependencyGraph, engines[k].getSeed());
+
+            // A higher-priority improvement makes every lower-priority search a loser.
+            if (policy == COMMIT_POLICY::FIRST_BY_PRIORITY &&
+                !cancelTokens[k].load(std::memory_order_relaxed) &&
+                candidate.getBenefit() > incumbentBenefit) {
+                for (int j = k + 1; j < k_max; ++j)
+                    cancelTokens[j].store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    // Persistent pool: the workers live for the whole run and meet this thread at every round.
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads - 1);
+    for (unsigned int t = 1; t < numThreads; ++t) {
+        workers.emplace_back([&]() {
+            PERF_COUNTERS::ScopedContext workerPerfContext(perfProfile, ALGORITHM::ALGORITHM_TYPE::VND);
+            PERF_COUNTERS::ScopedSample workerPerfSample(SEARCH_ENGINE::MovementType::NONE);
+            while (true) {
+                roundStart.arrive_and_wait();
+                if (poolDone) break;
+                searchRound();
+                roundEnd.arrive_and_wait();
+            }
+        });
+    }
+
+    while (std::chrono::steady_clock::now() < deadline) {
+        ++rounds;
+        for (int k = 0; k < k_max; ++k) cancelTokens[k].store(false, std::memory_order_relaxed);
+        nextNeighborhood.store(0, std::memory_order_relaxed);
+        cancelledThisRound.store(0, std::memory_order_relaxed);
+        // Fresh seeds from the master generator: how far a cancelled search consumed
+        // its engine's generator must not leak into the next round.
+        for (auto& engine : engines) engine.getRandomGenerator().seed(m_searchEngine.getRandomGenerator()());
+
+        roundStart.arrive_and_wait();
+        searchRound();
+        roundEnd.arrive_and_wait();
+        cancelled += cancelledThisRound.load();
+
+        // --- Synchronous commit ---
+        int winner = -1;
+        int winnerBenefit = incumbentBenefit;
+        for (int k = 0; k < k_max; ++k) {
+            if (cancelTokens[k].load(std::memory_order_relaxed)) continue;
+            if (candidates[k]->getBenefit() > winnerBenefit) {
+                winnerBenefit = candidates[k]->getBenefit();
+                winner = k;
+                if (policy == COMMIT_POLICY::FIRST_BY_PRIORITY) break;
+            }
+        }
+
+        if (winner < 0) {
+            for (auto& candidate : candidates) candidate->rollbackJournal();
+            reportProgress(PROGRESS::EventKind::HEARTBEAT, SEARCH_ENGINE::MovementType::NONE);
+            break; // local optimum for every neighborhood
+        }
+
+        const auto winningMoves = candidates[winner]->commitJournal();
+        for (int k = 0; k < k_max; ++k) {
+            if (k == winner) continue;
+            candidates[k]->rollbackJournal();
+            candidates[k]->replayJournal(winningMoves);
+        }
+        incumbentBenefit = winnerBenefit;
+        bestK = winner;
+        reportProgress(PROGRESS::EventKind::INCUMBENT, movements[winner]);
+    }
+
+    poolDone = true;
+    roundStart.arrive_and_wait();
+    for (auto& w : workers) w.join();
+
+    auto bestBag = std::make_unique<Bag>(*initialBag);
+    if (bestK >= 0) {
+        *bestBag = *candidates[bestK];
+        bestBag->setMovementType(movements[bestK]);
+    }
+
+    auto end_time = std::chrono::steady_clock::now();
+    bestBag->setAlgorithmTime(std::chrono::duration<double>(end_time - start_time).count());
+    bestBag->setBagAlgorithm(ALGORITHM::ALGORITHM_TYPE::VND);
+    bestBag->setMetaheuristicParameters(
+        "k_max=" + std::to_string(k_max) +
+        " | Policy: " + (policy == COMMIT_POLICY::BEST_IMPROVEMENT ? "BEST_IMPROVEMENT" : "FIRST_BY_PRIORITY") +
+        " | Threads: " + std::to_string(numThreads) +
+        " | Rounds: " + std::to_string(rounds) +
+        " | Cancelled: " + std::to_string(cancelled)
+    );
+
+    return bestBag;
+}
+
+// =====================================================================================
+// Multi-start VND: independent descents from several initial bags
+// =====================================================================================
+std::unique_ptr<Bag> VND::runMultiStart(int bagSize, const std::vector<const Bag*>& initialBags,
+                                        const std::vector<Package*>& allPackages,
+                                        const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph)
+{
+    std::vector<const Bag*> starts;
+    for (const Bag* bag : initialBags)
+        if (bag) starts.push_back(bag);
+    if (starts.empty()) {
+        return std::make_unique<Bag>(ALGORITHM::ALGORITHM_TYPE::NONE, "0");
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    const auto deadline = makeDeadline(start_time);
+    const unsigned int numThreads = workerCount(starts.size(), m_maxThreads);
+
+    PERF_COUNTERS::Profile* perfProfile = PERF_COUNTERS::currentProfile();
+    PERF_COUNTERS::ScopedContext perfContext(perfProfile, ALGORITHM::ALGORITHM_TYPE::VND);
+
+    std::vector<std::unique_ptr<Bag>> results;
+    std::vector<SearchEngine> engines;
+    results.reserve(starts.size());
+    engines.reserve(starts.size());
+    for (const Bag* start : starts) {
+        results.push_back(std::make_unique<Bag>(*start));
+        engines.emplace_back(m_searchEngine.getRandomGenerator()());
+    }
+
+    std::atomic<size_t> nextStart{0};
+    auto worker = [&]() {
+        PERF_COUNTERS::ScopedContext workerPerfContext(perfProfile, ALGORITHM::ALGORITHM_TYPE::VND);
+        PERF_COUNTERS::ScopedSample workerPerfSample(SEARCH_ENGINE::MovementType::NONE);
+        for (size_t i = nextStart.fetch_add(1); i < starts.size(); i = nextStart.fetch_add(1)) {
+            descend(*results[i], bagSize, allPackages, dependencyGraph, engines[i], deadline);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads - 1);
+    for (unsigned int t = 1; t < numThreads; ++t) workers.emplace_back(worker);
+    worker();
+    for (auto& w : workers) w.join();
+
+    auto best = std::max_element(results.begin(), results.end(),
+                                 [](const std::unique_ptr<Bag>& a, const std::unique_ptr<Bag>& b) {
+                                     return a->getBenefit() < b->getBenefit();
+                                 });
+    std::unique_ptr<Bag> bestBag = std::move(*best);
+
     auto end_time = std::chrono::steady_clock::now();
     bestBag->setAlgorithmTime(std::chrono::duration<double>(end_time - start_time).count());
     bestBag->setBagAlgorithm(ALGORITHM::ALGORITHM_TYPE::VND);
+    bestBag->setMetaheuristicParameters(
+        "k_max=" + std::to_string(vndMovements().size()) +
+        " | Starts: " + std::to_string(starts.size()) +
+        " | Threads: " + std::to_string(numThreads)
+    );
 
     return bestBag;
-}
\ No newline at end of file
+}
@@ -4,9 +4,11 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <chrono>
 
 #include "algorithm.h"
 #include "search_engine.h"
+#include "stepper.h"
 
 // Forward declarations
 class Bag;
@@ -18,6 +20,14 @@ class Dependency;
  */
 class VND {
 public:
+    /**
+     * @brief Which improving neighborhood a parallel VND round commits.
+     */
+    enum class COMMIT_POLICY {
+        BEST_IMPROVEMENT,   ///< Highest benefit among all neighborhoods.
+        FIRST_BY_PRIORITY   ///< First improving neighborhood in the sequential order.
+    };
+
     explicit VND(double maxTime, unsigned int seed);
 
     /**
@@ -35,9 +45,107 @@ public:
         const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph
     );
 
+    /**
+     * @brief Runs VND exploring all neighborhoods concurrently from the current solution.
+     *
+     * Each round starts one local search per neighborhood from the same incumbent
+     * and commits one improving result according to the policy. With
+     * FIRST_BY_PRIORITY, an improvement in a neighborhood cancels every
+     * lower-priority search still running, through its cancel token.
+     * The searches run on a pool kept for the whole call, and every engine is
+     * reseeded from this VND's generator each round, so a seed gives the same
+     * result however the cancellations race.
+     *
+     * @param bagSize Maximum capacity
+     * @param initialBag Initial bag
+     * @param allPackages All available packages
+     * @param dependencyGraph Precomputed dependencies
+     * @param policy Which improving neighborhood gets committed
+     * @return Unique pointer to the best solution
+     */
+    std::unique_ptr<Bag> runParallel(
+        int bagSize,
+        const Bag* initialBag,
+        const std::vector<Package*>& allPackages,
+        const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+        COMMIT_POLICY policy = COMMIT_POLICY::FIRST_BY_PRIORITY
+    );
+
+    /**
+     * @brief Runs independent sequential VNDs from several initial bags in parallel.
+     * @param bagSize Maximum capacity
+     * @param initialBags Starting solutions (null entries are ignored)
+     * @param allPackages All available packages
+     * @param dependencyGraph Precomputed dependencies
+     * @return Unique pointer to the best solution over all starts
+     */
+    std::unique_ptr<Bag> runMultiStart(
+        int bagSize,
+        const std::vector<const Bag*>& initialBags,
+        const std::vector<Package*>& allPackages,
+        const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph
+    );
+
+    /**
+     * @brief Overrides the local search limits used in every neighborhood.
+     * @param maxLS_IterationsWithoutImprovement Local search patience
+     * @param maxLS_Iterations Move evaluations per local search step
+     */
+    void setLocalSearchLimits(int maxLS_IterationsWithoutImprovement, int maxLS_Iterations);
+
+    /**
+     * @brief Caps the worker threads of runParallel and runMultiStart (0 = hardware concurrency).
+     */
+    void setMaxThreads(unsigned int maxThreads);
+
+    /**
+     * @brief Gets the engine of run() and steps(), which keeps its indices between calls.
+     */
+    SearchEngine& getSearchEngine();
+
+    /**
+     * @brief Sequential VND (as run) as a stepper: one local search iteration per step.
+     * @param bag (In/Out) Solution improved in place; holds the best bag between steps
+     * @param bagSize Maximum capacity
+     * @param allPackages All available packages
+     * @param dependencyGraph Precomputed dependencies
+     * @param deadline Time limit
+     * @return Stepper yielding the benefit of bag; its arguments and this VND must outlive it
+     */
+    STEPPER::Stepper steps(
+        Bag& bag,
+        int bagSize,
+        const std::vector<Package*>& allPackages,
+        const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+        std::chrono::steady_clock::time_point deadline
+    );
+
 private:
+    STEPPER::Stepper descendSteps(
+        Bag& bestBag,
+        int bagSize,
+        const std::vector<Package*>& allPackages,
+        const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+        SearchEngine& searchEngine,
+        std::chrono::steady_clock::time_point deadline
+    );
+
+    void descend(
+        Bag& bestBag,
+        int bagSize,
+        const std::vector<Package*>& allPackages,
+        const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+        SearchEngine& searchEngine,
+        const std::chrono::steady_clock::time_point& deadline
+    );
+
+    std::chrono::steady_clock::time_point makeDeadline(const std::chrono::steady_clock::time_point& start) const;
+
     const double m_maxTime;
     SearchEngine m_searchEngine;
+    int m_maxLS_IterationsWithoutImprovement = 200;
+    int m_maxLS_Iterations = 2000;
+    unsigned int m_maxThreads = 0;
 };
 
 #endif // VND_H
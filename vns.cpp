@@ -3,12 +3,29 @@
 #include "package.h"
 #include "dependency.h"
 #include "vns_helper.h"
+#include "solution_repair.h"
+#include "progress_channel.h"
+#include "perf_counters.h"
 #include <chrono>
 #include <algorithm>
+#include <thread>
+#include <limits>
 
 VNS::VNS(double maxTime, unsigned int seed) 
     : m_maxTime(maxTime), m_searchEngine(seed) {}
 
+void VNS::setIterationLimits(int maxIterations, int maxLS_IterationsWithoutImprovement, int maxLS_Iterations)
+{
+    m_maxIterations = maxIterations;
+    m_maxLS_IterationsWithoutImprovement = maxLS_IterationsWithoutImprovement;
+    m_maxLS_Iterations = maxLS_Iterations;
+}
+
+void VNS::setMaxThreads(unsigned int maxThreads)
+{
+    m_maxThreads = maxThreads;
+}
+
 std::unique_ptr<Bag> VNS::run(
     int bagSize,
     const Bag* initialBag,
@@ -24,37 +41,135 @@ std::unique_ptr<Bag> VNS::run(
             std::chrono::duration<double>(m_maxTime)
     );
 
-    auto bestBag = std::make_unique<Bag>(*initialBag);
+    const std::vector<SEARCH_ENGINE::MovementType> movements = {
+        SEARCH_ENGINE::MovementType::ADD,
+        SEARCH_ENGINE::MovementType::SWAP_REMOVE_1_ADD_1,
+        SEARCH_ENGINE::MovementType::SWAP_REMOVE_1_ADD_2,
+        SEARCH_ENGINE::MovementType::SWAP_REMOVE_2_ADD_1,
+        SEARCH_ENGINE::MovementType::EJECTION_CHAIN
+    };
+
+    const int k_max = static_cast<int>(movements.size());
+    const int maxIterations = m_maxIterations;
+    const int maxNoImprovement = 20;
+    const int maxLS_IterationsWithoutImprovement = m_maxLS_IterationsWithoutImprovement;
+    const int maxLS_Iterations = m_maxLS_Iterations;
+
+    unsigned int hw = std::thread::hardware_concurrency();
+    if (hw == 0) hw = 1;
+    if (m_maxThreads > 0) hw = std::min(hw, m_maxThreads);
+    const int numThreads = std::max(1, std::min<int>(k_max, static_cast<int>(hw)));
+
+    PERF_COUNTERS::Profile* perfProfile = PERF_COUNTERS::currentProfile();
+    PERF_COUNTERS::ScopedContext perfContext(perfProfile, ALGORITHM::ALGORITHM_TYPE::VNS);
+    PERF_COUNTERS::ScopedSample perfSample(SEARCH_ENGINE::MovementType::NONE);
+
+    // --- One candidate bag, engine and buffer per shake strength k ---
+    // Every candidate mirrors the incumbent at the start of a round; changes made
+    // while shaking and searching are journaled so they can be undone instead of
+    // copying the whole bag for every k.
+    std::vector<std::unique_ptr<Bag>> candidates;
+    std::vector<SearchEngine> engines;
+    std::vector<std::vector<Package*>> outsideBuffers(k_max);
+    candidates.reserve(k_max);
+    engines.reserve(k_max);
+    for (int k = 0; k < k_max; ++k) {
+        candidates.push_back(std::make_unique<Bag>(*initialBag));
+        engines.emplace_back(m_searchEngine.getRandomGenerator()());
+    }
 
-    const int k_max = 5;
-    const int maxIterations = 200;
-    const int maxNoImprovement = 2000;
+    int incumbentBenefit = initialBag->getBenefit();
+    int bestK = -1;
+    int rounds = 0;
+    int improvements = 0;
+    int roundsWithoutImprovement = 0;
 
-    SearchEngine localEngine(m_searchEngine.getSeed());
+    // Live progress for observers; after a commit or rollback every candidate mirrors the incumbent.
+    long long movesReported = 0;
+    auto reportProgress = [&](PROGRESS::EventKind kind, SEARCH_ENGINE::MovementType movement) {
+        long long moves = 0;
+        for (const auto& engine : engines) moves += engine.getMovesApplied();
+        PROGRESS::report(kind, ALGORITHM::ALGORITHM_TYPE::VNS, movement,
+                         candidates[0]->getBenefit(), candidates[0]->getSize(), moves - movesReported);
+        movesReported = moves;
+    };
+
+    // Shake strength k+1, repair, then descend in neighborhood k.
+    auto exploreNeighborhood = [&](int k) {
+        Bag& candidate = *candidates[k];
+        SearchEngine& engine = engines[k];
+        candidate.beginJournal();
+        VNS_HELPER::shakeInPlace(candidate, k + 1, allPackages, bagSize, dependencyGraph,
+                                 engine.getRandomGenerator(), outsideBuffers[k]);
+        SOLUTION_REPAIR::repair(candidate, bagSize, dependencyGraph, engine.getSeed());
+        engine.localSearch(candidate, bagSize, allPackages, movements[k],
+                           ALGORITHM::LOCAL_SEARCH::BEST_IMPROVEMENT, dependencyGraph,
+                           maxLS_IterationsWithoutImprovement, maxLS_Iterations, deadline);
+        SOLUTION_REPAIR::repair(candidate, bagSize, dependencyGraph, engine.getSeed());
+    };
 
     for (int iter = 0; iter < maxIterations; ++iter) {
-        bool improvementFound = false;
+        if (std::chrono::steady_clock::now() >= deadline) break;
+        ++rounds;
 
-        // Sequential evaluation of neighborhoods
-        for (int k = 1; k <= k_max; ++k) {
-            auto candidate = std::make_unique<Bag>(*bestBag);
-            VNS_HELPER::vnsLoop(*candidate, bagSize, allPackages, dependencyGraph,
-                                localEngine, 1, 1, deadline);
+        // --- Parallel phase: every k is explored from the same incumbent ---
+        std::vector<std::thread> workers;
+        workers.reserve(numThreads - 1);
+        for (int t = 1; t < numThreads; ++t) {
+            workers.emplace_back([&, t]() {
+                PERF_COUNTERS::ScopedContext workerPerfContext(perfProfile, ALGORITHM::ALGORITHM_TYPE::VNS);
+                PERF_COUNTERS::ScopedSample workerPerfSample(SEARCH_ENGINE::MovementType::NONE);
+                for (int k = t; k < k_max; k += numThreads) exploreNeighborhood(k);
+            });
+        }
+        for (int k = 0; k < k_max; k += numThreads) exploreNeighborhood(k);
+        for (auto& w : workers) w.join();
 
-            if (candidate->getBenefit() > bestBag->getBenefit()) {
-                *bestBag = *candidate;
-                improvementFound = true;
+        // --- Synchronous commit: best improvement wins, ties go to the smaller k ---
+        int winner = -1;
+        int winnerBenefit = incumbentBenefit;
+        for (int k = 0; k < k_max; ++k) {
+            if (candidates[k]->getBenefit() > winnerBenefit) {
+                winnerBenefit = candidates[k]->getBenefit();
+                winner = k;
             }
         }
 
-        if (!improvementFound) break;
-        if (std::chrono::steady_clock::now() >= deadline) break;
+        if (winner < 0) {
+            for (auto& candidate : candidates) candidate->rollbackJournal();
+            reportProgress(PROGRESS::EventKind::HEARTBEAT, SEARCH_ENGINE::MovementType::NONE);
+            if (++roundsWithoutImprovement >= maxNoImprovement) break;
+            continue;
+        }
+
+        const auto winningMoves = candidates[winner]->commitJournal();
+        for (int k = 0; k < k_max; ++k) {
+            if (k == winner) continue;
+            candidates[k]->rollbackJournal();
+            candidates[k]->replayJournal(winningMoves);
+        }
+        incumbentBenefit = winnerBenefit;
+        bestK = winner;
+        ++improvements;
+        roundsWithoutImprovement = 0;
+        reportProgress(PROGRESS::EventKind::INCUMBENT, movements[winner]);
+    }
+
+    auto bestBag = std::make_unique<Bag>(*initialBag);
+    if (bestK >= 0) {
+        *bestBag = *candidates[bestK];
+        bestBag->setMovementType(movements[bestK]);
     }
 
     auto end_time = std::chrono::steady_clock::now();
     bestBag->setAlgorithmTime(std::chrono::duration<double>(end_time - start_time).count());
     bestBag->setBagAlgorithm(ALGORITHM::ALGORITHM_TYPE::VNS);
-    bestBag->setMetaheuristicParameters("k_max=" + std::to_string(k_max));
+    bestBag->setMetaheuristicParameters(
+        "k_max=" + std::to_string(k_max) +
+        " | Threads: " + std::to_string(numThreads) +
+        " | Rounds: " + std::to_string(rounds) +
+        " | Improvements: " + std::to_string(improvements)
+    );
 
     return bestBag;
 }
@@ -30,9 +30,26 @@ public:
         const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph
     );
 
+    /**
+     * @brief Overrides the round and local search limits.
+     * @param maxIterations Maximum VNS rounds
+     * @param maxLS_IterationsWithoutImprovement Local search patience
+     * @param maxLS_Iterations Move evaluations per local search step
+     */
+    void setIterationLimits(int maxIterations, int maxLS_IterationsWithoutImprovement, int maxLS_Iterations);
+
+    /**
+     * @brief Caps the threads exploring shake strengths in parallel (0 = hardware concurrency).
+     */
+    void setMaxThreads(unsigned int maxThreads);
+
 private:
     const double m_maxTime;
     SearchEngine m_searchEngine;
+    int m_maxIterations = 200;
+    int m_maxLS_IterationsWithoutImprovement = 10;
+    int m_maxLS_Iterations = 2000;
+    unsigned int m_maxThreads = 0;
 };
 
 #endif // VNS_H
@@ -2,6 +2,7 @@
 #include "solution_repair.h"
 #include "algorithm.h"
 #include "random_provider.h"
+#include "trace.h"
 #include <algorithm>
 
 namespace VNS_HELPER {
@@ -16,7 +17,21 @@ std::unique_ptr<Bag> shake(
     std::vector<Package*>& tmpOutside)
 {
     auto newBag = std::make_unique<Bag>(currentBag);
-    const auto& packagesInBag = newBag->getPackages();
+    shakeInPlace(*newBag, k, allPackages, bagSize, dependencyGraph, generator, tmpOutside);
+    return newBag;
+}
+
+void shakeInPlace(
+    Bag& bag,
+    int k,
+    const std::vector<Package*>& allPackages,
+    int bagSize,
+    const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+    std::mt19937& generator,
+    std::vector<Package*>& tmpOutside)
+{
+    TRACE::ScopedEvent trace("vns", "shake");
+    const auto& packagesInBag = bag.getPackages();
 
     // --- 1. Build list of packages NOT in the bag ---
     tmpOutside.clear();
@@ -39,7 +54,7 @@ std::unique_ptr<Bag> shake(
     // Remove the first 'k' packages from the shuffled list
     for (int i = 0; i < removeCount; ++i) {
         const Package* pkg = packagesToRemove[i];
-        newBag->removePackage(*pkg, dependencyGraph.at(pkg));
+        bag.removePackage(*pkg, dependencyGraph.at(pkg));
     }
 
     // --- 3. Add up to 'k' new packages ---
@@ -54,12 +69,10 @@ std::unique_ptr<Bag> shake(
         
         const auto& deps = dependencyGraph.at(pkg);
         
-        if (newBag->addPackageIfPossible(*pkg, bagSize, deps)) {
+        if (bag.addPackageIfPossible(*pkg, bagSize, deps)) {
             ++added;
         }
     }
-
-    return newBag;
 }
 
 void vnsLoop(Bag& bestBag, int bagSize,
@@ -69,6 +82,18 @@ void vnsLoop(Bag& bestBag, int bagSize,
              int maxLS_IterationsWithoutImprovement,
              int maxLS_Iterations,
              const std::chrono::steady_clock::time_point& deadline)
+{
+    vnsSteps(bestBag, bagSize, allPackages, dependencyGraph, searchEngine,
+             maxLS_IterationsWithoutImprovement, maxLS_Iterations, deadline).finish();
+}
+
+STEPPER::Stepper vnsSteps(Bag& bestBag, int bagSize,
+                          const std::vector<Package*>& allPackages,
+                          const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+                          SearchEngine& searchEngine,
+                          int maxLS_IterationsWithoutImprovement,
+                          int maxLS_Iterations,
+                          std::chrono::steady_clock::time_point deadline)
 {
     const std::vector<SEARCH_ENGINE::MovementType> movements = {
         SEARCH_ENGINE::MovementType::ADD,
@@ -80,29 +105,28 @@ void vnsLoop(Bag& bestBag, int bagSize,
     ALGORITHM::LOCAL_SEARCH searchMethod = ALGORITHM::LOCAL_SEARCH::BEST_IMPROVEMENT;
     const int k_max = static_cast<int>(movements.size());
 
-    std::unique_ptr<Bag> workingBest = std::make_unique<Bag>(bestBag);
     std::vector<Package*> tmpOutside;
 
     int k = 0;
     while (k < k_max && std::chrono::steady_clock::now() < deadline) {
         // Sequential shake + local search
-        auto shakenBag = shake(*workingBest, k + 1, allPackages, bagSize, dependencyGraph, searchEngine.getRandomGenerator(), tmpOutside);
+        auto shakenBag = shake(bestBag, k + 1, allPackages, bagSize, dependencyGraph, searchEngine.getRandomGenerator(), tmpOutside);
         SOLUTION_REPAIR::repair(*shakenBag, bagSize, dependencyGraph, searchEngine.getSeed());
-        searchEngine.localSearch(*shakenBag, bagSize, allPackages, movements[k],
-                                 searchMethod, dependencyGraph,
-                                 maxLS_IterationsWithoutImprovement, maxLS_Iterations, deadline);
+        auto search = searchEngine.localSearchSteps(*shakenBag, bagSize, allPackages, movements[k],
+                                                    searchMethod, dependencyGraph,
+                                                    maxLS_IterationsWithoutImprovement, maxLS_Iterations, deadline);
+        while (search.step()) co_yield bestBag.getBenefit();
         shakenBag->setMovementType(movements[k]);
         SOLUTION_REPAIR::repair(*shakenBag, bagSize, dependencyGraph, searchEngine.getSeed());
 
-        if (shakenBag->getBenefit() > workingBest->getBenefit()) {
-            workingBest = std::move(shakenBag);
+        if (shakenBag->getBenefit() > bestBag.getBenefit()) {
+            bestBag = std::move(*shakenBag);
             k = 0;
         } else {
             ++k;
         }
+        co_yield bestBag.getBenefit();
     }
-
-    bestBag = std::move(*workingBest);
 }
 
 } // namespace VNS_HELPER
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "package.h"
 #include "dependency.h"
 #include "search_engine.h"
+#include "stepper.h"
 
 /**
  * @brief Provides optimized helper functions for VNS-based algorithms.
@@ -39,6 +40,30 @@ namespace VNS_HELPER {
         std::vector<Package*>& tmpOutside
     );
 
+    /**
+     * @brief Shakes a bag in place: removes 'k' random packages and adds up to 'k' new ones.
+     *
+     * Same move as shake(), but applied directly to the given bag so callers can
+     * record it in the bag's undo journal instead of paying for a full copy.
+     *
+     * @param bag Solution to shake (modified).
+     * @param k Neighborhood size.
+     * @param allPackages All available packages.
+     * @param bagSize Maximum bag capacity.
+     * @param dependencyGraph Precomputed package dependency graph.
+     * @param generator A reference to the random number generator to use.
+     * @param tmpOutside Reusable buffer for packages outside the bag.
+     */
+    void shakeInPlace(
+        Bag& bag,
+        int k,
+        const std::vector<Package*>& allPackages,
+        int bagSize,
+        const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+        std::mt19937& generator,
+        std::vector<Package*>& tmpOutside
+    );
+
     /**
      * @brief Runs the VNS iterative loop with optional parallel neighborhood evaluation.
      *
@@ -62,4 +87,22 @@ namespace VNS_HELPER {
         const std::chrono::steady_clock::time_point& deadline
     );
 
+    /**
+     * @brief vnsLoop as a stepper: one local search iteration or shake per step.
+     *
+     * bestBag holds the best bag between steps. The arguments must outlive the stepper.
+     *
+     * @return Stepper yielding the benefit of bestBag.
+     */
+    STEPPER::Stepper vnsSteps(
+        Bag& bestBag,
+        int bagSize,
+        const std::vector<Package*>& allPackages,
+        const std::unordered_map<const Package*, std::vector<const Dependency*>>& dependencyGraph,
+        SearchEngine& searchEngine,
+        int maxLS_IterationsWithoutImprovement,
+        int maxLS_Iterations,
+        std::chrono::steady_clock::time_point deadline
+    );
+
 } // namespace VNS_HELPER